@@ -0,0 +1,597 @@
+#include "ofMain.h"
+#include "dab_flock_simulation.h"
+#include "dab_flock_agent.h"
+#include "dab_flock_swarm.h"
+#include "dab_flock_env.h"
+#include "dab_flock_env_parameter.h"
+#include "dab_flock_parameter.h"
+#include "dab_flock_profiler.h"
+#include "dab_flock_allocation_counter.h"
+#include "dab_flock_behavior_includes.h"
+#include "dab_space_includes.h"
+#include "dab_geom_line.h"
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <iostream>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+using namespace dab;
+using namespace dab::flock;
+
+// headless benchmarks, results are printed as one json object per line
+//
+// usage: example_benchmark [--scenarios boids,grayscott,linefollow] [--sizes 1000,10000,50000] [--steps 100] [--threads 1] [--micro] [--alloc-check] [--warmup 10]
+//
+// scenarios run full Simulation::update() steps without visuals, --micro additionally runs the flush, behavior kernel and agent spawn benchmarks
+// --alloc-check instead runs --warmup steps per scenario and then counts heap allocations over --steps steps, the program exits with 1 if any step allocated
+// the allocation check is only available in the separate audit build of these sources (example_alloccheck), the timings of this build are not affected by the allocation counter
+
+//--------------------------------------------------------------
+Swarm* createFlushSwarm(unsigned int pAgentCount, unsigned int pParameterCount)
+{
+	Swarm* swarm = new Swarm("swarm");
+
+	// agents already possess the "active" parameter
+	for (unsigned int pI = 1; pI < pParameterCount; ++pI)
+	{
+		swarm->addParameter("par" + std::to_string(pI), { 0.0, 0.0, 0.0 });
+	}
+
+	swarm->addAgents(pAgentCount);
+	swarm->randomize("par1", { -1.0, -1.0, -1.0 }, { 1.0, 1.0, 1.0 });
+
+	return swarm;
+}
+
+//--------------------------------------------------------------
+// per element copy as performed by the previous Parameter::flush, once by the swarm and once by the simulation
+void referenceFlush(Swarm* pSwarm)
+{
+	std::vector<Agent*>& agents = pSwarm->agents();
+	unsigned int agentCount = agents.size();
+
+	for (unsigned int pass = 0; pass < 2; ++pass)
+	{
+		for (unsigned int aI = 0; aI < agentCount; ++aI)
+		{
+			Agent* agent = agents[aI];
+			unsigned int parCount = agent->parameterCount();
+
+			for (unsigned int pI = 0; pI < parCount; ++pI)
+			{
+				Parameter* par = agent->parameter(pI);
+				Eigen::VectorXf& values = par->values();
+				Eigen::VectorXf& backupValues = par->backupValues();
+				unsigned int dim = par->dim();
+
+				for (unsigned int d = 0; d < dim; ++d) values[d] = backupValues[d];
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void bulkFlush(Swarm* pSwarm)
+{
+	pSwarm->flush();
+
+	std::vector<Agent*>& agents = pSwarm->agents();
+	unsigned int agentCount = agents.size();
+	for (unsigned int aI = 0; aI < agentCount; ++aI) agents[aI]->flush();
+}
+
+//--------------------------------------------------------------
+void benchmarkFlush(unsigned int pAgentCount, unsigned int pParameterCount, unsigned int pStepCount)
+{
+	std::vector<std::string> modes = { "reference", "bulk" };
+
+	for (unsigned int mI = 0; mI < modes.size(); ++mI)
+	{
+		const std::string& mode = modes[mI];
+
+		Swarm* swarm = createFlushSwarm(pAgentCount, pParameterCount);
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		for (unsigned int sI = 0; sI < pStepCount; ++sI)
+		{
+			if (mode == "reference") referenceFlush(swarm);
+			else bulkFlush(swarm);
+		}
+
+		auto endTime = std::chrono::high_resolution_clock::now();
+		double duration = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+		std::cout << "{\"benchmark\":\"flush\",\"mode\":\"" << mode << "\",\"agents\":" << pAgentCount << ",\"parameters\":" << pParameterCount << ",\"steps\":" << pStepCount << ",\"msPerStep\":" << duration / static_cast<double>(pStepCount) << "}\n";
+
+		Simulation::get().clear();
+	}
+}
+
+//--------------------------------------------------------------
+Swarm* createBehaviorSwarm(unsigned int pAgentCount, const std::string& pBehaviorName)
+{
+	Simulation& simulation = Simulation::get();
+
+	if (simulation.space().checkSpace("agent_position") == false) simulation.space().addSpace(std::shared_ptr<space::Space>(new space::Space("agent_position", new space::KDTreeAlg(3))));
+
+	Swarm* swarm = new Swarm("swarm");
+	swarm->addParameter("position", { 0.0, 0.0, 0.0 });
+	swarm->assignNeighbors("position", "agent_position", true, new space::NeighborGroupAlg(0.5, 8, true));
+	swarm->addParameter("velocity", { 0.0, 0.0, 0.0 });
+	swarm->addParameter("acceleration", { 0.0, 0.0, 0.0 });
+	swarm->addParameter("force", { 0.0, 0.0, 0.0 });
+
+	if (pBehaviorName == "cohesion") swarm->addBehavior("cohesion", CohesionBehavior("position@agent_position", "force"));
+	else if (pBehaviorName == "alignment") swarm->addBehavior("alignment", AlignmentBehavior("position@agent_position:velocity", "force"));
+	else if (pBehaviorName == "evasion") swarm->addBehavior("evasion", EvasionBehavior("position@agent_position", "force"));
+	else if (pBehaviorName == "integration") swarm->addBehavior("integration", EulerIntegration("position velocity acceleration", "position velocity"));
+
+	swarm->addAgents(pAgentCount);
+	swarm->randomize("position", { -5.0, -5.0, -5.0 }, { 5.0, 5.0, 5.0 });
+	swarm->randomize("velocity", { -1.0, -1.0, -1.0 }, { 1.0, 1.0, 1.0 });
+	swarm->randomize("acceleration", { -1.0, -1.0, -1.0 }, { 1.0, 1.0, 1.0 });
+
+	// compute neighbors
+	simulation.update();
+
+	return swarm;
+}
+
+//--------------------------------------------------------------
+// compares fixed dimension kernels with the dynamic kernels, only the act method of the behavior is timed
+void benchmarkBehaviors(unsigned int pAgentCount, unsigned int pStepCount)
+{
+	std::vector<std::string> behaviorNames = { "cohesion", "alignment", "evasion", "integration" };
+	std::vector<std::string> modes = { "dynamic", "fixed" };
+
+	for (unsigned int bI = 0; bI < behaviorNames.size(); ++bI)
+	{
+		for (unsigned int mI = 0; mI < modes.size(); ++mI)
+		{
+			Behavior::sFixedDimKernels = modes[mI] == "fixed";
+
+			Swarm* swarm = createBehaviorSwarm(pAgentCount, behaviorNames[bI]);
+
+			std::vector<Behavior*> behaviors;
+			std::vector<Agent*>& agents = swarm->agents();
+			for (unsigned int aI = 0; aI < agents.size(); ++aI) behaviors.push_back(agents[aI]->behavior(behaviorNames[bI]));
+
+			auto startTime = std::chrono::high_resolution_clock::now();
+
+			for (unsigned int sI = 0; sI < pStepCount; ++sI)
+			{
+				for (unsigned int aI = 0; aI < behaviors.size(); ++aI) behaviors[aI]->act();
+			}
+
+			auto endTime = std::chrono::high_resolution_clock::now();
+			double duration = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+			std::cout << "{\"benchmark\":\"behavior\",\"behavior\":\"" << behaviorNames[bI] << "\",\"mode\":\"" << modes[mI] << "\",\"agents\":" << pAgentCount << ",\"steps\":" << pStepCount << ",\"msPerStep\":" << duration / static_cast<double>(pStepCount) << "}\n";
+
+			Simulation::get().clear();
+		}
+	}
+
+	Behavior::sFixedDimKernels = true;
+}
+
+//--------------------------------------------------------------
+// current resident memory of the process in kilobytes (-1: not available)
+long residentMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == 0) return -1;
+	return static_cast<long>(counters.WorkingSetSize / 1024);
+#elif defined(__APPLE__)
+	mach_task_basic_info_data_t info;
+	mach_msg_type_number_t infoCount = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &infoCount) != KERN_SUCCESS) return -1;
+	return static_cast<long>(info.resident_size / 1024);
+#else
+	std::ifstream statm("/proc/self/statm");
+	long totalPages, residentPages;
+	if (!(statm >> totalPages >> residentPages)) return -1;
+	return residentPages * (sysconf(_SC_PAGESIZE) / 1024);
+#endif
+}
+
+//--------------------------------------------------------------
+// edge length of the cube in which agents are placed, keeps the agent density constant across agent counts
+float scenarioExtent(unsigned int pAgentCount)
+{
+	return 5.0 * std::cbrt(static_cast<float>(pAgentCount) / 1000.0);
+}
+
+//--------------------------------------------------------------
+// boids swarm without agents
+Swarm* createBoidsSwarm(float pExtent)
+{
+	Simulation& simulation = Simulation::get();
+	float extent = pExtent;
+
+	simulation.space().addSpace(std::shared_ptr<space::Space>(new space::Space("agent_position", new space::KDTreeAlg(3))));
+
+	Swarm* swarm = new Swarm("boids");
+	swarm->addParameter("position", { 0.0, 0.0, 0.0 });
+	swarm->assignNeighbors("position", "agent_position", true, new space::NeighborGroupAlg(1.0, 8, true));
+	swarm->addParameter("velocity", { 0.0, 0.0, 0.0 });
+	swarm->addParameter("acceleration", { 0.0, 0.0, 0.0 });
+	swarm->addParameter("force", { 0.0, 0.0, 0.0 });
+	swarm->addParameter("mass", { 0.1f });
+
+	swarm->addBehavior("resetForce", ResetBehavior("", "force"));
+
+	swarm->addBehavior("cohesion", CohesionBehavior("position@agent_position", "force"));
+	swarm->set("cohesion_minDist", { 0.0 });
+	swarm->set("cohesion_maxDist", { 1.0 });
+	swarm->set("cohesion_amount", { 0.05f });
+
+	swarm->addBehavior("alignment", AlignmentBehavior("position@agent_position:velocity", "force"));
+	swarm->set("alignment_minDist", { 0.0 });
+	swarm->set("alignment_maxDist", { 1.0 });
+	swarm->set("alignment_amount", { 0.05f });
+
+	swarm->addBehavior("evasion", EvasionBehavior("position@agent_position", "force"));
+	swarm->set("evasion_maxDist", { 0.2f });
+	swarm->set("evasion_amount", { 0.2f });
+
+	swarm->addBehavior("damping", DampingBehavior("velocity", "force"));
+	swarm->set("damping_prefVelocity", { 0.5 });
+	swarm->set("damping_amount", { 0.1f });
+
+	swarm->addBehavior("acceleration", AccelerationBehavior("mass velocity force", "acceleration"));
+	swarm->set("acceleration_maxAngularAcceleration", { 1.0, 1.0, 1.0 });
+
+	swarm->addBehavior("integration", EulerIntegration("position velocity acceleration", "position velocity"));
+	swarm->set("integration_timestep", { 0.1f });
+
+	swarm->addBehavior("boundaryWrap", BoundaryWrapBehavior("position", "position"));
+	swarm->set("boundaryWrap_lowerBoundary", { -extent, -extent, -extent });
+	swarm->set("boundaryWrap_upperBoundary", { extent, extent, extent });
+
+	return swarm;
+}
+
+//--------------------------------------------------------------
+void createBoidsScenario(unsigned int pAgentCount)
+{
+	float extent = scenarioExtent(pAgentCount);
+
+	Swarm* swarm = createBoidsSwarm(extent);
+	swarm->addAgents(pAgentCount);
+	swarm->randomize("position", { -extent, -extent, -extent }, { extent, extent, extent });
+	swarm->randomize("velocity", { -0.5, -0.5, -0.5 }, { 0.5, 0.5, 0.5 });
+}
+
+//--------------------------------------------------------------
+// the agent count is used as grid cell count
+void createGrayScottScenario(unsigned int pAgentCount)
+{
+	unsigned int gridSize = static_cast<unsigned int>(std::sqrt(static_cast<float>(pAgentCount)) + 0.5);
+
+	Env* env = new Env("grayscott", 2);
+	env->addParameter("chem1", 1, dab::Array<unsigned int>{ gridSize, gridSize }, Eigen::Vector2f(0.0, 0.0), Eigen::Vector2f(1.0, 1.0));
+	env->addParameter("chem2", 1, dab::Array<unsigned int>{ gridSize, gridSize }, Eigen::Vector2f(0.0, 0.0), Eigen::Vector2f(1.0, 1.0));
+
+	env->addBehavior("diffusion1", EnvDiffusionBehavior("chem1", "chem1"));
+	env->set("diffusion1_diffusion", 0.2);
+	env->addBehavior("diffusion2", EnvDiffusionBehavior("chem2", "chem2"));
+	env->set("diffusion2_diffusion", 0.1);
+	env->addBehavior("grayScott", EnvGrayScottBehavior("chem1 chem2", "chem1 chem2"));
+	env->set("grayScott_F", 0.037);
+	env->set("grayScott_k", 0.06);
+
+	// chem1 everywhere, chem2 seeded in a central square
+	std::vector<space::SpaceGrid*> chem1Grids = { dynamic_cast<EnvParameter*>(env->parameter("chem1"))->grid(), dynamic_cast<EnvParameter*>(env->parameter("chem1"))->backupGrid() };
+	std::vector<space::SpaceGrid*> chem2Grids = { dynamic_cast<EnvParameter*>(env->parameter("chem2"))->grid(), dynamic_cast<EnvParameter*>(env->parameter("chem2"))->backupGrid() };
+
+	for (unsigned int gI = 0; gI < 2; ++gI)
+	{
+		std::vector<Eigen::VectorXf>& chem1Vectors = chem1Grids[gI]->vectorField().vectors();
+		std::vector<Eigen::VectorXf>& chem2Vectors = chem2Grids[gI]->vectorField().vectors();
+
+		for (unsigned int vI = 0; vI < chem1Vectors.size(); ++vI)
+		{
+			unsigned int x = vI % gridSize;
+			unsigned int y = vI / gridSize;
+			bool seed = x > gridSize * 2 / 5 && x < gridSize * 3 / 5 && y > gridSize * 2 / 5 && y < gridSize * 3 / 5;
+
+			chem1Vectors[vI].setConstant(seed ? 0.5 : 1.0);
+			chem2Vectors[vI].setConstant(seed ? 0.25 : 0.0);
+		}
+	}
+}
+
+//--------------------------------------------------------------
+void createLineFollowScenario(unsigned int pAgentCount)
+{
+	Simulation& simulation = Simulation::get();
+	float extent = scenarioExtent(pAgentCount);
+
+	space::RTreeAlg* shapeSpaceAlg = new space::RTreeAlg(Eigen::Vector3f(-extent, -extent, -extent), Eigen::Vector3f(extent, extent, extent));
+	simulation.space().addSpace(std::shared_ptr<space::Space>(new space::Space("shapespace", shapeSpaceAlg)));
+
+	std::shared_ptr<geom::GeometryGroup> lineGeomGroup(new geom::GeometryGroup());
+	lineGeomGroup->addGeometry(new geom::Line(glm::vec3(-1.0, -1.0, 0.0), glm::vec3(1.0, -1.0, 0.0)));
+	lineGeomGroup->addGeometry(new geom::Line(glm::vec3(1.0, -1.0, 0.0), glm::vec3(0.0, 1.0, 0.0)));
+	lineGeomGroup->addGeometry(new geom::Line(glm::vec3(0.0, 1.0, 0.0), glm::vec3(-1.0, -1.0, 0.0)));
+	simulation.space().addObject("shapespace", new space::SpaceShape(lineGeomGroup), true);
+
+	Swarm* swarm = new Swarm("linefollow");
+	swarm->addParameter("position", { 0.0, 0.0, 0.0 });
+	swarm->assignNeighbors("position", "shapespace", false, new space::NeighborGroupAlg(2.0 * extent, 1, true));
+	swarm->addParameter("velocity", { 0.0, 0.0, 0.0 });
+	swarm->addParameter("acceleration", { 0.0, 0.0, 0.0 });
+	swarm->addParameter("force", { 0.0, 0.0, 0.0 });
+	swarm->addParameter("mass", { 0.1f });
+
+	swarm->addBehavior("resetForce", ResetBehavior("", "force"));
+
+	swarm->addBehavior("lineFollow", LineFollowBehavior("position@shapespace", "force"));
+	swarm->set("lineFollow_minDist", 0.0);
+	swarm->set("lineFollow_maxDist", 2.0 * extent);
+	swarm->set("lineFollow_contourMaintainDist", 5.0);
+	swarm->set("lineFollow_tanAmount", 0.02);
+	swarm->set("lineFollow_ortAmount", 2.0);
+	swarm->set("lineFollow_amount", 1.0);
+
+	swarm->addBehavior("damping", DampingBehavior("velocity", "force"));
+	swarm->set("damping_prefVelocity", { 0.5 });
+	swarm->set("damping_amount", { 0.1f });
+
+	swarm->addBehavior("acceleration", AccelerationBehavior("mass velocity force", "acceleration"));
+	swarm->set("acceleration_maxAngularAcceleration", { 1.0, 1.0, 1.0 });
+
+	swarm->addBehavior("integration", EulerIntegration("position velocity acceleration", "position velocity"));
+	swarm->set("integration_timestep", { 0.1f });
+
+	swarm->addAgents(pAgentCount);
+	swarm->randomize("position", { -extent, -extent, -extent }, { extent, extent, extent });
+}
+
+//--------------------------------------------------------------
+// times adding agents to a boids swarm, either one by one (each agent is copied from the swarm) or as a single batch (agents are cloned from the first one)
+void benchmarkSpawn(unsigned int pAgentCount)
+{
+	std::vector<std::string> modes = { "single", "batch" };
+
+	for (unsigned int mI = 0; mI < modes.size(); ++mI)
+	{
+		const std::string& mode = modes[mI];
+
+		Swarm* swarm = createBoidsSwarm(scenarioExtent(pAgentCount));
+
+		auto startTime = std::chrono::high_resolution_clock::now();
+
+		if (mode == "single")
+		{
+			for (unsigned int aI = 0; aI < pAgentCount; ++aI) swarm->addAgent();
+		}
+		else swarm->addAgents(pAgentCount);
+
+		auto endTime = std::chrono::high_resolution_clock::now();
+		double duration = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+		std::cout << "{\"benchmark\":\"spawn\",\"mode\":\"" << mode << "\",\"agents\":" << pAgentCount << ",\"ms\":" << duration << ",\"usPerAgent\":" << 1000.0 * duration / static_cast<double>(pAgentCount) << "}\n";
+
+		Simulation::get().clear();
+	}
+}
+
+//--------------------------------------------------------------
+std::string jsonTimes(const std::map<std::string, double>& pTimes, double pScale)
+{
+	std::stringstream ss;
+
+	ss << "{";
+	for (auto iter = pTimes.begin(); iter != pTimes.end(); ++iter)
+	{
+		if (iter != pTimes.begin()) ss << ",";
+		ss << "\"" << iter->first << "\":" << iter->second * pScale;
+	}
+	ss << "}";
+
+	return ss.str();
+}
+
+//--------------------------------------------------------------
+void createScenario(const std::string& pScenarioName, unsigned int pAgentCount)
+{
+	if (pScenarioName == "boids") createBoidsScenario(pAgentCount);
+	else if (pScenarioName == "grayscott") createGrayScottScenario(pAgentCount);
+	else if (pScenarioName == "linefollow") createLineFollowScenario(pAgentCount);
+	else throw Exception("FLOCK ERROR: unknown scenario " + pScenarioName, __FILE__, __FUNCTION__, __LINE__);
+}
+
+//--------------------------------------------------------------
+// runs full simulation steps, phase and behavior times are taken from the profiler and reported in ms per step
+// memory is reported as growth of the resident set over setup and steps, it includes memory that previous scenarios freed but the allocator kept
+void benchmarkScenario(const std::string& pScenarioName, unsigned int pAgentCount, unsigned int pStepCount, unsigned int pThreadCount)
+{
+	Simulation& simulation = Simulation::get();
+	FlockProfiler& profiler = FlockProfiler::get();
+
+	simulation.setThreadCount(pThreadCount);
+
+	long startMemory = residentMemory();
+
+	auto setupStartTime = std::chrono::high_resolution_clock::now();
+
+	createScenario(pScenarioName, pAgentCount);
+
+	// warm up, the first step builds neighbor structures and agent groups
+	simulation.update();
+
+	auto setupEndTime = std::chrono::high_resolution_clock::now();
+	double setupDuration = std::chrono::duration<double, std::milli>(setupEndTime - setupStartTime).count();
+
+	profiler.reset();
+	profiler.setEnabled(true);
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	for (unsigned int sI = 0; sI < pStepCount; ++sI) simulation.update();
+
+	auto endTime = std::chrono::high_resolution_clock::now();
+	double duration = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+
+	profiler.setEnabled(false);
+
+	long endMemory = residentMemory();
+
+	double stepScale = 1.0 / static_cast<double>(pStepCount);
+
+	std::map<std::string, double> phaseTimes;
+	for (unsigned int pI = 0; pI < FlockProfiler::PhaseCount; ++pI)
+	{
+		FlockProfiler::Phase phase = static_cast<FlockProfiler::Phase>(pI);
+		phaseTimes[FlockProfiler::phaseName(phase)] = profiler.phaseTime(phase);
+	}
+
+	std::cout << "{\"benchmark\":\"scenario\",\"scenario\":\"" << pScenarioName << "\",\"agents\":" << pAgentCount << ",\"threads\":" << pThreadCount << ",\"steps\":" << pStepCount;
+	std::cout << ",\"setupMs\":" << setupDuration << ",\"msPerStep\":" << duration * stepScale << ",\"stepsPerSec\":" << 1000.0 * static_cast<double>(pStepCount) / duration;
+	std::cout << ",\"phaseMsPerStep\":" << jsonTimes(phaseTimes, stepScale) << ",\"behaviorClassMsPerStep\":" << jsonTimes(profiler.behaviorClassTimes(), stepScale);
+	std::cout << ",\"rssGrowthKB\":" << (startMemory >= 0 && endMemory >= 0 ? endMemory - startMemory : -1) << "}\n";
+
+	simulation.clear();
+}
+
+//--------------------------------------------------------------
+// runs warm up steps, then counts the heap allocations of all threads over the checked steps
+unsigned long checkScenarioAllocations(const std::string& pScenarioName, unsigned int pAgentCount, unsigned int pWarmUpStepCount, unsigned int pStepCount, unsigned int pThreadCount)
+{
+	if (AllocationCounter::available() == false) throw Exception("FLOCK ERROR: allocation check requires an application compiled with DAB_FLOCK_ALLOCATION_AUDIT (see example_alloccheck)", __FILE__, __FUNCTION__, __LINE__);
+	if (AllocationCounter::eigenCheckAvailable() == false) throw Exception("FLOCK ERROR: allocation check requires an application compiled with EIGEN_RUNTIME_NO_MALLOC and without NDEBUG (see example_alloccheck)", __FILE__, __FUNCTION__, __LINE__);
+
+	Simulation& simulation = Simulation::get();
+
+	simulation.setThreadCount(pThreadCount);
+
+	createScenario(pScenarioName, pAgentCount);
+
+	for (unsigned int sI = 0; sI < pWarmUpStepCount; ++sI) simulation.update();
+
+	unsigned long startAllocationCount = AllocationCounter::count();
+
+	// eigen allocates through malloc which is not counted, an eigen allocation during the checked steps fails an eigen assertion instead
+	AllocationCounter::setEigenAllocationAllowed(false);
+
+	for (unsigned int sI = 0; sI < pStepCount; ++sI) simulation.update();
+
+	AllocationCounter::setEigenAllocationAllowed(true);
+
+	unsigned long allocationCount = AllocationCounter::count() - startAllocationCount;
+
+	std::cout << "{\"benchmark\":\"alloccheck\",\"scenario\":\"" << pScenarioName << "\",\"agents\":" << pAgentCount << ",\"threads\":" << pThreadCount << ",\"warmupSteps\":" << pWarmUpStepCount << ",\"steps\":" << pStepCount;
+	std::cout << ",\"allocations\":" << allocationCount << "}\n";
+
+	simulation.clear();
+
+	return allocationCount;
+}
+
+//--------------------------------------------------------------
+std::vector<std::string> splitArgument(const std::string& pArgument)
+{
+	std::vector<std::string> values;
+	std::stringstream ss(pArgument);
+	std::string value;
+
+	while (std::getline(ss, value, ',')) if (value.empty() == false) values.push_back(value);
+
+	return values;
+}
+
+//========================================================================
+int main(int argc, char* argv[])
+{
+	std::vector<std::string> scenarioNames = { "boids", "grayscott", "linefollow" };
+	std::vector<unsigned int> agentCounts = { 1000, 10000, 50000 };
+	unsigned int stepCount = 100;
+	unsigned int threadCount = 1;
+	bool micro = false;
+	bool allocationCheck = false;
+	unsigned int warmUpStepCount = 10;
+
+	for (int aI = 1; aI < argc; ++aI)
+	{
+		std::string argument = argv[aI];
+		bool hasValue = aI + 1 < argc;
+
+		if (argument == "--scenarios" && hasValue) scenarioNames = splitArgument(argv[++aI]);
+		else if (argument == "--sizes" && hasValue)
+		{
+			agentCounts.clear();
+			std::vector<std::string> sizes = splitArgument(argv[++aI]);
+			for (unsigned int sI = 0; sI < sizes.size(); ++sI) agentCounts.push_back(std::stoul(sizes[sI]));
+		}
+		else if (argument == "--steps" && hasValue) stepCount = std::max<unsigned long>(std::stoul(argv[++aI]), 1);
+		else if (argument == "--threads" && hasValue) threadCount = std::max<unsigned long>(std::stoul(argv[++aI]), 1);
+		else if (argument == "--micro") micro = true;
+		else if (argument == "--alloc-check") allocationCheck = true;
+		else if (argument == "--warmup" && hasValue) warmUpStepCount = std::stoul(argv[++aI]);
+		else
+		{
+			std::cerr << "usage: " << argv[0] << " [--scenarios boids,grayscott,linefollow] [--sizes 1000,10000,50000] [--steps 100] [--threads 1] [--micro] [--alloc-check] [--warmup 10]\n";
+			return 1;
+		}
+	}
+
+	try
+	{
+		if (allocationCheck == true)
+		{
+			unsigned long allocationCount = 0;
+
+			for (unsigned int cI = 0; cI < agentCounts.size(); ++cI)
+			{
+				for (unsigned int sI = 0; sI < scenarioNames.size(); ++sI)
+				{
+					allocationCount += checkScenarioAllocations(scenarioNames[sI], agentCounts[cI], warmUpStepCount, stepCount, threadCount);
+				}
+			}
+
+			if (allocationCount > 0)
+			{
+				std::cerr << "allocation check failed: " << allocationCount << " heap allocations in steady state steps\n";
+				return 1;
+			}
+
+			return 0;
+		}
+
+		for (unsigned int cI = 0; cI < agentCounts.size(); ++cI)
+		{
+			for (unsigned int sI = 0; sI < scenarioNames.size(); ++sI)
+			{
+				benchmarkScenario(scenarioNames[sI], agentCounts[cI], stepCount, threadCount);
+			}
+		}
+
+		if (micro == true)
+		{
+			benchmarkFlush(10000, 20, 100);
+			benchmarkBehaviors(10000, 100);
+			benchmarkSpawn(10000);
+		}
+	}
+	catch (dab::Exception& e)
+	{
+		std::cout << e << "\n";
+		return 1;
+	}
+
+	return 0;
+}
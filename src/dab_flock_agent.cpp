@@ -13,6 +13,8 @@ unsigned int Agent::sInstanceCount = 0;
 
 Agent::Agent()
 : mIndex( sInstanceCount++ )
+, mSwarmIndex( 0 )
+, mPrototypeBehavior( nullptr )
 {
     mName = sClassName + std::to_string(mIndex);"\n";
     
@@ -22,12 +24,17 @@ Agent::Agent()
 Agent::Agent(const std::string& pName)
 : mIndex( sInstanceCount++ )
 , mName(pName)
+, mSwarmIndex( 0 )
+, mPrototypeBehavior( nullptr )
 {
 	addParameter( new Parameter( this, "active", Eigen::Matrix<float, 1, 1>(1.0) ) );
 }
 
 Agent::Agent(const Agent& pAgent)
 : mIndex( sInstanceCount++ )
+, mSwarmSymbol( pAgent.mSwarmSymbol )
+, mSwarmIndex( 0 )
+, mPrototypeBehavior( nullptr )
 {
     mName = sClassName + std::to_string(mIndex);
     
@@ -43,13 +50,16 @@ Agent::Agent(const Agent& pAgent)
 	for(unsigned int i=0; i<behCount; ++i)
 	{
 		const Behavior* _behavior = pAgent.behavior(i);
-		addBehavior( _behavior->create( _behavior->name(), this ) );
+		addBehavior( cloneBehavior( _behavior->name(), *_behavior ) );
 	}
 }
 
 Agent::Agent(const std::string& pName, const Agent& pAgent)
 : mIndex( sInstanceCount++ )
 , mName(pName)
+, mSwarmSymbol( pAgent.mSwarmSymbol )
+, mSwarmIndex( 0 )
+, mPrototypeBehavior( nullptr )
 {
 	// copy parameters
 	unsigned int parCount = pAgent.parameterCount();
@@ -63,7 +73,33 @@ Agent::Agent(const std::string& pName, const Agent& pAgent)
 	for(unsigned int i=0; i<behCount; ++i)
 	{
 		const Behavior* _behavior = pAgent.behavior(i);
-		addBehavior( _behavior->create( _behavior->name(), this ) );
+		addBehavior( cloneBehavior( _behavior->name(), *_behavior ) );
+	}
+}
+
+Agent::Agent(const std::string& pName, const Agent& pAgent, const std::map<std::string, Behavior*>& pSharedBehaviors)
+: mIndex( sInstanceCount++ )
+, mName(pName)
+, mSwarmSymbol( pAgent.mSwarmSymbol.empty() == true ? Symbol( pAgent.name() ) : pAgent.mSwarmSymbol )
+, mSwarmIndex( 0 )
+, mPrototypeBehavior( nullptr )
+{
+	// copy parameters
+	unsigned int parCount = pAgent.parameterCount();
+	for(unsigned int i=0; i<parCount; ++i)
+	{
+		addParameter( new Parameter(this, *(pAgent.parameter(i))) );
+	}
+    
+	// copy or share behaviors
+	unsigned int behCount = pAgent.behaviorCount();
+	for(unsigned int i=0; i<behCount; ++i)
+	{
+		const Behavior* _behavior = pAgent.behavior(i);
+		auto sharedIter = pSharedBehaviors.find( _behavior->name() );
+		
+		if( sharedIter != pSharedBehaviors.end() ) addBehavior( sharedIter->second );
+		else addBehavior( cloneBehavior( _behavior->name(), *_behavior ) );
 	}
 }
 
@@ -76,6 +112,49 @@ Agent::index() const
 	return mIndex;
 }
 
+const Symbol&
+Agent::swarmSymbol() const
+{
+	return mSwarmSymbol;
+}
+
+unsigned int
+Agent::swarmIndex() const
+{
+	return mSwarmIndex;
+}
+
+void
+Agent::setSwarmIndex(unsigned int pSwarmIndex)
+{
+	mSwarmIndex = pSwarmIndex;
+}
+
+const Behavior*
+Agent::prototypeBehavior() const
+{
+	return mPrototypeBehavior;
+}
+
+Behavior*
+Agent::cloneBehavior(const std::string& pBehaviorName, const Behavior& pBehavior) throw (Exception)
+{
+	mPrototypeBehavior = &pBehavior;
+	
+	try
+	{
+		Behavior* behavior = pBehavior.create(pBehaviorName, this);
+		mPrototypeBehavior = nullptr;
+		
+		return behavior;
+	}
+	catch(Exception& e)
+	{
+		mPrototypeBehavior = nullptr;
+		throw;
+	}
+}
+
 const std::string&
 Agent::name() const
 {
@@ -108,6 +187,26 @@ Agent::parameterIndex(const std::string& pParameterName) const throw (Exception)
 	}
 }
 
+bool
+Agent::checkParameter(const Symbol& pSymbol) const
+{
+	return mParameterList.contains(pSymbol);
+}
+
+unsigned int
+Agent::parameterIndex(const Symbol& pSymbol) const throw (Exception)
+{
+	try
+	{
+		return mParameterList.parameterIndex(pSymbol);
+	}
+	catch(Exception& e)
+	{
+        e += Exception("FLOCK ERROR: failed get parameter index for parameter name " + pSymbol.name(), __FILE__, __FUNCTION__, __LINE__ );
+		throw e;
+	}
+}
+
 Parameter*
 Agent::parameter(unsigned int pParameterIndex) throw (Exception)
 {
@@ -164,12 +263,41 @@ Agent::parameter(const std::string& pParameterName) const throw (Exception)
 	}
 }
 
+Parameter*
+Agent::parameter(const Symbol& pSymbol) throw (Exception)
+{
+	try
+	{
+		return mParameterList.parameter(pSymbol);
+	}
+	catch(Exception& e)
+	{
+        e += Exception("FLOCK ERROR: failed to get parameter for parameter name " + pSymbol.name(), __FILE__, __FUNCTION__, __LINE__ );
+		throw e;
+	}
+}
+
+const Parameter*
+Agent::parameter(const Symbol& pSymbol) const throw (Exception)
+{
+	try
+	{
+		return mParameterList.parameter(pSymbol);
+	}
+	catch(Exception& e)
+	{
+        e += Exception("FLOCK ERROR: failed to get parameter for parameter name " + pSymbol.name(), __FILE__, __FUNCTION__, __LINE__ );
+		throw e;
+	}
+}
+
 void
 Agent::addParameter(Parameter* pParameter) throw (Exception)
 {
 	try
 	{
 		mParameterList.addParameter(pParameter);
+		Simulation::get().invalidateStructure();
 	}
 	catch(Exception& e)
 	{
@@ -242,6 +370,7 @@ Agent::removeParameter(const std::string& pParameterName) throw (Exception)
 	try
 	{
 		mParameterList.removeParameter( pParameterName );
+		Simulation::get().invalidateStructure();
 	}
 	catch(Exception& e)
 	{
@@ -503,6 +632,7 @@ Agent::addBehavior(Behavior* pBehavior) throw (Exception)
 	try
 	{
 		mBehaviorList.addBehavior(pBehavior);
+		Simulation::get().invalidateAgentGroups();
 	}
 	catch(Exception& e)
 	{
@@ -511,6 +641,21 @@ Agent::addBehavior(Behavior* pBehavior) throw (Exception)
 	}
 }
 
+void
+Agent::addBehavior(Behavior* pBehavior, unsigned int pBehaviorPosition) throw (Exception)
+{
+	try
+	{
+		mBehaviorList.addBehavior(pBehavior, pBehaviorPosition);
+		Simulation::get().invalidateAgentGroups();
+	}
+	catch(Exception& e)
+	{
+        e += Exception("FLOCK ERROR: failed to add behaviour " + pBehavior->name() + " at position " + std::to_string(pBehaviorPosition), __FILE__, __FUNCTION__, __LINE__);
+		throw e;
+	}
+}
+
 void
 Agent::addBehavior(const std::string& pBehaviorName, const Behavior& pBehavior) throw (Exception)
 {
@@ -518,8 +663,9 @@ Agent::addBehavior(const std::string& pBehaviorName, const Behavior& pBehavior)
 	
 	try
 	{
-		_behavior = pBehavior.create(pBehaviorName, this);
+		_behavior = cloneBehavior(pBehaviorName, pBehavior);
 		mBehaviorList.addBehavior(_behavior);
+		Simulation::get().invalidateAgentGroups();
 	}
 	catch(Exception& e)
 	{
@@ -537,8 +683,9 @@ Agent::addBehavior(const std::string& pBehaviorName, unsigned int pBehaviorPosit
 	
 	try
 	{
-		_behavior = pBehavior.create(pBehaviorName, this);
+		_behavior = cloneBehavior(pBehaviorName, pBehavior);
 		mBehaviorList.addBehavior(_behavior, pBehaviorPosition);
+		Simulation::get().invalidateAgentGroups();
 	}
 	catch(Exception& e)
 	{
@@ -557,8 +704,9 @@ Agent::addBehavior(const std::string& pBehaviorName, const std::string& pSuccess
 	try
 	{
 		int pSuccessorBehaviorPosition = mBehaviorList.behaviorIndex(pSuccessorBehaviorName);
-		_behavior = pBehavior.create(pBehaviorName, this);
+		_behavior = cloneBehavior(pBehaviorName, pBehavior);
 		mBehaviorList.addBehavior(_behavior, pSuccessorBehaviorPosition);
+		Simulation::get().invalidateAgentGroups();
 	}
 	catch (Exception& e)
 	{
@@ -611,6 +759,7 @@ Agent::removeBehavior(const std::string& pBehaviorName) throw (Exception)
 	try
 	{
 		mBehaviorList.removeBehavior(pBehaviorName);
+		Simulation::get().invalidateAgentGroups();
 	}
 	catch(Exception& e)
 	{
@@ -619,14 +768,20 @@ Agent::removeBehavior(const std::string& pBehaviorName) throw (Exception)
 	}
 }
 
+bool
+Agent::active() const
+{
+	return mParameterList.parameter(0)->values()[0] != 0.0;
+}
+
 void
 Agent::act()
 {
 	//std::cout << "agent " << mName.toStdString() << " act\n";
 	
-	if( mParameterList.parameter(0)->value() == 0.0 ) return; // check if agent is active
+	if( active() == false ) return;
     
-	mBehaviorList.act();
+	mBehaviorList.act( this );
 }
 
 void
@@ -10,6 +10,7 @@
 #ifndef _dab_flock_agent_h_
 #define _dab_flock_agent_h_
 
+#include <map>
 #include <Eigen/Dense>
 #include "dab_exception.h"
 #include "dab_flock_parameter_list.h"
@@ -60,6 +61,14 @@ public:
      */
     Agent(const std::string& pName, const Agent& pAgent);
     
+    /**
+     \brief copy constructor
+     \param pName name of agent
+     \param pAgent swarm or prototype agent of a swarm to copy properties and behaviors from
+     \param pSharedBehaviors shared behaviors that are added instead of copies of the agent's behaviors with the same name
+     */
+    Agent(const std::string& pName, const Agent& pAgent, const std::map<std::string, Behavior*>& pSharedBehaviors);
+    
     /**
      \brief destructor
      */
@@ -71,6 +80,34 @@ public:
      */
     unsigned int index() const;
     
+    /**
+     \brief return name symbol of the swarm the agent belongs to
+     \return swarm name symbol (empty if the agent is a swarm itself or doesn't belong to a swarm)
+     */
+    const Symbol& swarmSymbol() const;
+    
+    /**
+     \brief return agent index within its swarm
+     \return agent index within swarm
+     */
+    unsigned int swarmIndex() const;
+    
+    /**
+     \brief set agent index within its swarm
+     \param pSwarmIndex agent index within swarm
+     
+     called by the swarm whenever it adds or removes agents
+     */
+    void setSwarmIndex(unsigned int pSwarmIndex);
+    
+    /**
+     \brief return behavior that is currently being cloned into this agent
+     \return prototype behavior (nullptr: no behavior is being cloned)
+     
+     behaviors that are created from a prototype reuse its resolved parameter layout
+     */
+    const Behavior* prototypeBehavior() const;
+    
     /**
      \brief return agent name
      \returns agent name
@@ -98,6 +135,21 @@ public:
      */
     unsigned int parameterIndex(const std::string& pParameterName) const  throw (Exception);
     
+    /**
+     \brief check if agent has parameter
+     \param pSymbol parameter name symbol
+     \return true if agent possesses a particular parameter
+     */
+    bool checkParameter(const Symbol& pSymbol) const;
+    
+    /**
+     \brief return parameter index
+     \param pSymbol parameter name symbol
+     \return parameter index
+     \exception Exception parameter does not exist
+     */
+    unsigned int parameterIndex(const Symbol& pSymbol) const throw (Exception);
+    
     /**
      \brief get parameter
      \param pParameterIndex parameter index
@@ -130,6 +182,22 @@ public:
      */
     const Parameter* parameter(const std::string& pParameterName) const throw (Exception);
     
+    /**
+     \brief get parameter
+     \param pSymbol parameter name symbol
+     \return parameter
+     \exception Exception parameter does not exist
+     */
+    Parameter* parameter(const Symbol& pSymbol) throw (Exception);
+    
+    /**
+     \brief get parameter
+     \param pSymbol parameter name symbol
+     \return parameter
+     \exception Exception parameter does not exist
+     */
+    const Parameter* parameter(const Symbol& pSymbol) const throw (Exception);
+    
     /**
      \brief add parameter
      \param pParameter parameter
@@ -339,6 +407,14 @@ public:
      */	
     virtual void addBehavior(Behavior* pBehavior) throw (Exception);
     
+    /**
+     \brief add behavior
+     \param pBehavior behavior
+     \param pBehaviorPosition behavior position
+     \exception Exception behavior already exists
+     */
+    virtual void addBehavior(Behavior* pBehavior, unsigned int pBehaviorPosition) throw (Exception);
+    
     /**
      \brief add behavior
      \param pBehaviorName behavior name
@@ -388,6 +464,14 @@ public:
      */		
     virtual void removeBehavior(const std::string& pBehaviorName) throw (Exception);
     
+    /**
+     \brief check whether agent is active
+     \return true if agent is active
+     
+     inactive agents don't perform their behaviors
+     */
+    bool active() const;
+    
     /**
      \brief perform behaviors
      */
@@ -420,8 +504,20 @@ public:
     };
     
 protected:
+    /**
+     \brief create behavior from prototype behavior
+     \param pBehaviorName behavior name
+     \param pBehavior prototype behavior
+     \return new behavior
+     \exception Exception failed to create behavior
+     */
+    Behavior* cloneBehavior(const std::string& pBehaviorName, const Behavior& pBehavior) throw (Exception);
+    
     std::string mName; /// \brief agent name
     unsigned int mIndex; /// \brief agent index
+    Symbol mSwarmSymbol; /// \brief name symbol of the swarm the agent belongs to
+    unsigned int mSwarmIndex; /// \brief agent index within its swarm
+    const Behavior* mPrototypeBehavior; /// \brief behavior that is currently being cloned (nullptr: none)
     ParameterList mParameterList; /// \brief list of parameters
     BehaviorList mBehaviorList;	/// \brief list of behaviors
 };
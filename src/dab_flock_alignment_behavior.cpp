@@ -11,6 +11,7 @@ using namespace dab::flock;
 
 AlignmentBehavior::AlignmentBehavior(const std::string& pInputParameterString, const std::string& pOutputParameterString)
 : Behavior(pInputParameterString, pOutputParameterString)
+, mKernelDim(0)
 {
 	mClassName = "AlignmentBehavior";
 }
@@ -53,6 +54,7 @@ AlignmentBehavior::AlignmentBehavior(Agent* pAgent, const std::string& pBehavior
 	unsigned int dim = mForcePar->dim();
 	mAvgVelocity.resize(dim, 1);
 	mTmpForce.resize(dim, 1);
+	mKernelDim = ( sFixedDimKernels == true && dim <= 3 && mPositionPar->dim() == dim && mVelocityPar->dim() == dim ) ? dim : 0;
 }
 
 AlignmentBehavior::~AlignmentBehavior()
@@ -93,6 +95,118 @@ AlignmentBehavior::act()
 	//std::cout << "AlignmentBehavior begin: out values" << mOutputParameters[0]->values() << " bValues " << mOutputParameters[0]->backupValues() << "\n";
 	if(mActivePar->value() <= 0.0) return;
 	
+	switch(mKernelDim)
+	{
+		case 1: actFixed<1>(); break;
+		case 2: actFixed<2>(); break;
+		case 3: actFixed<3>(); break;
+		default: actDynamic();
+	}
+}
+
+bool
+AlignmentBehavior::shareable() const
+{
+	return true;
+}
+
+void
+AlignmentBehavior::createBindings()
+{
+	Behavior::createBindings();
+	
+	bindParameter( mPositionPar );
+	bindParameter( mVelocityPar );
+	bindParameter( mForcePar );
+	bindParameter( mMinDistPar );
+	bindParameter( mMaxDistPar );
+	bindParameter( mAmountPar );
+	bindNeighborGroup( mPositionNeighbors, mInputParameters[ mInputNeighborParameterIndices[0] ], mInputNeighborSpaceNames[0] );
+}
+
+void
+AlignmentBehavior::actAll(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount)
+{
+	switch(mKernelDim)
+	{
+		case 1: actAllFixed<1>(pAgents, pBehaviors, pAgentCount); break;
+		case 2: actAllFixed<2>(pAgents, pBehaviors, pAgentCount); break;
+		case 3: actAllFixed<3>(pAgents, pBehaviors, pAgentCount); break;
+		default: Behavior::actAll(pAgents, pBehaviors, pAgentCount);
+	}
+}
+
+template<int Dim>
+void
+AlignmentBehavior::actAllFixed(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount)
+{
+	// a shared behavior acts with the worker of the calling thread, rebound to each agent
+	AlignmentBehavior* behavior = mShared == true ? static_cast<AlignmentBehavior*>( worker() ) : nullptr;
+	
+	for(unsigned int aI=0; aI<pAgentCount; ++aI)
+	{
+		if( mShared == true ) behavior->bind( pAgents[aI] );
+		else behavior = static_cast<AlignmentBehavior*>( pBehaviors[aI] );
+		
+		if( behavior->mActivePar->value() <= 0.0 ) continue;
+		
+		if( behavior->mKernelDim == Dim ) behavior->actFixed<Dim>();
+		else behavior->act();
+	}
+}
+
+template<int Dim>
+void
+AlignmentBehavior::actFixed()
+{
+	typedef Eigen::Matrix<float, Dim, 1> Vector;
+	
+	space::NeighborGroup& positionNeighbors = *mPositionNeighbors;
+	Eigen::Map<const Vector> velocity( mVelocityPar->values().data() );
+	const std::string& velocityName = mVelocityPar->name();
+	Eigen::Map<Vector> force( mForcePar->backupValues().data() );
+	float minDist = mMinDistPar->value();
+	float maxDist = mMaxDistPar->value();
+	float amount = mAmountPar->value();
+	
+	// neighbors of the same swarm share the parameter layout of the agent, their velocity is therefore accessed by index
+	unsigned int velocityIndex = mAgent->parameterIndex( velocityName );
+	
+	unsigned int totalNeighborCount = positionNeighbors.neighborCount();
+	unsigned int neighborCount = 0;
+	
+	float distance;
+	Agent* neighborAgent;
+	Parameter* neighborVelocityPar;
+	
+	Vector avgVelocity = Vector::Zero();
+	
+	for(unsigned int i=0; i<totalNeighborCount; ++i)
+	{
+		distance = positionNeighbors.distance(i);
+		
+		if(minDist > 0.0 && distance < minDist) continue;
+		if(maxDist > 0.0 && distance > maxDist) continue;
+		
+		neighborAgent = static_cast<Parameter*>(positionNeighbors.neighbor(i))->agent();
+		neighborVelocityPar = velocityIndex < neighborAgent->parameterCount() ? neighborAgent->parameter( velocityIndex ) : nullptr;
+		if( neighborVelocityPar == nullptr || neighborVelocityPar->name() != velocityName ) neighborVelocityPar = neighborAgent->parameter( velocityName ); // neighbor of another swarm
+		if( neighborVelocityPar->dim() != Dim ) continue;
+		
+		avgVelocity += Eigen::Map<const Vector>( neighborVelocityPar->values().data() );
+		neighborCount++;
+	}
+	
+	if(neighborCount == 0) return;
+	
+	avgVelocity /= static_cast<float>(neighborCount);
+	
+	force += ( avgVelocity - velocity ) * amount;
+}
+
+void
+AlignmentBehavior::actDynamic()
+{
 	Eigen::VectorXf& position = mPositionPar->values();
 	space::NeighborGroup& positionNeighbors = *mPositionNeighbors;
 	Eigen::VectorXf& velocity = mVelocityPar->values();
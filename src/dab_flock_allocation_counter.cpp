@@ -0,0 +1,239 @@
+/** \file dab_flock_allocation_counter.cpp
+ */
+
+#include "dab_flock_allocation_counter.h"
+#include <cstdlib>
+#include <algorithm>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+#include <Eigen/Core>
+#endif
+
+using namespace dab;
+using namespace dab::flock;
+
+std::atomic<unsigned long> AllocationCounter::sCount(0);
+thread_local unsigned long AllocationCounter::sThreadCount = 0;
+
+bool
+AllocationCounter::available()
+{
+#ifdef DAB_FLOCK_ALLOCATION_AUDIT
+	return true;
+#else
+	return false;
+#endif
+}
+
+unsigned long
+AllocationCounter::count()
+{
+	return sCount.load( std::memory_order_relaxed );
+}
+
+unsigned long
+AllocationCounter::threadCount()
+{
+	return sThreadCount;
+}
+
+void
+AllocationCounter::record()
+{
+	sCount.fetch_add( 1, std::memory_order_relaxed );
+	sThreadCount++;
+}
+
+bool
+AllocationCounter::eigenCheckAvailable()
+{
+#if defined(EIGEN_RUNTIME_NO_MALLOC) && !defined(EIGEN_NO_DEBUG)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void
+AllocationCounter::setEigenAllocationAllowed(bool pAllowed)
+{
+#ifdef EIGEN_RUNTIME_NO_MALLOC
+	Eigen::internal::set_is_malloc_allowed( pAllowed );
+#endif
+}
+
+#ifdef DAB_FLOCK_ALLOCATION_AUDIT
+
+#pragma mark operator new replacements
+
+void*
+operator new(std::size_t pSize)
+{
+	AllocationCounter::record();
+
+	void* memory = std::malloc( pSize > 0 ? pSize : 1 );
+	if( memory == nullptr ) throw std::bad_alloc();
+
+	return memory;
+}
+
+void*
+operator new[](std::size_t pSize)
+{
+	return operator new( pSize );
+}
+
+void*
+operator new(std::size_t pSize, const std::nothrow_t&) noexcept
+{
+	AllocationCounter::record();
+
+	return std::malloc( pSize > 0 ? pSize : 1 );
+}
+
+void*
+operator new[](std::size_t pSize, const std::nothrow_t& pNothrow) noexcept
+{
+	return operator new( pSize, pNothrow );
+}
+
+void
+operator delete(void* pMemory) noexcept
+{
+	std::free( pMemory );
+}
+
+void
+operator delete[](void* pMemory) noexcept
+{
+	std::free( pMemory );
+}
+
+void
+operator delete(void* pMemory, const std::nothrow_t&) noexcept
+{
+	std::free( pMemory );
+}
+
+void
+operator delete[](void* pMemory, const std::nothrow_t&) noexcept
+{
+	std::free( pMemory );
+}
+
+#ifdef __cpp_sized_deallocation
+
+void
+operator delete(void* pMemory, std::size_t) noexcept
+{
+	std::free( pMemory );
+}
+
+void
+operator delete[](void* pMemory, std::size_t) noexcept
+{
+	std::free( pMemory );
+}
+
+#endif
+
+#ifdef __cpp_aligned_new
+
+static void*
+alignedAllocate(std::size_t pSize, std::align_val_t pAlignment)
+{
+	std::size_t alignment = std::max<std::size_t>( static_cast<std::size_t>( pAlignment ), sizeof( void* ) );
+	if( pSize == 0 ) pSize = 1;
+
+#ifdef _WIN32
+	return _aligned_malloc( pSize, alignment );
+#else
+	void* memory = nullptr;
+	if( posix_memalign( &memory, alignment, pSize ) != 0 ) return nullptr;
+	return memory;
+#endif
+}
+
+static void
+alignedFree(void* pMemory)
+{
+#ifdef _WIN32
+	_aligned_free( pMemory );
+#else
+	std::free( pMemory );
+#endif
+}
+
+void*
+operator new(std::size_t pSize, std::align_val_t pAlignment)
+{
+	AllocationCounter::record();
+
+	void* memory = alignedAllocate( pSize, pAlignment );
+	if( memory == nullptr ) throw std::bad_alloc();
+
+	return memory;
+}
+
+void*
+operator new[](std::size_t pSize, std::align_val_t pAlignment)
+{
+	return operator new( pSize, pAlignment );
+}
+
+void*
+operator new(std::size_t pSize, std::align_val_t pAlignment, const std::nothrow_t&) noexcept
+{
+	AllocationCounter::record();
+
+	return alignedAllocate( pSize, pAlignment );
+}
+
+void*
+operator new[](std::size_t pSize, std::align_val_t pAlignment, const std::nothrow_t& pNothrow) noexcept
+{
+	return operator new( pSize, pAlignment, pNothrow );
+}
+
+void
+operator delete(void* pMemory, std::align_val_t) noexcept
+{
+	alignedFree( pMemory );
+}
+
+void
+operator delete[](void* pMemory, std::align_val_t) noexcept
+{
+	alignedFree( pMemory );
+}
+
+void
+operator delete(void* pMemory, std::size_t, std::align_val_t) noexcept
+{
+	alignedFree( pMemory );
+}
+
+void
+operator delete[](void* pMemory, std::size_t, std::align_val_t) noexcept
+{
+	alignedFree( pMemory );
+}
+
+void
+operator delete(void* pMemory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	alignedFree( pMemory );
+}
+
+void
+operator delete[](void* pMemory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	alignedFree( pMemory );
+}
+
+#endif
+
+#endif
@@ -0,0 +1,71 @@
+/** \file dab_flock_allocation_counter.h
+ *  \class dab::flock::AllocationCounter heap allocation counter
+ *  \brief heap allocation counter
+ *
+ *  Counts heap allocations through replacements of the global operator new, including the aligned overloads of C++17.\n
+ *  The replacements are only compiled if DAB_FLOCK_ALLOCATION_AUDIT is defined, since they affect the whole application. Without it, all counts remain zero.\n
+ *  The FlockProfiler uses the counter to attribute allocations to simulation phases and behaviors.\n
+ *  Eigen allocates the storage of dynamic matrices with malloc, which bypasses operator new. Applications that also define EIGEN_RUNTIME_NO_MALLOC can forbid Eigen allocations, an Eigen allocation then fails an Eigen assertion.\n
+ */
+
+#ifndef _dab_flock_allocation_counter_h_
+#define _dab_flock_allocation_counter_h_
+
+#include <atomic>
+
+namespace dab
+{
+
+namespace flock
+{
+
+class AllocationCounter
+{
+public:
+    /**
+     \brief return whether allocations are counted
+     \return true if the application has been compiled with DAB_FLOCK_ALLOCATION_AUDIT
+     */
+    static bool available();
+
+    /**
+     \brief return number of allocations of all threads
+     \return number of allocations since program start
+     */
+    static unsigned long count();
+
+    /**
+     \brief return number of allocations of calling thread
+     \return number of allocations since thread start
+     */
+    static unsigned long threadCount();
+
+    /**
+     \brief count one allocation (called by the operator new replacements)
+     */
+    static void record();
+
+    /**
+     \brief return whether Eigen allocations can be forbidden
+     \return true if the application has been compiled with EIGEN_RUNTIME_NO_MALLOC and Eigen assertions are enabled (no NDEBUG)
+     */
+    static bool eigenCheckAvailable();
+
+    /**
+     \brief allow or forbid Eigen allocations of all threads
+     \param pAllowed Eigen allocations are allowed
+
+     has no effect unless the application has been compiled with EIGEN_RUNTIME_NO_MALLOC
+     */
+    static void setEigenAllocationAllowed(bool pAllowed);
+
+protected:
+    static std::atomic<unsigned long> sCount; /// \brief number of allocations of all threads
+    static thread_local unsigned long sThreadCount; /// \brief number of allocations of calling thread
+};
+
+};
+
+};
+
+#endif
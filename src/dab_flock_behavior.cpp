@@ -5,13 +5,20 @@
 #include "dab_flock_agent.h"
 #include "dab_flock_swarm.h"
 #include "dab_flock_parameter.h"
+#include "dab_flock_thread_pool.h"
 #include "dab_tokenizer.h"
 
 using namespace dab;
 using namespace dab::flock;
 
+bool Behavior::sFixedDimKernels = true;
+
 Behavior::Behavior()
 : mAgent(nullptr)
+, mProfileTime(0.0)
+, mProfileAllocationCount(0)
+, mProfileSlot(-1)
+, mShared(false)
 {}
 
 Behavior::Behavior(const std::string& pInputParameterString, const std::string& pOutputParameterString)
@@ -19,6 +26,10 @@ Behavior::Behavior(const std::string& pInputParameterString, const std::string&
 , mClassName( "Behavior" )
 , mInputParameterString(pInputParameterString)
 , mOutputParameterString(pOutputParameterString)
+, mProfileTime(0.0)
+, mProfileAllocationCount(0)
+, mProfileSlot(-1)
+, mShared(false)
 {}
 
 Behavior::Behavior(Agent* pAgent, const std::string& pBehaviorName, const std::string& pInputParameterString, const std::string& pOutputParameterString)
@@ -27,6 +38,10 @@ Behavior::Behavior(Agent* pAgent, const std::string& pBehaviorName, const std::s
 , mClassName( "Behavior" )
 , mInputParameterString(pInputParameterString)
 , mOutputParameterString(pOutputParameterString)
+, mProfileTime(0.0)
+, mProfileAllocationCount(0)
+, mProfileSlot(-1)
+, mShared(false)
 {
 	//std::cout << "Behavior name " << pBehaviorName.toStdString() << " agent name " << pAgent->name().toStdString() << "\n";
     
@@ -38,6 +53,10 @@ Behavior::Behavior(Agent* pAgent, const std::string& pBehaviorName, const std::s
 
 Behavior::~Behavior()
 {
+	unsigned int workerCount = mWorkers.size();
+	for(unsigned int wI=0; wI<workerCount; ++wI) delete mWorkers[wI];
+	mWorkers.clear();
+	
 	mInputParameters.clear();
 	mInputNeighborGroups.clear();
 	mOutputParameters.clear();
@@ -50,81 +69,118 @@ Behavior::~Behavior()
 	mInternalParameters.clear();
 }
 
+std::shared_ptr< const Behavior::ParameterLayout >
+Behavior::parameterLayout(const std::string& pParameterString, const std::shared_ptr< const ParameterLayout >& pPrototypeLayout) const
+{
+	if( pPrototypeLayout != nullptr && pPrototypeLayout->mParameterString == pParameterString ) return pPrototypeLayout;
+	
+	Tokenizer& tokenizer = Tokenizer::get();
+	std::vector<std::string> parameterNames;
+	tokenizer.split(pParameterString, parameterNames, ' ');
+	unsigned int parameterCount = parameterNames.size();
+	
+	std::shared_ptr< ParameterLayout > layout( new ParameterLayout() );
+	layout->mParameterString = pParameterString;
+	layout->mSpecs.resize( parameterCount );
+	layout->mParameterIndices.resize( parameterCount, -1 );
+	
+	for(unsigned int i=0; i<parameterCount; ++i)
+	{
+		ParameterSpec& spec = layout->mSpecs[i];
+		
+		if( parameterNames[i].find('@') == std::string::npos ) // parameter_name
+		{
+			spec.mParameterName = parameterNames[i];
+			if( mAgent->checkParameter( spec.mParameterName ) ) layout->mParameterIndices[i] = mAgent->parameterIndex( spec.mParameterName );
+			continue;
+		}
+		
+		// parameter_name @ space_name
+		std::vector<std::string> parSpacePairNames;
+		tokenizer.split(parameterNames[i], parSpacePairNames, '@');
+		
+		spec.mParameterName = parSpacePairNames[0];
+		if( mAgent->checkParameter( spec.mParameterName ) ) layout->mParameterIndices[i] = mAgent->parameterIndex( spec.mParameterName );
+		
+		for(unsigned int j=1; j<parSpacePairNames.size(); ++j)
+		{
+			if( parSpacePairNames[j].find(':') != std::string::npos) // parameter_name @ space_name : neighbor_parameter_name
+			{
+				std::vector<std::string> spaceNeighborParPairNames;
+				tokenizer.split(parSpacePairNames[j], spaceNeighborParPairNames, ':');
+				spec.mSpaceNames.push_back( spaceNeighborParPairNames[0] );
+				spec.mNeighborParameterNames.push_back( spaceNeighborParPairNames[1] );
+			}
+			else
+			{
+				spec.mSpaceNames.push_back( parSpacePairNames[j] );
+				spec.mNeighborParameterNames.push_back( "" );
+			}
+		}
+	}
+	
+	return layout;
+}
+
+Parameter*
+Behavior::layoutParameter(const ParameterLayout& pLayout, unsigned int pSpecIndex) throw (Exception)
+{
+	const std::string& parameterName = pLayout.mSpecs[pSpecIndex].mParameterName;
+	int parameterIndex = pLayout.mParameterIndices[pSpecIndex];
+	
+	// agents cloned from the same prototype store their parameters in the same order
+	if( parameterIndex >= 0 && parameterIndex < static_cast<int>( mAgent->parameterCount() ) )
+	{
+		Parameter* parameter = mAgent->parameter( parameterIndex );
+		if( parameter->name() == parameterName ) return parameter;
+	}
+	
+	return specParameter( parameterName );
+}
+
+Parameter*
+Behavior::specParameter(const std::string& pParameterName) throw (Exception)
+{
+	// check if parameter is an AgentParameter
+	if( mAgent->checkParameter( pParameterName ) ) return mAgent->parameter(pParameterName);
+	
+	// check if parameter is a SwarmParameter
+	Swarm* swarm = static_cast< Swarm* > (mAgent);
+	if( swarm->checkSwarmParameter( pParameterName ) ) return swarm->swarmParameter( pParameterName );
+	
+	throw Exception( "FLOCK ERROR: parameter " + pParameterName + " not found", __FILE__, __FUNCTION__, __LINE__ );
+}
+
 void
 Behavior::createInputParameters() throw (Exception)
 {
 	try
 	{
-        Tokenizer& tokenizer = Tokenizer::get();
-        std::vector<std::string> inputParameterNames;
-        tokenizer.split(mInputParameterString, inputParameterNames, ' ');
-		unsigned int inputParameterCount = inputParameterNames.size();
+		// behaviors that are cloned from a prototype reuse its parsed and resolved parameter string
+		const Behavior* prototype = mAgent->prototypeBehavior();
+		mInputLayout = parameterLayout( mInputParameterString, prototype != nullptr ? prototype->mInputLayout : nullptr );
+		unsigned int inputParameterCount = mInputLayout->mSpecs.size();
+		
+		mInputParameters.reserve( inputParameterCount );
         
 		for(unsigned int i=0; i<inputParameterCount; ++i)
 		{
-			if( inputParameterNames[i].find('@') == std::string::npos ) // parameter_name
-			{
-				std::string parameterName = inputParameterNames[i];
-				Parameter* parameter;
-				
-                // check if parameter is an AgentParameter
-				if( mAgent->checkParameter( parameterName ) ) parameter = mAgent->parameter(parameterName);
-				else // check if parameter is a SwarmParameter
-				{
-					Swarm* swarm = static_cast< Swarm* > (mAgent);
-					if( swarm->checkSwarmParameter( parameterName ) ) parameter = swarm->swarmParameter( parameterName );
-					else throw Exception( "FLOCK ERROR: parameter " + parameterName + " not found", __FILE__, __FUNCTION__, __LINE__ );
-				}
-                
-				mInputParameters.push_back(parameter);
-			}
-			else // parameter_name @ space_name
+			const ParameterSpec& spec = mInputLayout->mSpecs[i];
+			Parameter* parameter = layoutParameter( *mInputLayout, i );
+			
+			mInputParameters.push_back(parameter);
+			
+			unsigned int spaceCount = spec.mSpaceNames.size();
+			for(unsigned int j=0; j<spaceCount; ++j) // neighbors requested
 			{
-				std::string parameterName;
-				std::string spaceName;
-				std::string neighborParName;
-				Parameter* parameter;
-                
-                std::vector<std::string> parSpacePairNames;
-                tokenizer.split(inputParameterNames[i], parSpacePairNames, '@');
-            
-				parameterName = parSpacePairNames[0];
-				
-                // check if parameter is an AgentParameter
-				if( mAgent->checkParameter( parameterName ) ) parameter = mAgent->parameter(parameterName);
-				else // check if parameter is a SwarmParameter
-				{
-					Swarm* swarm = static_cast< Swarm* > (mAgent);
-					if( swarm->checkSwarmParameter( parameterName ) ) parameter = swarm->swarmParameter( parameterName );
-					else throw Exception( "FLOCK ERROR: parameter " + parameterName + " not found", __FILE__, __FUNCTION__, __LINE__ );
-				}
-				
-				mInputParameters.push_back(parameter);
+				const std::string& spaceName = spec.mSpaceNames[j];
 				
-				if(parSpacePairNames.size() > 1) // neighbors requested
-				{
-					for(unsigned int j=1; j<parSpacePairNames.size(); ++j)
-					{
-						if( parSpacePairNames[j].find(':') != std::string::npos) // parameter_name @ space_name : neighbor_parameter_name
-						{
-                            std::vector< std::string > spaceNeighborParPairNames;
-                            tokenizer.split(parSpacePairNames[j], spaceNeighborParPairNames, ':');
-							spaceName = spaceNeighborParPairNames[0];
-							neighborParName = spaceNeighborParPairNames[1];
-						}
-						else
-						{
-							spaceName = parSpacePairNames[j];
-							neighborParName = "";
-						}
-                        
-						
-						if( parameter->checkNeighborGroup( spaceName ) == false ) throw Exception( "FLOCK ERROR: Parameter does not contain neighbor group " + spaceName, __FILE__, __FUNCTION__, __LINE__ );
-						space::NeighborGroup* neighborGroup = parameter->neighborGroup(spaceName);
-						mInputNeighborGroups.push_back( neighborGroup );
-						mNeighborInputParameterNames.push_back( neighborParName );
-					}
-				}
+				if( parameter->checkNeighborGroup( spaceName ) == false ) throw Exception( "FLOCK ERROR: Parameter does not contain neighbor group " + spaceName, __FILE__, __FUNCTION__, __LINE__ );
+				space::NeighborGroup* neighborGroup = parameter->neighborGroup(spaceName);
+				mInputNeighborGroups.push_back( neighborGroup );
+				mNeighborInputParameterNames.push_back( spec.mNeighborParameterNames[j] );
+				mInputNeighborSpaceNames.push_back( spaceName );
+				mInputNeighborParameterIndices.push_back( mInputParameters.size() - 1 );
 			}
 		}
 	}
@@ -140,73 +196,32 @@ Behavior::createOutputParameters() throw (Exception)
 {
 	try
 	{
-        Tokenizer& tokenizer = Tokenizer::get();
-        std::vector<std::string> outputParameterNames;
-        tokenizer.split(mOutputParameterString, outputParameterNames, ' ');
-		unsigned int outputParameterCount = outputParameterNames.size();
+		// behaviors that are cloned from a prototype reuse its parsed and resolved parameter string
+		const Behavior* prototype = mAgent->prototypeBehavior();
+		mOutputLayout = parameterLayout( mOutputParameterString, prototype != nullptr ? prototype->mOutputLayout : nullptr );
+		unsigned int outputParameterCount = mOutputLayout->mSpecs.size();
+		
+		mOutputParameters.reserve( outputParameterCount );
 		
 		for(unsigned int i=0; i<outputParameterCount; ++i)
 		{
-			if( outputParameterNames[i].find('@') == std::string::npos ) // parameter_name
+			const ParameterSpec& spec = mOutputLayout->mSpecs[i];
+			Parameter* parameter = layoutParameter( *mOutputLayout, i );
+			
+			mOutputParameters.push_back(parameter);
+			
+			unsigned int spaceCount = spec.mSpaceNames.size();
+			for(unsigned int j=0; j<spaceCount; ++j) // neighbors requested
 			{
-				std::string parameterName = outputParameterNames[i];
-				Parameter* parameter;
-				
-				if( mAgent->checkParameter( parameterName ) ) parameter = mAgent->parameter(parameterName);
-				else
-				{
-					Swarm* swarm = static_cast< Swarm* > (mAgent);
-					if( swarm->checkSwarmParameter( parameterName ) ) parameter = swarm->swarmParameter(parameterName);
-					else throw Exception( "FLOCK ERROR: parameter " + parameterName + " not found", __FILE__, __FUNCTION__, __LINE__ );
-				}
-				
-				mOutputParameters.push_back(parameter);
-			}
-			else // parameter_name @ space_name
-			{
-				std::string parameterName;
-				std::string spaceName;
-				std::string neighborParName;
-				Parameter* parameter;
-				
-                std::vector<std::string> parSpacePairNames;
-                tokenizer.split(outputParameterNames[i], parSpacePairNames, '@');
-				parameterName = parSpacePairNames[0];
-				
-				if( mAgent->checkParameter( parameterName ) ) parameter = mAgent->parameter(parameterName);
-				else
-				{
-					Swarm* swarm = static_cast< Swarm* > (mAgent);
-					if( swarm->checkSwarmParameter( parameterName ) ) parameter = swarm->swarmParameter( parameterName );
-					else throw Exception( "FLOCK ERROR: parameter " + parameterName + " not found", __FILE__, __FUNCTION__, __LINE__ );
-				}
-				
-				mOutputParameters.push_back(parameter);
+				const std::string& spaceName = spec.mSpaceNames[j];
 				
-				if(parSpacePairNames.size() > 1) // neighbors requested
-				{
-					for(unsigned int j=1; j<parSpacePairNames.size(); ++j)
-					{
-						if( parSpacePairNames[j].find(':') != std::string::npos) // parameter_name @ space_name : neighbor_parameter_name
-						{
-                            std::vector<std::string> spaceNeighborParPairNames;
-                            tokenizer.split(parSpacePairNames[j], spaceNeighborParPairNames, ':');
-							spaceName = spaceNeighborParPairNames[0];
-							neighborParName = spaceNeighborParPairNames[1];
-						}
-						else
-						{
-							spaceName = parSpacePairNames[j];
-							neighborParName = "";
-						}
-						
-						if( parameter->checkNeighborGroup( spaceName ) == false ) throw Exception( "FLOCK ERROR: Parameter does not contain neighbor group " + spaceName, __FILE__, __FUNCTION__, __LINE__ );
-                        
-						space::NeighborGroup* neighborGroup = parameter->neighborGroup(spaceName);
-						mOutputNeighborGroups.push_back( neighborGroup );
-						mNeighborOutputParameterNames.push_back( neighborParName );
-					}
-				}
+				if( parameter->checkNeighborGroup( spaceName ) == false ) throw Exception( "FLOCK ERROR: Parameter does not contain neighbor group " + spaceName, __FILE__, __FUNCTION__, __LINE__ );
+                
+				space::NeighborGroup* neighborGroup = parameter->neighborGroup(spaceName);
+				mOutputNeighborGroups.push_back( neighborGroup );
+				mNeighborOutputParameterNames.push_back( spec.mNeighborParameterNames[j] );
+				mOutputNeighborSpaceNames.push_back( spaceName );
+				mOutputNeighborParameterIndices.push_back( mOutputParameters.size() - 1 );
 			}
 		}
 	}
@@ -304,6 +319,214 @@ Behavior::outputParameterString() const
 	return mOutputParameterString;
 }
 
+void
+Behavior::actAll(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount)
+{
+	if( mShared == true )
+	{
+		Behavior* worker = this->worker();
+		
+		for(unsigned int aI=0; aI<pAgentCount; ++aI)
+		{
+			worker->bind( pAgents[aI] );
+			worker->act();
+		}
+	}
+	else
+	{
+		for(unsigned int bI=0; bI<pAgentCount; ++bI) pBehaviors[bI]->act();
+	}
+}
+
+bool
+Behavior::threadSafe() const
+{
+	return true;
+}
+
+bool
+Behavior::shareable() const
+{
+	return false;
+}
+
+bool
+Behavior::shared() const
+{
+	return mShared;
+}
+
+Behavior*
+Behavior::createShared(Agent* pSwarm) const throw (Exception)
+{
+	if( shareable() == false ) throw Exception( "FLOCK ERROR: behavior class " + mClassName + " can not be shared", __FILE__, __FUNCTION__, __LINE__ );
+	
+	try
+	{
+		Behavior* behavior = create( mName, pSwarm );
+		behavior->mShared = true;
+		
+		return behavior;
+	}
+	catch(Exception& e)
+	{
+		e += Exception( "FLOCK ERROR: failed to create shared behavior " + mName, __FILE__, __FUNCTION__, __LINE__ );
+		throw e;
+	}
+}
+
+void
+Behavior::updateWorkers(unsigned int pWorkerCount) throw (Exception)
+{
+	try
+	{
+		while( mWorkers.size() < pWorkerCount )
+		{
+			Behavior* worker = create( mName, mAgent );
+			worker->createBindings();
+			mWorkers.push_back( worker );
+		}
+	}
+	catch(Exception& e)
+	{
+		e += Exception( "FLOCK ERROR: failed to create worker for shared behavior " + mName, __FILE__, __FUNCTION__, __LINE__ );
+		throw e;
+	}
+	
+	// parameter indices change when parameters are added to or removed from the agents
+	unsigned int workerCount = mWorkers.size();
+	for(unsigned int wI=0; wI<workerCount; ++wI)
+	{
+		std::vector<ParameterBinding>& bindings = mWorkers[wI]->mParameterBindings;
+		unsigned int bindingCount = bindings.size();
+		
+		for(unsigned int bI=0; bI<bindingCount; ++bI)
+		{
+			ParameterBinding& binding = bindings[bI];
+			binding.mIndex = mAgent->checkParameter( binding.mName ) == true ? static_cast<int>( mAgent->parameterIndex( binding.mName ) ) : -1;
+		}
+	}
+}
+
+Behavior*
+Behavior::worker()
+{
+	return mWorkers[ ThreadPool::threadIndex() ];
+}
+
+void
+Behavior::createBindings()
+{
+	bindParameter( mActivePar );
+	
+	unsigned int inputParameterCount = mInputParameters.size();
+	for(unsigned int pI=0; pI<inputParameterCount; ++pI) bindParameter( mInputParameters[pI] );
+	
+	unsigned int outputParameterCount = mOutputParameters.size();
+	for(unsigned int pI=0; pI<outputParameterCount; ++pI) bindParameter( mOutputParameters[pI] );
+	
+	unsigned int inputNeighborGroupCount = mInputNeighborGroups.size();
+	for(unsigned int nI=0; nI<inputNeighborGroupCount; ++nI) bindNeighborGroup( mInputNeighborGroups[nI], mInputParameters[ mInputNeighborParameterIndices[nI] ], mInputNeighborSpaceNames[nI] );
+	
+	unsigned int outputNeighborGroupCount = mOutputNeighborGroups.size();
+	for(unsigned int nI=0; nI<outputNeighborGroupCount; ++nI) bindNeighborGroup( mOutputNeighborGroups[nI], mOutputParameters[ mOutputNeighborParameterIndices[nI] ], mOutputNeighborSpaceNames[nI] );
+}
+
+void
+Behavior::bindParameter(Parameter*& pParameter)
+{
+	mParameterBindings.push_back( ParameterBinding( &pParameter, pParameter->name() ) );
+}
+
+void
+Behavior::bindNeighborGroup(space::NeighborGroup*& pNeighborGroup, Parameter*& pParameter, const std::string& pSpaceName)
+{
+	mNeighborGroupBindings.push_back( NeighborGroupBinding( &pNeighborGroup, &pParameter, pSpaceName ) );
+}
+
+void
+Behavior::bind(Agent* pAgent)
+{
+	mAgent = pAgent;
+	
+	unsigned int bindingCount = mParameterBindings.size();
+	for(unsigned int bI=0; bI<bindingCount; ++bI)
+	{
+		const ParameterBinding& binding = mParameterBindings[bI];
+		if( binding.mIndex >= 0 ) *( binding.mSlot ) = pAgent->parameter( binding.mIndex );
+	}
+	
+	unsigned int neighborBindingCount = mNeighborGroupBindings.size();
+	for(unsigned int bI=0; bI<neighborBindingCount; ++bI)
+	{
+		NeighborGroupBinding& binding = mNeighborGroupBindings[bI];
+		Parameter* parameter = *( binding.mParameterSlot );
+		space::NeighborGroup* neighborGroup = nullptr;
+		
+		if( binding.mIndex >= 0 && binding.mIndex < parameter->neighbors()->neighborGroupCount() ) neighborGroup = parameter->neighborGroup( binding.mIndex );
+		
+		// the order of neighbor groups depends on when the parameter has been assigned to its spaces, it is therefore only resolved again if it differs
+		if( neighborGroup == nullptr || neighborGroup->space() != binding.mSpace )
+		{
+			binding.mIndex = parameter->neighborGroupIndex( binding.mSpaceName );
+			neighborGroup = parameter->neighborGroup( binding.mIndex );
+			binding.mSpace = neighborGroup->space();
+		}
+		
+		*( binding.mSlot ) = neighborGroup;
+	}
+}
+
+void
+Behavior::actShared(Agent* pAgent)
+{
+	Behavior* worker = this->worker();
+	
+	worker->bind( pAgent );
+	worker->act();
+}
+
+void
+Behavior::addProfileTime(double pTime, unsigned long pAllocationCount)
+{
+	Behavior* behavior = mShared == true ? worker() : this;
+	
+	behavior->mProfileTime += pTime;
+	behavior->mProfileAllocationCount += pAllocationCount;
+}
+
+double
+Behavior::takeProfileTime()
+{
+	double time = mProfileTime;
+	mProfileTime = 0.0;
+	
+	unsigned int workerCount = mWorkers.size();
+	for(unsigned int wI=0; wI<workerCount; ++wI)
+	{
+		time += mWorkers[wI]->mProfileTime;
+		mWorkers[wI]->mProfileTime = 0.0;
+	}
+	
+	return time;
+}
+
+unsigned long
+Behavior::takeProfileAllocationCount()
+{
+	unsigned long count = mProfileAllocationCount;
+	mProfileAllocationCount = 0;
+	
+	unsigned int workerCount = mWorkers.size();
+	for(unsigned int wI=0; wI<workerCount; ++wI)
+	{
+		count += mWorkers[wI]->mProfileAllocationCount;
+		mWorkers[wI]->mProfileAllocationCount = 0;
+	}
+	
+	return count;
+}
+
 Behavior::operator std::string() const
 {
     return info();
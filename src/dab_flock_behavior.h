@@ -23,6 +23,7 @@
 #include "dab_space_neighbor_group.h"
 #include <Eigen/Dense>
 #include <vector>
+#include <memory>
 
 namespace dab
 {
@@ -36,8 +37,13 @@ class Behavior
 {
     
 friend class Swarm;
+friend class BehaviorList;
+friend class FlockProfiler;
+friend class Simulation;
     
 public:
+    static bool sFixedDimKernels; /// \brief behaviors that provide fixed dimension kernels use them for parameters with up to three dimensions
+    
     /**
      \brief create behavior
      \param pInputParameterString input parameter string (parameters are space separated)
@@ -100,6 +106,35 @@ public:
      */
     virtual void act() = 0;
     
+    /**
+     \brief perform behavior for a span of agents
+     \param pAgents agents
+     \param pBehaviors behaviors of equal name and class, one for each agent
+     \param pAgentCount number of agents
+     
+     used for behavior-major execution in which a behavior acts on all agents before the next behavior acts.\n
+     called on the first behavior of the span. the default implementation calls act() for each behavior, or binds a worker of a shared behavior to each agent.\n
+     */
+    virtual void actAll(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount);
+    
+    /**
+     \brief check whether behavior can act concurrently with the behaviors of other agents
+     \return true if behavior only writes to parameters of its own agent and doesn't access shared state
+     */
+    virtual bool threadSafe() const;
+    
+    /**
+     \brief check whether a single instance of the behavior can act on behalf of all agents of a swarm
+     \return true if the behavior class supports rebinding its parameters to other agents
+     */
+    virtual bool shareable() const;
+    
+    /**
+     \brief check whether this instance acts on behalf of all agents of a swarm
+     \return true if instance is shared
+     */
+    bool shared() const;
+    
     /**
      \brief print behavior information
      */
@@ -129,6 +164,57 @@ protected:
      */
     Behavior();
     
+    /**
+     \brief parsed entry of an input or output parameter string: parameter_name[@space_name[:neighbor_parameter_name]]...
+     */
+    class ParameterSpec
+    {
+    public:
+        std::string mParameterName; /// \brief parameter name
+        std::vector<std::string> mSpaceNames; /// \brief names of spaces whose neighbor groups are requested
+        std::vector<std::string> mNeighborParameterNames; /// \brief neighbor parameter name for each space (empty: neighbor parameter itself)
+    };
+    
+    /**
+     \brief parsed input or output parameter string together with the parameter indices it resolves to
+     */
+    class ParameterLayout
+    {
+    public:
+        std::string mParameterString; /// \brief unparsed parameter string
+        std::vector<ParameterSpec> mSpecs; /// \brief parsed parameter string
+        std::vector<int> mParameterIndices; /// \brief index of each parameter within the agent (-1: swarm parameter)
+    };
+    
+    /**
+     \brief return layout of a parameter string
+     \param pParameterString input or output parameter string
+     \param pPrototypeLayout layout of the behavior this behavior is cloned from (nullptr: none)
+     \return layout
+     
+     the layout of the prototype is reused if it has been created from the same parameter string, otherwise the string is parsed and its parameters are resolved for the agent of this behavior
+     */
+    std::shared_ptr< const ParameterLayout > parameterLayout(const std::string& pParameterString, const std::shared_ptr< const ParameterLayout >& pPrototypeLayout) const;
+    
+    /**
+     \brief return parameter of a layout entry
+     \param pLayout layout
+     \param pSpecIndex index of entry
+     \return parameter
+     \exception Exception parameter not found
+     
+     the parameter is looked up by name only if the resolved index doesn't refer to a parameter of the same name
+     */
+    Parameter* layoutParameter(const ParameterLayout& pLayout, unsigned int pSpecIndex) throw (Exception);
+    
+    /**
+     \brief return agent or swarm parameter
+     \param pParameterName parameter name
+     \return parameter
+     \exception Exception parameter not found
+     */
+    Parameter* specParameter(const std::string& pParameterName) throw (Exception);
+    
     /**
      \brief create input behavior parameters
      \exception Exception failed to create input parameters
@@ -181,6 +267,123 @@ protected:
      */
     std::vector< Parameter* >& internalParameters();
     
+    /**
+     \brief parameter pointer that is redirected to the parameter of the agent a worker acts on
+     */
+    class ParameterBinding
+    {
+    public:
+        ParameterBinding( Parameter** pSlot, const std::string& pName )
+        : mSlot( pSlot )
+        , mName( pName )
+        , mIndex( -1 )
+        {};
+        
+        Parameter** mSlot; /// \brief address of parameter pointer
+        std::string mName; /// \brief parameter name
+        int mIndex; /// \brief parameter index within agents (-1: swarm parameter, not redirected)
+    };
+    
+    /**
+     \brief neighbor group pointer that is redirected to the neighbor group of the agent a worker acts on
+     */
+    class NeighborGroupBinding
+    {
+    public:
+        NeighborGroupBinding( space::NeighborGroup** pSlot, Parameter** pParameterSlot, const std::string& pSpaceName )
+        : mSlot( pSlot )
+        , mParameterSlot( pParameterSlot )
+        , mSpaceName( pSpaceName )
+        , mIndex( -1 )
+        , mSpace( nullptr )
+        {};
+        
+        space::NeighborGroup** mSlot; /// \brief address of neighbor group pointer
+        Parameter** mParameterSlot; /// \brief address of pointer to the parameter that owns the neighbor group
+        std::string mSpaceName; /// \brief space name
+        int mIndex; /// \brief neighbor group index within the parameter (-1: not yet resolved)
+        space::Space* mSpace; /// \brief space of the resolved neighbor group (nullptr: not yet resolved)
+    };
+    
+    /**
+     \brief create instance that acts on behalf of all agents of a swarm
+     \param pSwarm swarm whose agent parameters serve as template for the parameter layout of all agents
+     \return shared behavior
+     \exception Exception failed to create behavior
+     */
+    Behavior* createShared(Agent* pSwarm) const throw (Exception);
+    
+    /**
+     \brief create missing workers of a shared behavior and update their parameter indices
+     \param pWorkerCount number of workers (one per thread)
+     \exception Exception failed to create worker
+     
+     the workers are the per thread scratch copies of a shared behavior, they are rebound to each agent before acting on it
+     */
+    void updateWorkers(unsigned int pWorkerCount) throw (Exception);
+    
+    /**
+     \brief return worker of a shared behavior for the calling thread
+     \return worker
+     */
+    Behavior* worker();
+    
+    /**
+     \brief register all parameter and neighbor group pointers that need to be redirected when a worker acts on an agent
+     
+     derived shareable behaviors call this method and register the pointers of their own members
+     */
+    virtual void createBindings();
+    
+    /**
+     \brief register parameter pointer that needs to be redirected when a worker acts on an agent
+     \param pParameter parameter pointer
+     */
+    void bindParameter(Parameter*& pParameter);
+    
+    /**
+     \brief register neighbor group pointer that needs to be redirected when a worker acts on an agent
+     \param pNeighborGroup neighbor group pointer
+     \param pParameter pointer to parameter that owns the neighbor group (needs to be registered as well)
+     \param pSpaceName space name
+     */
+    void bindNeighborGroup(space::NeighborGroup*& pNeighborGroup, Parameter*& pParameter, const std::string& pSpaceName);
+    
+    /**
+     \brief redirect parameter and neighbor group pointers to those of an agent
+     \param pAgent agent
+     
+     neighbor groups are looked up by space name only if the cached neighbor group index of a binding does not refer to the same space in the parameter of the agent
+     */
+    void bind(Agent* pAgent);
+    
+    /**
+     \brief perform shared behavior for a single agent
+     \param pAgent agent
+     */
+    void actShared(Agent* pAgent);
+    
+    /**
+     \brief accumulate act time and heap allocations while profiling
+     \param pTime act time (milliseconds)
+     \param pAllocationCount number of heap allocations during act
+     
+     the time of shared behaviors is accumulated in the worker of the calling thread
+     */
+    void addProfileTime(double pTime, unsigned long pAllocationCount);
+    
+    /**
+     \brief return act time accumulated while profiling and reset it
+     \return act time (milliseconds), including the time of all workers of a shared behavior
+     */
+    double takeProfileTime();
+    
+    /**
+     \brief return number of heap allocations accumulated while profiling and reset it
+     \return number of allocations, including the allocations of all workers of a shared behavior
+     */
+    unsigned long takeProfileAllocationCount();
+    
     std::string mName; /// \brief behavior name
     std::string mClassName; /// \brief behavior class name
     Agent* mAgent; /// \brief agent this behavior belongs to	
@@ -189,11 +392,25 @@ protected:
     std::vector<Parameter*> mInputParameters; /// \brief input parameters (behavior reads from them)
     std::vector<space::NeighborGroup*> mInputNeighborGroups; /// \brief input neighbor groups (behavior reads from them)
     std::vector<std::string> mNeighborInputParameterNames; /// \brief input parameter names for parameters that are retrieved via neighbor groups
+    std::vector<std::string> mInputNeighborSpaceNames; /// \brief space names of input neighbor groups
+    std::vector<unsigned int> mInputNeighborParameterIndices; /// \brief input parameter index of each input neighbor group
     std::vector<Parameter*> mOutputParameters; /// \brief output parameters (behavior writes to them)
     std::vector<space::NeighborGroup*> mOutputNeighborGroups; /// \brief output neighbor groups (behavior writes to them)
     std::vector<std::string> mNeighborOutputParameterNames; /// \brief output parameter names for parameters that are retrieved via neighbor groups
+    std::vector<std::string> mOutputNeighborSpaceNames; /// \brief space names of output neighbor groups
+    std::vector<unsigned int> mOutputNeighborParameterIndices; /// \brief output parameter index of each output neighbor group
+    std::shared_ptr< const ParameterLayout > mInputLayout; /// \brief input parameter layout (shared with the behaviors cloned from this one)
+    std::shared_ptr< const ParameterLayout > mOutputLayout; /// \brief output parameter layout (shared with the behaviors cloned from this one)
     std::vector<Parameter*> mInternalParameters; /// \brief internal parameters (including scales)
     Parameter* mActivePar; /// \brief active parameter (internal)
+    double mProfileTime; /// \brief act time accumulated while profiling and not yet collected by the profiler (milliseconds)
+    unsigned long mProfileAllocationCount; /// \brief heap allocations accumulated while profiling and not yet collected by the profiler
+    int mProfileSlot; /// \brief index of profiler slot (-1: not yet assigned)
+    
+    bool mShared; /// \brief instance acts on behalf of all agents of a swarm
+    std::vector<Behavior*> mWorkers; /// \brief per thread workers of a shared behavior
+    std::vector<ParameterBinding> mParameterBindings; /// \brief redirected parameter pointers (workers only)
+    std::vector<NeighborGroupBinding> mNeighborGroupBindings; /// \brief redirected neighbor group pointers (workers only)
 };
 
 };
@@ -3,6 +3,8 @@
 
 #include "dab_flock_behavior_list.h"
 #include "dab_flock_agent.h"
+#include "dab_flock_profiler.h"
+#include "dab_flock_allocation_counter.h"
 
 using namespace dab;
 using namespace dab::flock;
@@ -19,7 +21,9 @@ BehaviorList::~BehaviorList()
 	for(unsigned int i=0; i<behaviorCount; ++i)
 	{
 		Behavior* behavior = mBehaviors[i];
-		delete behavior;
+		
+		// shared behaviors are owned by the swarm
+		if( behavior->shared() == false ) delete behavior;
 	}
 	
 	mBehaviors.clear();
@@ -140,16 +144,37 @@ BehaviorList::removeBehavior(const std::string& pName) throw (Exception)
 }
 
 void
-BehaviorList::act()
+BehaviorList::act(Agent* pAgent)
 {
 	//std::cout << "BehaviorList::act() begin\n";
     
 	unsigned int behaviorCount = mBehaviors.size();
+	
+	if( FlockProfiler::get().enabled() == true )
+	{
+		// the time is accumulated in the behavior itself since agents act concurrently, the profiler collects it after the step
+		for(unsigned int i=0; i<behaviorCount; ++i)
+		{
+			Behavior* behavior = mBehaviors[i];
+			
+			unsigned long startAllocationCount = AllocationCounter::threadCount();
+			FlockProfiler::Clock::time_point startTime = FlockProfiler::now();
+			if( behavior->mShared == true ) behavior->actShared( pAgent );
+			else behavior->act();
+			behavior->addProfileTime( FlockProfiler::elapsed( startTime, FlockProfiler::now() ), AllocationCounter::threadCount() - startAllocationCount );
+		}
+		
+		return;
+	}
+	
 	for(unsigned int i=0; i<behaviorCount; ++i)
 	{
 		//std::cout << "behavior " << mBehaviors[i].name().toStdString() << " act begin\n";
         
-		mBehaviors[i]->act();
+		Behavior* behavior = mBehaviors[i];
+		
+		if( behavior->mShared == true ) behavior->actShared( pAgent );
+		else behavior->act();
 		
 		//std::cout << "behavior " << mBehaviors[i].name().toStdString() << " act end\n";
 	}
@@ -117,8 +117,9 @@ public:
     
     /**
      \brief perform behaviors
+     \param pAgent agent the behaviors belong to (shared behaviors act on behalf of this agent)
      */
-    void act();
+    void act(Agent* pAgent);
     
     /**
      \brief print behavior list information
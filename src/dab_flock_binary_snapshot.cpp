@@ -0,0 +1,407 @@
+/** \file dab_flock_binary_snapshot.cpp
+ */
+
+#include "dab_flock_binary_snapshot.h"
+#include "dab_flock_simulation.h"
+#include "dab_flock_swarm.h"
+#include "dab_flock_agent.h"
+#include "dab_flock_env.h"
+#include "dab_flock_env_parameter.h"
+#include "dab_space_includes.h"
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+using namespace dab;
+using namespace dab::flock;
+
+const std::string BinarySnapshot::sFileExtension = ".fsnap";
+const char BinarySnapshot::sMagic[8] = { 'D', 'A', 'B', 'F', 'S', 'N', 'A', 'P' };
+const uint32_t BinarySnapshot::sVersion = 1;
+const unsigned int BinarySnapshot::sHeaderSize = 32;
+const unsigned int BinarySnapshot::sBlockAlignment = 64;
+const uint32_t BinarySnapshot::sByteOrderMark = 0x01020304;
+
+template<typename ValueType>
+char*
+BinarySnapshot::write(ValueType pValue, char* pBuffer)
+{
+	std::memcpy( pBuffer, &pValue, sizeof(ValueType) );
+
+	return pBuffer + sizeof(ValueType);
+}
+
+template<typename ValueType>
+const char*
+BinarySnapshot::read(ValueType& pValue, const char* pBuffer, const char* pBufferEnd) throw (Exception)
+{
+	if( pBuffer + sizeof(ValueType) > pBufferEnd ) throw Exception( "FLOCK ERROR: unexpected end of snapshot file", __FILE__, __FUNCTION__, __LINE__ );
+
+	std::memcpy( &pValue, pBuffer, sizeof(ValueType) );
+
+	return pBuffer + sizeof(ValueType);
+}
+
+BinarySnapshot::Entry::Entry()
+: mKind(SwarmEntry)
+, mDim(0)
+, mCount(0)
+, mDataOffset(0)
+{}
+
+BinarySnapshot::BinarySnapshot()
+{}
+
+bool
+BinarySnapshot::checkFileName(const std::string& pFileName)
+{
+	if( pFileName.size() < sFileExtension.size() ) return false;
+
+	return pFileName.compare( pFileName.size() - sFileExtension.size(), sFileExtension.size(), sFileExtension ) == 0;
+}
+
+bool
+BinarySnapshot::checkFile(const std::string& pFilePath)
+{
+	std::ifstream file( pFilePath, std::ios::binary );
+	if( file.is_open() == false ) return false;
+
+	char magic[8];
+	file.read( magic, 8 );
+
+	return file.gcount() == 8 && std::memcmp( magic, sMagic, 8 ) == 0;
+}
+
+void
+BinarySnapshot::save(const std::string& pFilePath) throw (Exception)
+{
+	encode( mBuffer );
+	writeFile( pFilePath, mBuffer );
+}
+
+void
+BinarySnapshot::encode(std::vector<char>& pBuffer) throw (Exception)
+{
+	mEntries.clear();
+	mSources.clear();
+
+	Simulation& simulation = Simulation::get();
+
+	// swarms
+	std::vector<Swarm*>& swarms = simulation.swarms();
+	unsigned int swarmCount = swarms.size();
+
+	for(unsigned int sI=0; sI<swarmCount; ++sI)
+	{
+		Swarm* swarm = swarms[sI];
+		std::vector<Agent*>& agents = swarm->agents();
+		unsigned int agentCount = agents.size();
+
+		addEntry( SwarmEntry, swarm->name(), 0, agentCount );
+
+		unsigned int swarmParameterCount = swarm->swarmParameterCount();
+		for(unsigned int spI=0; spI<swarmParameterCount; ++spI)
+		{
+			Parameter* swarmParameter = swarm->swarmParameter( spI );
+
+			addEntry( SwarmParameterEntry, swarmParameter->name(), swarmParameter->dim(), 1 );
+			mSources.push_back( swarmParameter->values().data() );
+		}
+
+		unsigned int agentParameterCount = swarm->parameterCount();
+		for(unsigned int apI=0; apI<agentParameterCount; ++apI)
+		{
+			Parameter* agentParameter = static_cast<Agent*>( swarm )->parameter( apI );
+
+			addEntry( AgentParameterEntry, agentParameter->name(), agentParameter->dim(), agentCount + 1 );
+			mSources.push_back( agentParameter->values().data() );
+
+			// agents copy the parameters of the swarm in order, the index is the same
+			for(unsigned int aI=0; aI<agentCount; ++aI) mSources.push_back( agents[aI]->parameter( apI )->values().data() );
+		}
+	}
+
+	// environments
+	std::vector<Env*>& envs = simulation.envs();
+	unsigned int envCount = envs.size();
+
+	for(unsigned int eI=0; eI<envCount; ++eI)
+	{
+		Env* env = envs[eI];
+
+		addEntry( EnvEntry, env->name(), 0, 0 );
+
+		unsigned int parameterCount = env->parameterCount();
+		for(unsigned int epI=0; epI<parameterCount; ++epI)
+		{
+			Parameter* parameter = env->parameter( epI );
+			EnvParameter* envParameter = dynamic_cast<EnvParameter*>( parameter );
+
+			if( envParameter == nullptr )
+			{
+				addEntry( EnvParameterEntry, parameter->name(), parameter->values().rows(), 1 );
+				mSources.push_back( parameter->values().data() );
+				continue;
+			}
+
+			const math::VectorField<float>& field = envParameter->grid()->vectorField();
+			const std::vector<Eigen::VectorXf>& vectors = field.vectors();
+			unsigned int vectorCount = field.vectorCount();
+
+			addEntry( EnvGridEntry, parameter->name(), field.vectorDim(), vectorCount );
+
+			const dab::Array<unsigned int>& gridSize = envParameter->gridSize();
+			unsigned int gridDim = gridSize.size();
+			for(unsigned int d=0; d<gridDim; ++d) mEntries.back().mGridSize.push_back( gridSize[d] );
+
+			for(unsigned int vI=0; vI<vectorCount; ++vI) mSources.push_back( vectors[vI].data() );
+		}
+	}
+
+	// layout: header, directory, aligned float blocks
+	unsigned int entryCount = mEntries.size();
+	uint64_t directorySize = 0;
+	for(unsigned int eI=0; eI<entryCount; ++eI) directorySize += entrySize( mEntries[eI] );
+
+	uint64_t fileSize = align( sHeaderSize + directorySize );
+
+	for(unsigned int eI=0; eI<entryCount; ++eI)
+	{
+		Entry& entry = mEntries[eI];
+		uint64_t blockSize = static_cast<uint64_t>( entry.mDim ) * ( entry.mKind == SwarmEntry ? 0 : entry.mCount ) * sizeof(float);
+
+		entry.mDataOffset = blockSize > 0 ? fileSize : 0;
+		fileSize = align( fileSize + blockSize );
+	}
+
+	pBuffer.assign( fileSize, 0 );
+	char* data = pBuffer.data();
+
+	// header
+	std::memcpy( data, sMagic, 8 );
+	data += 8;
+	data = write<uint32_t>( sVersion, data );
+	data = write<uint32_t>( sByteOrderMark, data );
+	data = write<uint32_t>( entryCount, data );
+	data = write<uint32_t>( 0, data );
+	data = write<uint64_t>( sHeaderSize + directorySize, data );
+
+	// directory
+	for(unsigned int eI=0; eI<entryCount; ++eI)
+	{
+		const Entry& entry = mEntries[eI];
+
+		data = write<uint32_t>( entry.mKind, data );
+		data = write<uint32_t>( entry.mName.size(), data );
+		std::memcpy( data, entry.mName.data(), entry.mName.size() );
+		data += entry.mName.size();
+		data = write<uint32_t>( entry.mDim, data );
+		data = write<uint32_t>( entry.mCount, data );
+		data = write<uint32_t>( entry.mGridSize.size(), data );
+		for(unsigned int d=0; d<entry.mGridSize.size(); ++d) data = write<uint32_t>( entry.mGridSize[d], data );
+		data = write<uint64_t>( entry.mDataOffset, data );
+	}
+
+	// float blocks
+	unsigned int sourceIndex = 0;
+
+	for(unsigned int eI=0; eI<entryCount; ++eI)
+	{
+		const Entry& entry = mEntries[eI];
+		if( entry.mKind == SwarmEntry || entry.mKind == EnvEntry ) continue;
+
+		char* block = pBuffer.data() + entry.mDataOffset;
+		unsigned int vectorSize = entry.mDim * sizeof(float);
+
+		for(unsigned int vI=0; vI<entry.mCount; ++vI, ++sourceIndex, block += vectorSize)
+		{
+			std::memcpy( block, mSources[sourceIndex], vectorSize );
+		}
+	}
+
+	mSources.clear();
+}
+
+void
+BinarySnapshot::writeFile(const std::string& pFilePath, const std::vector<char>& pBuffer) throw (Exception)
+{
+	std::ofstream file( pFilePath, std::ios::binary | std::ios::trunc );
+	if( file.is_open() == false ) throw Exception( "FILE ERROR: failed to open file " + pFilePath + " for writing", __FILE__, __FUNCTION__, __LINE__ );
+
+	file.write( pBuffer.data(), pBuffer.size() );
+	if( file.good() == false ) throw Exception( "FILE ERROR: failed to write file " + pFilePath, __FILE__, __FUNCTION__, __LINE__ );
+}
+
+void
+BinarySnapshot::restore(const std::string& pFilePath) throw (Exception)
+{
+	std::ifstream file( pFilePath, std::ios::binary | std::ios::ate );
+	if( file.is_open() == false ) throw Exception( "FILE ERROR: failed to open file " + pFilePath + " for reading", __FILE__, __FUNCTION__, __LINE__ );
+
+	std::streamsize fileSize = file.tellg();
+	if( fileSize < 0 ) throw Exception( "FILE ERROR: failed to read file " + pFilePath, __FILE__, __FUNCTION__, __LINE__ );
+	file.seekg( 0, std::ios::beg );
+
+	mBuffer.resize( fileSize );
+	file.read( mBuffer.data(), fileSize );
+	if( file.gcount() != fileSize ) throw Exception( "FILE ERROR: failed to read file " + pFilePath, __FILE__, __FUNCTION__, __LINE__ );
+
+	const char* data = mBuffer.data();
+	const char* dataEnd = data + fileSize;
+
+	// header
+	if( fileSize < sHeaderSize || std::memcmp( data, sMagic, 8 ) != 0 ) throw Exception( "FLOCK ERROR: file " + pFilePath + " is not a binary snapshot", __FILE__, __FUNCTION__, __LINE__ );
+	data += 8;
+
+	uint32_t version, byteOrderMark, entryCount, reserved;
+	uint64_t directoryEnd;
+
+	data = read( version, data, dataEnd );
+	data = read( byteOrderMark, data, dataEnd );
+	data = read( entryCount, data, dataEnd );
+	data = read( reserved, data, dataEnd );
+	data = read( directoryEnd, data, dataEnd );
+
+	if( byteOrderMark != sByteOrderMark ) throw Exception( "FLOCK ERROR: binary snapshot has been written with a different byte order", __FILE__, __FUNCTION__, __LINE__ );
+	if( version > sVersion ) throw Exception( "FLOCK ERROR: binary snapshot version " + std::to_string(version) + " is not supported", __FILE__, __FUNCTION__, __LINE__ );
+
+	// directory
+	mEntries.resize( entryCount );
+
+	for(unsigned int eI=0; eI<entryCount; ++eI)
+	{
+		Entry& entry = mEntries[eI];
+		uint32_t nameSize, gridDim;
+
+		data = read( entry.mKind, data, dataEnd );
+		data = read( nameSize, data, dataEnd );
+		if( data + nameSize > dataEnd ) throw Exception( "FLOCK ERROR: unexpected end of snapshot file", __FILE__, __FUNCTION__, __LINE__ );
+		entry.mName.assign( data, nameSize );
+		data += nameSize;
+		data = read( entry.mDim, data, dataEnd );
+		data = read( entry.mCount, data, dataEnd );
+		data = read( gridDim, data, dataEnd );
+		entry.mGridSize.resize( gridDim );
+		for(unsigned int d=0; d<gridDim; ++d) data = read( entry.mGridSize[d], data, dataEnd );
+		data = read( entry.mDataOffset, data, dataEnd );
+
+		// agent parameter blocks start with the value of the swarm
+		if( entry.mKind == AgentParameterEntry && entry.mCount < 1 ) throw Exception( "FLOCK ERROR: agent parameter " + entry.mName + " contains no swarm value", __FILE__, __FUNCTION__, __LINE__ );
+
+		uint64_t blockSize = static_cast<uint64_t>( entry.mDim ) * ( entry.mKind == SwarmEntry ? 0 : entry.mCount ) * sizeof(float);
+		if( entry.mDataOffset + blockSize > static_cast<uint64_t>( fileSize ) ) throw Exception( "FLOCK ERROR: float block of " + entry.mName + " exceeds snapshot file", __FILE__, __FUNCTION__, __LINE__ );
+	}
+
+	// values
+	Simulation& simulation = Simulation::get();
+	Swarm* swarm = nullptr;
+	Env* env = nullptr;
+
+	for(unsigned int eI=0; eI<entryCount; ++eI)
+	{
+		const Entry& entry = mEntries[eI];
+		const float* values = reinterpret_cast<const float*>( mBuffer.data() + entry.mDataOffset );
+		unsigned int vectorSize = entry.mDim * sizeof(float);
+
+		if( entry.mKind == SwarmEntry )
+		{
+			swarm = simulation.swarm( entry.mName );
+			env = nullptr;
+
+			if( swarm->agentCount() < entry.mCount ) swarm->addAgents( entry.mCount - swarm->agentCount() );
+			else if( swarm->agentCount() > entry.mCount ) swarm->removeAgents( swarm->agentCount() - entry.mCount );
+		}
+		else if( entry.mKind == EnvEntry )
+		{
+			env = simulation.env( entry.mName );
+			swarm = nullptr;
+		}
+		else if( entry.mKind == SwarmParameterEntry && swarm != nullptr )
+		{
+			if( swarm->checkSwarmParameter( entry.mName ) == false ) continue;
+
+			Parameter* parameter = swarm->swarmParameter( entry.mName );
+			if( parameter->dim() != entry.mDim ) continue;
+
+			std::memcpy( parameter->values().data(), values, vectorSize );
+			std::memcpy( parameter->backupValues().data(), values, vectorSize );
+		}
+		else if( entry.mKind == AgentParameterEntry && swarm != nullptr )
+		{
+			if( swarm->checkParameter( entry.mName ) == false ) continue;
+
+			std::vector<Agent*>& agents = swarm->agents();
+			if( entry.mCount - 1 > agents.size() ) throw Exception( "FLOCK ERROR: agent parameter " + entry.mName + " contains values for " + std::to_string( entry.mCount - 1 ) + " agents but swarm " + swarm->name() + " has " + std::to_string( agents.size() ) + " agents", __FILE__, __FUNCTION__, __LINE__ );
+
+			unsigned int parameterIndex = swarm->parameterIndex( entry.mName );
+			Parameter* parameter = static_cast<Agent*>( swarm )->parameter( parameterIndex );
+			if( parameter->dim() != entry.mDim ) continue;
+
+			std::memcpy( parameter->values().data(), values, vectorSize );
+			std::memcpy( parameter->backupValues().data(), values, vectorSize );
+			values += entry.mDim;
+
+			unsigned int agentCount = entry.mCount - 1;
+
+			for(unsigned int aI=0; aI<agentCount; ++aI, values += entry.mDim)
+			{
+				Parameter* agentParameter = agents[aI]->parameter( parameterIndex );
+
+				std::memcpy( agentParameter->values().data(), values, vectorSize );
+				std::memcpy( agentParameter->backupValues().data(), values, vectorSize );
+			}
+		}
+		else if( entry.mKind == EnvParameterEntry && env != nullptr )
+		{
+			if( env->checkParameter( entry.mName ) == false ) continue;
+
+			Parameter* parameter = env->parameter( entry.mName );
+			if( parameter->values().rows() != entry.mDim ) continue;
+
+			std::memcpy( parameter->values().data(), values, vectorSize );
+			std::memcpy( parameter->backupValues().data(), values, vectorSize );
+		}
+		else if( entry.mKind == EnvGridEntry && env != nullptr )
+		{
+			if( env->checkParameter( entry.mName ) == false ) continue;
+
+			unsigned int gridDim = entry.mGridSize.size();
+			dab::Array<unsigned int> gridSize;
+			gridSize.setSize( gridDim );
+			for(unsigned int d=0; d<gridDim; ++d) gridSize[d] = entry.mGridSize[d];
+
+			math::VectorField<float> field( gridSize, Eigen::VectorXf( entry.mDim ) );
+			std::vector<Eigen::VectorXf>& vectors = field.vectors();
+			unsigned int vectorCount = std::min<unsigned int>( field.vectorCount(), entry.mCount );
+
+			for(unsigned int vI=0; vI<vectorCount; ++vI, values += entry.mDim) std::memcpy( vectors[vI].data(), values, vectorSize );
+
+			env->set( entry.mName, field );
+		}
+	}
+}
+
+void
+BinarySnapshot::addEntry(EntryKind pKind, const std::string& pName, uint32_t pDim, uint32_t pCount)
+{
+	mEntries.push_back( Entry() );
+
+	Entry& entry = mEntries.back();
+	entry.mKind = pKind;
+	entry.mName = pName;
+	entry.mDim = pDim;
+	entry.mCount = pCount;
+}
+
+uint64_t
+BinarySnapshot::entrySize(const Entry& pEntry)
+{
+	// kind, name size, name, dim, count, grid dim, grid size, data offset
+	return 4 + 4 + pEntry.mName.size() + 4 + 4 + 4 + 4 * pEntry.mGridSize.size() + 8;
+}
+
+uint64_t
+BinarySnapshot::align(uint64_t pOffset)
+{
+	return ( pOffset + sBlockAlignment - 1 ) / sBlockAlignment * sBlockAlignment;
+}
@@ -0,0 +1,163 @@
+/** \file dab_flock_binary_snapshot.h
+ *  \class dab::flock::BinarySnapshot binary file format for the values of a simulation
+ *  \brief binary file format for the values of a simulation
+ *
+ *  Stores the same values as SerializeTools in ValuesMode (swarm parameters, agent parameters of all agents and environment parameters) in a binary, versioned file.\n
+ *  The file consists of a header, a parameter directory and one contiguous float block per parameter. Agent parameter blocks hold the default values of the swarm followed by the values of each agent (agent after agent).\n
+ *  Numbers are stored in the byte order of the machine (little-endian on all supported platforms), a byte order mark rejects files written with a different one.\n
+ *  Each float block starts at a 64 byte aligned offset, so the file can be memory-mapped and the blocks copied directly into the parameters.\n
+ *  SerializeTools writes this format for ValuesMode if the file name ends with sFileExtension, and detects it on restore by the magic number at the beginning of the file.\n
+ */
+
+#ifndef _dab_flock_binary_snapshot_h_
+#define _dab_flock_binary_snapshot_h_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "dab_exception.h"
+
+namespace dab
+{
+
+namespace flock
+{
+
+class BinarySnapshot
+{
+public:
+    static const std::string sFileExtension; /// \brief file name extension that selects the binary format when saving
+    static const char sMagic[8]; /// \brief magic number at the beginning of the file
+    static const uint32_t sVersion; /// \brief format version
+
+    /**
+     \brief default constructor
+     */
+    BinarySnapshot();
+
+    /**
+     \brief check whether file name selects binary format
+     \param pFileName file name
+     \return true if the file name ends with sFileExtension
+     */
+    static bool checkFileName(const std::string& pFileName);
+
+    /**
+     \brief check whether file contains a binary snapshot
+     \param pFilePath file path
+     \return true if the file starts with the magic number
+     */
+    static bool checkFile(const std::string& pFilePath);
+
+    /**
+     \brief save values of all swarms and environments
+     \param pFilePath file path
+     \exception Exception failed to write file
+     */
+    void save(const std::string& pFilePath) throw (Exception);
+
+    /**
+     \brief encode values of all swarms and environments into file content
+     \param pBuffer file content
+     */
+    void encode(std::vector<char>& pBuffer) throw (Exception);
+
+    /**
+     \brief write encoded file content
+     \param pFilePath file path
+     \param pBuffer file content
+     \exception Exception failed to write file
+     */
+    static void writeFile(const std::string& pFilePath, const std::vector<char>& pBuffer) throw (Exception);
+
+    /**
+     \brief restore values of all swarms and environments
+     \param pFilePath file path
+     \exception Exception failed to read file, unsupported version, or swarm or environment not found
+     */
+    void restore(const std::string& pFilePath) throw (Exception);
+
+protected:
+    enum EntryKind
+    {
+        SwarmEntry, /// \brief swarm (count: number of agents, no values)
+        SwarmParameterEntry, /// \brief swarm parameter (count: 1)
+        AgentParameterEntry, /// \brief agent parameter (count: 1 + number of agents)
+        EnvEntry, /// \brief environment (no values)
+        EnvParameterEntry, /// \brief environment parameter (count: 1)
+        EnvGridEntry /// \brief environment grid parameter (count: number of grid vectors)
+    };
+
+    /**
+     \brief directory entry
+     */
+    class Entry
+    {
+    public:
+        Entry();
+
+        uint32_t mKind; /// \brief entry kind
+        std::string mName; /// \brief swarm, environment or parameter name
+        uint32_t mDim; /// \brief parameter dimension
+        uint32_t mCount; /// \brief number of value vectors
+        std::vector<uint32_t> mGridSize; /// \brief grid size (grid parameters only)
+        uint64_t mDataOffset; /// \brief file offset of float block
+    };
+
+    static const unsigned int sHeaderSize; /// \brief header size (bytes)
+    static const unsigned int sBlockAlignment; /// \brief alignment of float blocks (bytes)
+    static const uint32_t sByteOrderMark; /// \brief detects files written with a different byte order
+
+    std::vector<Entry> mEntries; /// \brief directory
+    std::vector<const float*> mSources; /// \brief values of each value vector of all entries in directory order (while saving)
+    std::vector<char> mBuffer; /// \brief file content (reused between calls)
+
+    /**
+     \brief add directory entry
+     \param pKind entry kind
+     \param pName name
+     \param pDim parameter dimension
+     \param pCount number of value vectors
+     
+     the values of the entry have to be added to mSources
+     */
+    void addEntry(EntryKind pKind, const std::string& pName, uint32_t pDim, uint32_t pCount);
+
+    /**
+     \brief return size of directory entry in file
+     \param pEntry entry
+     \return size (bytes)
+     */
+    static uint64_t entrySize(const Entry& pEntry);
+
+    /**
+     \brief return offset rounded up to block alignment
+     \param pOffset offset
+     \return aligned offset
+     */
+    static uint64_t align(uint64_t pOffset);
+
+    /**
+     \brief write value
+     \param pValue value
+     \param pBuffer destination
+     \return position after value
+     */
+    template<typename ValueType> static char* write(ValueType pValue, char* pBuffer);
+
+    /**
+     \brief read value
+     \param pValue value
+     \param pBuffer source
+     \param pBufferEnd end of source
+     \return position after value
+     \exception Exception read beyond end of source
+     */
+    template<typename ValueType> static const char* read(ValueType& pValue, const char* pBuffer, const char* pBufferEnd) throw (Exception);
+};
+
+};
+
+};
+
+#endif
@@ -74,21 +74,21 @@ BoundaryWrapBehavior::act()
 	Eigen::VectorXf& lowerBoundary = mLowerBoundaryPar->values();
 	Eigen::VectorXf& upperBoundary = mUpperBoundaryPar->values();
 	
-	Eigen::VectorXf boundarySize = upperBoundary - lowerBoundary;
-	
 	unsigned int dim = inValues.rows();
 	
 	outValues = inValues;
 	
 	for(unsigned int i=0; i<dim; ++i)
 	{
+		float boundarySize = upperBoundary[i] - lowerBoundary[i];
+		
 		while(outValues[i] < lowerBoundary[i])
 		{
-			outValues[i] += boundarySize[i];
+			outValues[i] += boundarySize;
 		}
 		while(outValues[i] > upperBoundary[i])
 		{
-			outValues[i] -= boundarySize[i];
+			outValues[i] -= boundarySize;
 		}
 	}
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ using namespace dab::flock;
 
 CohesionBehavior::CohesionBehavior(const std::string& pInputParameterString, const std::string& pOutputParameterString)
 : Behavior(pInputParameterString, pOutputParameterString)
+, mKernelDim(0)
 {
 	mClassName = "CohesionBehavior";
 }
@@ -46,6 +47,8 @@ CohesionBehavior::CohesionBehavior(Agent* pAgent, const std::string& pBehaviorNa
 	unsigned int dim = mForcePar->dim();
     mAvgDirection.resize(dim, 1);
 	mTmpForce.resize(dim, 1);
+	// the fixed kernel maps the force and the neighbor directions, the latter possess the dimension of the position
+	mKernelDim = ( sFixedDimKernels == true && dim <= 3 && mPositionPar->dim() == dim ) ? dim : 0;
 }
 
 CohesionBehavior::~CohesionBehavior()
@@ -86,6 +89,119 @@ CohesionBehavior::act()
 	//std::cout << "CohesionBehavior begin: out values" << mOutputParameters[0]->values() << " bValues " << mOutputParameters[0]->backupValues() << "\n";
 	if(mActivePar->value() <= 0.0) return;
     
+	switch(mKernelDim)
+	{
+		case 1: actFixed<1>(); break;
+		case 2: actFixed<2>(); break;
+		case 3: actFixed<3>(); break;
+		default: actDynamic();
+	}
+}
+
+bool
+CohesionBehavior::shareable() const
+{
+	return true;
+}
+
+void
+CohesionBehavior::createBindings()
+{
+	Behavior::createBindings();
+	
+	bindParameter( mPositionPar );
+	bindParameter( mForcePar );
+	bindParameter( mMinDistPar );
+	bindParameter( mMaxDistPar );
+	bindParameter( mAmountPar );
+	bindNeighborGroup( mPositionNeighbors, mInputParameters[ mInputNeighborParameterIndices[0] ], mInputNeighborSpaceNames[0] );
+}
+
+void
+CohesionBehavior::actAll(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount)
+{
+	switch(mKernelDim)
+	{
+		case 1: actAllFixed<1>(pAgents, pBehaviors, pAgentCount); break;
+		case 2: actAllFixed<2>(pAgents, pBehaviors, pAgentCount); break;
+		case 3: actAllFixed<3>(pAgents, pBehaviors, pAgentCount); break;
+		default: Behavior::actAll(pAgents, pBehaviors, pAgentCount);
+	}
+}
+
+template<int Dim>
+void
+CohesionBehavior::actAllFixed(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount)
+{
+	// a shared behavior acts with the worker of the calling thread, rebound to each agent
+	CohesionBehavior* behavior = mShared == true ? static_cast<CohesionBehavior*>( worker() ) : nullptr;
+	
+	for(unsigned int aI=0; aI<pAgentCount; ++aI)
+	{
+		if( mShared == true ) behavior->bind( pAgents[aI] );
+		else behavior = static_cast<CohesionBehavior*>( pBehaviors[aI] );
+		
+		if( behavior->mActivePar->value() <= 0.0 ) continue;
+		
+		if( behavior->mKernelDim == Dim ) behavior->actFixed<Dim>();
+		else behavior->act();
+	}
+}
+
+template<int Dim>
+void
+CohesionBehavior::actFixed()
+{
+	typedef Eigen::Matrix<float, Dim, 1> Vector;
+	
+	space::NeighborGroup& positionNeighbors = *mPositionNeighbors;
+	Eigen::Map<Vector> force( mForcePar->backupValues().data() );
+	float minDist = mMinDistPar->value();
+	float maxDist = mMaxDistPar->value();
+	float amount = mAmountPar->value();
+	
+	unsigned int totalNeighborCount = positionNeighbors.neighborCount();
+	unsigned int neighborCount = 0;
+	
+	if(totalNeighborCount == 0) return;
+	
+	float distance;
+	float avgDistance;
+	float scale;
+	
+	Vector avgDirection = Vector::Zero();
+	
+	for(unsigned int i=0; i<totalNeighborCount; ++i)
+	{
+		distance = positionNeighbors.distance(i);
+		
+		if(minDist > 0.0 && distance < minDist) continue;
+		if(maxDist > 0.0 && distance > maxDist) continue;
+		
+		avgDirection += Eigen::Map<const Vector>( positionNeighbors.direction(i).data() );
+		neighborCount++;
+	}
+	
+	if(neighborCount == 0) return;
+	
+	avgDirection /= static_cast<float>(neighborCount);
+	
+	avgDistance = avgDirection.norm();
+	if(maxDist > 0.0 && minDist > 0.0) scale = (avgDistance - minDist) / (maxDist - minDist);
+	else scale = 1.0;
+	
+	Vector tmpForce = avgDirection;
+	
+	tmpForce.normalize();
+	tmpForce *= scale;
+	tmpForce *= amount;
+	
+	force += tmpForce;
+}
+
+void
+CohesionBehavior::actDynamic()
+{
 	Eigen::VectorXf& position = mPositionPar->values();
 	space::NeighborGroup& positionNeighbors = *mPositionNeighbors;
 	Eigen::VectorXf& force = mForcePar->backupValues();
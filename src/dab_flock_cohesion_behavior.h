@@ -80,7 +80,46 @@ public:
      */
     void act();
     
+    /**
+     \brief perform behavior for a span of agents
+     \param pAgents agents
+     \param pBehaviors behaviors of equal name and class, one for each agent
+     \param pAgentCount number of agents
+     */
+    void actAll(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount);
+    
+    /**
+     \brief check whether a single instance of the behavior can act on behalf of all agents of a swarm
+     \return true
+     */
+    bool shareable() const;
+    
 protected:
+    /**
+     \brief register parameter and neighbor group pointers that need to be redirected when a worker acts on an agent
+     */
+    void createBindings();
+    
+    /**
+     \brief perform behavior with fixed size vectors
+     \tparam Dim parameter dimension
+     */
+    template<int Dim> void actFixed();
+    
+    /**
+     \brief perform behavior for a span of agents with fixed size vectors
+     \tparam Dim parameter dimension
+     \param pAgents agents
+     \param pBehaviors behaviors of equal name and class, one for each agent
+     \param pAgentCount number of agents
+     */
+    template<int Dim> void actAllFixed(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount);
+    
+    /**
+     \brief perform behavior with dynamically sized vectors
+     */
+    void actDynamic();
+    
     Parameter* mPositionPar; /// \brief position parameter (input)
     Parameter* mForcePar; /// \brief force parameter (output)
     Parameter* mMinDistPar; /// \brief minimum distance parameter (internal)
@@ -90,6 +129,7 @@ protected:
     
     Eigen::VectorXf mAvgDirection; /// \brief avg of neighboring value directions
     Eigen::VectorXf mTmpForce; /// \brief temporary force
+    unsigned int mKernelDim; /// \brief parameter dimension of fixed size kernel (0: dynamic kernel)
 };
 
 };
@@ -9,6 +9,7 @@
 #include "dab_exception.h"
 #include "dab_osc_messenger.h"
 #include "dab_osc_sender.h"
+#include "ofFileUtils.h"
 
 using namespace dab;
 using namespace dab::flock;
@@ -18,6 +19,8 @@ using namespace dab::flock;
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -25,12 +28,17 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mAgentGroupSize(1)
 	, mNormalise(false)
 	, mMaskValues(false)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 }
 
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, const Eigen::VectorXf& pMinParValue, const Eigen::VectorXf& pMaxParValue) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -42,6 +50,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mParValueScale(pMaxParValue - pMinParValue)
 	, mParValueOffset(pMinParValue)
 	, mMaskValues(false)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pMinParValue.rows() != pMaxParValue.rows()) throw Exception("FLOCK ERROR: dim of min value " + std::to_string(pMinParValue.rows()) + " doesn't match dim of max value " + std::to_string(pMaxParValue.rows()), __FILE__, __FUNCTION__, __LINE__);
 
@@ -52,6 +63,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, const std::array<int, 2>& pAgentRange) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -59,6 +72,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mAgentGroupSize(1)
 	, mNormalise(false)
 	, mMaskValues(false)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pAgentRange[1] >= 0 && pAgentRange[0] > pAgentRange[1]) throw Exception("FLOCK ERROR: illegal agent range, min value " + std::to_string(pAgentRange[0]) + " exceeds max value " + std::to_string(pAgentRange[1]), __FILE__, __FUNCTION__, __LINE__);
 }
@@ -66,6 +82,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, const std::array<int, 2>& pAgentRange, const Eigen::VectorXf& pMinParValue, const Eigen::VectorXf& pMaxParValue) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -77,6 +95,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mParValueScale(pMaxParValue - pMinParValue)
 	, mParValueOffset(pMinParValue)
 	, mMaskValues(false)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pAgentRange[1] >= 0 && pAgentRange[0] > pAgentRange[1]) throw Exception("FLOCK ERROR: illegal agent range, min value " + std::to_string(pAgentRange[0]) + " exceeds max value " + std::to_string(pAgentRange[1]), __FILE__, __FUNCTION__, __LINE__);
 	if (pMinParValue.rows() != pMaxParValue.rows()) throw Exception("FLOCK ERROR: dim of min value " + std::to_string(pMinParValue.rows()) + " doesn't match dim of max value " + std::to_string(pMaxParValue.rows()), __FILE__, __FUNCTION__, __LINE__);
@@ -88,6 +109,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, unsigned int pAgentGroupSize)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -95,12 +118,17 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mAgentGroupSize(pAgentGroupSize)
 	, mNormalise(false)
 	, mMaskValues(false)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 }
 
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, unsigned int pAgentGroupSize, const Eigen::VectorXf& pMinParValue, const Eigen::VectorXf& pMaxParValue) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -112,6 +140,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mParValueScale(pMaxParValue - pMinParValue)
 	, mParValueOffset(pMinParValue)
 	, mMaskValues(false)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pMinParValue.rows() != pMaxParValue.rows()) throw Exception("FLOCK ERROR: dim of min value " + std::to_string(pMinParValue.rows()) + " doesn't match dim of max value " + std::to_string(pMaxParValue.rows()), __FILE__, __FUNCTION__, __LINE__);
 
@@ -122,6 +153,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, const std::array<int, 2>& pAgentRange, unsigned int pAgentGroupSize) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -129,6 +162,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mAgentGroupSize(pAgentGroupSize)
 	, mNormalise(false)
 	, mMaskValues(false)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pAgentRange[1] >= 0 && pAgentRange[0] > pAgentRange[1]) throw Exception("FLOCK ERROR: illegal agent range, min value " + std::to_string(pAgentRange[0]) + " exceeds max value " + std::to_string(pAgentRange[1]), __FILE__, __FUNCTION__, __LINE__);
 }
@@ -136,6 +172,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, const std::array<int, 2>& pAgentRange, unsigned int pAgentGroupSize, const Eigen::VectorXf& pMinParValue, const Eigen::VectorXf& pMaxParValue) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -147,6 +185,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mParValueScale(pMaxParValue - pMinParValue)
 	, mParValueOffset(pMinParValue)
 	, mMaskValues(false)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pAgentRange[1] >= 0 && pAgentRange[0] > pAgentRange[1]) throw Exception("FLOCK ERROR: illegal agent range, min value " + std::to_string(pAgentRange[0]) + " exceeds max value " + std::to_string(pAgentRange[1]), __FILE__, __FUNCTION__, __LINE__);
 	if (pMinParValue.rows() != pMaxParValue.rows()) throw Exception("FLOCK ERROR: dim of min value " + std::to_string(pMinParValue.rows()) + " doesn't match dim of max value " + std::to_string(pMaxParValue.rows()), __FILE__, __FUNCTION__, __LINE__);
@@ -158,6 +199,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, const std::vector<bool>& pParValueMask)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -166,12 +209,17 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mNormalise(false)
 	, mMaskValues(true)
 	, mParValueMask(pParValueMask)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 }
 
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, const Eigen::VectorXf& pMinParValue, const Eigen::VectorXf& pMaxParValue, const std::vector<bool>& pParValueMask) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -184,6 +232,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mParValueOffset(pMinParValue)
 	, mMaskValues(true)
 	, mParValueMask(pParValueMask)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pMinParValue.rows() != pMaxParValue.rows()) throw Exception("FLOCK ERROR: dim of min value " + std::to_string(pMinParValue.rows()) + " doesn't match dim of max value " + std::to_string(pMaxParValue.rows()), __FILE__, __FUNCTION__, __LINE__);
 	if (pMinParValue.rows() != mParValueMask.size()) throw Exception("FLOCK ERROR: dim of min value " + std::to_string(pMinParValue.rows()) + " doesn't match dim of mask value " + std::to_string(pParValueMask.size()), __FILE__, __FUNCTION__, __LINE__);
@@ -195,6 +246,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, const std::array<int, 2>& pAgentRange, const std::vector<bool>& pParValueMask) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -203,6 +256,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mNormalise(false)
 	, mMaskValues(true)
 	, mParValueMask(pParValueMask)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pAgentRange[1] >= 0 && pAgentRange[0] > pAgentRange[1]) throw Exception("FLOCK ERROR: illegal agent range, min value " + std::to_string(pAgentRange[0]) + " exceeds max value " + std::to_string(pAgentRange[1]), __FILE__, __FUNCTION__, __LINE__);
 }
@@ -210,6 +266,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, const std::array<int, 2>& pAgentRange, const Eigen::VectorXf& pMinParValue, const Eigen::VectorXf& pMaxParValue, const std::vector<bool>& pParValueMask) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -222,6 +280,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mParValueOffset(pMinParValue)
 	, mMaskValues(true)
 	, mParValueMask(pParValueMask)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pAgentRange[1] >= 0 && pAgentRange[0] > pAgentRange[1]) throw Exception("FLOCK ERROR: illegal agent range, min value " + std::to_string(pAgentRange[0]) + " exceeds max value " + std::to_string(pAgentRange[1]), __FILE__, __FUNCTION__, __LINE__);
 	if (pMinParValue.rows() != pMaxParValue.rows()) throw Exception("FLOCK ERROR: dim of min value " + std::to_string(pMinParValue.rows()) + " doesn't match dim of max value " + std::to_string(pMaxParValue.rows()), __FILE__, __FUNCTION__, __LINE__);
@@ -234,6 +295,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, unsigned int pAgentGroupSize, const std::vector<bool>& pParValueMask)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -242,11 +305,16 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mNormalise(false)
 	, mMaskValues(true)
 	, mParValueMask(pParValueMask)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {}
 
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, unsigned int pAgentGroupSize, const Eigen::VectorXf& pMinParValue, const Eigen::VectorXf& pMaxParValue, const std::vector<bool>& pParValueMask) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -259,6 +327,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mParValueOffset(pMinParValue)
 	, mMaskValues(true)
 	, mParValueMask(pParValueMask)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pMinParValue.rows() != pMaxParValue.rows()) throw Exception("FLOCK ERROR: dim of min value " + std::to_string(pMinParValue.rows()) + " doesn't match dim of max value " + std::to_string(pMaxParValue.rows()), __FILE__, __FUNCTION__, __LINE__);
 	if (pMinParValue.rows() != mParValueMask.size()) throw Exception("FLOCK ERROR: dim of min value " + std::to_string(pMinParValue.rows()) + " doesn't match dim of mask value " + std::to_string(pParValueMask.size()), __FILE__, __FUNCTION__, __LINE__);
@@ -270,6 +341,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, const std::array<int, 2>& pAgentRange, unsigned int pAgentGroupSize, const std::vector<bool>& pParValueMask) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -278,6 +351,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mNormalise(false)
 	, mMaskValues(true)
 	, mParValueMask(pParValueMask)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pAgentRange[1] >= 0 && pAgentRange[0] > pAgentRange[1]) throw Exception("FLOCK ERROR: illegal agent range, min value " + std::to_string(pAgentRange[0]) + " exceeds max value " + std::to_string(pAgentRange[1]), __FILE__, __FUNCTION__, __LINE__);
 }
@@ -285,6 +361,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, const std::string& pParameterName, const std::string& pSenderName, unsigned int pSendInterval, const std::array<int, 2>& pAgentRange, unsigned int pAgentGroupSize, const Eigen::VectorXf& pMinParValue, const Eigen::VectorXf& pMaxParValue, const std::vector<bool>& pParValueMask) throw (Exception)
 	: mSwarmName(pSwarmName)
 	, mParameterName(pParameterName)
+	, mSwarmSymbol(pSwarmName)
+	, mParameterSymbol(pParameterName)
 	, mSenderName(pSenderName)
 	, mSendInterval(pSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -297,6 +375,9 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 	, mParValueOffset(pMinParValue)
 	, mMaskValues(true)
 	, mParValueMask(pParValueMask)
+	, mPackValues(false)
+	, mPackFormat(ValuePacker::Float32Format)
+	, mPackSequence(0)
 {
 	if (pAgentRange[1] >= 0 && pAgentRange[0] > pAgentRange[1]) throw Exception("FLOCK ERROR: illegal agent range, min value " + std::to_string(pAgentRange[0]) + " exceeds max value " + std::to_string(pAgentRange[1]), __FILE__, __FUNCTION__, __LINE__);
 	if (pMinParValue.rows() != pMaxParValue.rows()) throw Exception("FLOCK ERROR: dim of min value " + std::to_string(pMinParValue.rows()) + " doesn't match dim of max value " + std::to_string(pMaxParValue.rows()), __FILE__, __FUNCTION__, __LINE__);
@@ -310,6 +391,8 @@ ParameterRegistration::ParameterRegistration(const std::string& pSwarmName, cons
 ParameterRegistration::ParameterRegistration(const ParameterRegistration& pRegistration)
 	: mSwarmName(pRegistration.mSwarmName)
 	, mParameterName(pRegistration.mParameterName)
+	, mSwarmSymbol(pRegistration.mSwarmSymbol)
+	, mParameterSymbol(pRegistration.mParameterSymbol)
 	, mSenderName(pRegistration.mSenderName)
 	, mSendInterval(pRegistration.mSendInterval)
 	, mCurrentSendInterval(mSendInterval)
@@ -322,12 +405,25 @@ ParameterRegistration::ParameterRegistration(const ParameterRegistration& pRegis
 	, mParValueOffset(pRegistration.mParValueOffset)
 	, mMaskValues(pRegistration.mMaskValues)
 	, mParValueMask(pRegistration.mParValueMask)
+	, mPackValues(pRegistration.mPackValues)
+	, mPackFormat(pRegistration.mPackFormat)
+	, mPackSequence(0)
 {
 }
 
 ParameterRegistration::~ParameterRegistration()
 {}
 
+ParameterRegistration::Cache::Cache()
+	: mValid(false)
+	, mStructureVersion(0)
+	, mAgentRange({ { -1, -1 } })
+	, mAgentGroupSize(0)
+	, mPackValues(false)
+	, mSwarmParameter(false)
+	, mAgentOffset(0)
+{}
+
 void
 ParameterRegistration::set(unsigned int pSendInterval)
 {
@@ -612,6 +708,18 @@ ParameterRegistration::parameterName() const
 	return mParameterName;
 }
 
+const Symbol&
+ParameterRegistration::swarmSymbol() const
+{
+	return mSwarmSymbol;
+}
+
+const Symbol&
+ParameterRegistration::parameterSymbol() const
+{
+	return mParameterSymbol;
+}
+
 const std::string&
 ParameterRegistration::senderName() const
 {
@@ -684,10 +792,31 @@ ParameterRegistration::parValueMask() const
 	return mParValueMask;
 }
 
+bool
+ParameterRegistration::packValues() const
+{
+	return mPackValues;
+}
+
+ValuePacker::Format
+ParameterRegistration::packFormat() const
+{
+	return mPackFormat;
+}
+
+void
+ParameterRegistration::setPacking(bool pPackValues, ValuePacker::Format pFormat) throw (Exception)
+{
+	if (pPackValues == true && pFormat == ValuePacker::Int16Format && mNormalise == false) throw Exception("FLOCK ERROR: int16 packing requires min and max parameter values", __FILE__, __FUNCTION__, __LINE__);
+
+	mPackValues = pPackValues;
+	mPackFormat = pFormat;
+}
+
 bool
 ParameterRegistration::operator==(const ParameterRegistration& pRegistration) const
 {
-	return match(pRegistration.mSwarmName, pRegistration.mParameterName);
+	return (mSwarmSymbol == pRegistration.mSwarmSymbol && mParameterSymbol == pRegistration.mParameterSymbol);
 }
 
 bool
@@ -700,6 +829,8 @@ ParameterRegistration::match(const std::string& pSwarmName, const std::string& p
 
 FlockCom::FlockCom()
 	: OscMessenger()
+	, mAsyncOutput(true)
+	, mMaxPacketSize(1472)
 {}
 
 FlockCom::~FlockCom()
@@ -719,6 +850,8 @@ FlockCom::~FlockCom()
 		}
 	}
 
+	mOutput.stop();
+
 	mParameterRegistry.clear();
 	mExtendedOscMode.clear();
 }
@@ -1512,6 +1645,13 @@ FlockCom::deregisterParameter(const std::string& pSenderName, const std::string&
 void
 FlockCom::update() throw (dab::Exception)
 {
+	if (mOscControl != nullptr) mOscControl->update();
+
+	if (mAsyncOutput == true && mOutput.running() == false) mOutput.start();
+	else if (mAsyncOutput == false && mOutput.running() == true) mOutput.stop();
+
+	if (mOutput.running() == true) mOutput.beginFrame();
+
 	try
 	{
 		send();
@@ -1520,6 +1660,34 @@ FlockCom::update() throw (dab::Exception)
 	{
 		std::cout << e << "\n";
 	}
+
+	if (mOutput.filling() == true) mOutput.endFrame();
+}
+
+bool
+FlockCom::asyncOutput() const
+{
+	return mAsyncOutput;
+}
+
+void
+FlockCom::setAsyncOutput(bool pAsyncOutput)
+{
+	mAsyncOutput = pAsyncOutput;
+}
+
+OscOutput&
+FlockCom::output()
+{
+	return mOutput;
+}
+
+void
+FlockCom::sendMessage(const std::string& pSenderName, std::shared_ptr<OscMessage> pMessage) throw (dab::Exception)
+{
+	std::lock_guard<std::mutex> lock(mOutput.sendLock());
+
+	OscMessenger::send(pSenderName, pMessage);
 }
 
 void
@@ -1527,14 +1695,13 @@ FlockCom::send() throw (dab::Exception)
 {
 	try
 	{
-		std::vector< std::shared_ptr<OscSender> > _senders = mSenders.values();
-
-		unsigned int sndCount = _senders.size();
+		// senders are accessed in place, copying them would allocate every step
+		unsigned int sndCount = mSenders.size();
 		std::shared_ptr<OscSender> _sender;
 
 		for (unsigned int sI = 0; sI<sndCount; ++sI)
 		{
-			_sender = _senders[sI];
+			_sender = mSenders[sI];
 
 			if (mParameterRegistry[_sender].size() > 0)
 			{
@@ -1640,53 +1807,113 @@ FlockCom::sendMessage(std::shared_ptr<OscSender> pSender, ParameterRegistration*
 
 	try
 	{
-		const std::string& swarmName = pRegistration->swarmName();
-		const std::string& parameterName = pRegistration->parameterName();
+		updateRegistrationCache(pRegistration);
+
+		const ParameterRegistration::Cache& cache = pRegistration->mCache;
+		const std::vector<std::string>& addresses = *cache.mAddresses;
 
-		Swarm* swarm = Simulation::get().swarm(swarmName);
+		if (mOutput.filling() == true)
+		{
+			addFrameValues(pSender, pRegistration, pExtendedOscMode);
+		}
+		else if (cache.mPackValues == true)
+		{
+			sendPackedMessage(pSender, pRegistration);
+		}
+		else if (cache.mSwarmParameter == true)
+		{
+			sendMessage(pSender, pRegistration, addresses[0], cache.mParameterGroups[0][0], pExtendedOscMode);
+		}
+		else
+		{
+			unsigned int groupCount = addresses.size();
+
+			for (unsigned int gI = 0; gI < groupCount; ++gI)
+			{
+				sendMessage(pSender, pRegistration, addresses[gI], cache.mParameterGroups[gI], pExtendedOscMode);
+			}
+		}
+	}
+	catch (dab::Exception& e)
+	{
+		e += dab::Exception("COM ERROR: failed to send message", __FILE__, __FUNCTION__, __LINE__);
+		throw e;
+	}
+}
+
+void
+FlockCom::updateRegistrationCache(ParameterRegistration* pRegistration) throw (Exception)
+{
+	ParameterRegistration::Cache& cache = pRegistration->mCache;
+	unsigned long structureVersion = Simulation::get().structureVersion();
+
+	if (cache.mValid == true && cache.mStructureVersion == structureVersion && cache.mAgentRange == pRegistration->agentRange() && cache.mAgentGroupSize == pRegistration->agentGroupSize() && cache.mPackValues == pRegistration->packValues()) return;
+
+	cache.mValid = false;
+	cache.mAddresses.reset(new std::vector<std::string>());
+	cache.mParameterGroups.clear();
+
+	const std::string& swarmName = pRegistration->swarmName();
+	const std::string& parameterName = pRegistration->parameterName();
+
+	try
+	{
+		Swarm* swarm = Simulation::get().swarm(pRegistration->swarmSymbol());
 
 		if (swarm->checkSwarmParameter(parameterName) == true)
 		{
-			sendMessage(pSender, pRegistration, std::string("/" + swarmName + "/" + parameterName), swarm->swarmParameter(parameterName), pExtendedOscMode);
+			cache.mSwarmParameter = true;
+			cache.mAgentOffset = 0;
+			cache.mAddresses->push_back("/" + swarmName + "/" + parameterName);
+			cache.mParameterGroups.push_back(std::vector<Parameter*>(1, swarm->swarmParameter(parameterName)));
 		}
-		else if (swarm->checkParameter(parameterName) == true)
+		else if (swarm->checkParameter(pRegistration->parameterSymbol()) == true)
 		{
-			unsigned int parameterIndex = swarm->parameterIndex(parameterName);
+			cache.mSwarmParameter = false;
+
+			unsigned int parameterIndex = swarm->parameterIndex(pRegistration->parameterSymbol());
 			std::array<int, 2> agentRange = pRegistration->agentRange();
 
 			std::vector<Agent*>& agents = swarm->agents();
 			int agentCount = agents.size();
 
 			if (agentRange[0] < 0) agentRange[0] = 0;
-			else if (agentRange[0] >= agentCount) return;
+			else if (agentRange[0] >= agentCount) agentRange[0] = agentCount;
 			if (agentRange[1] < 0 || agentRange[1] >= agentCount) agentRange[1] = agentCount;
 
-			int agentGroupSize = pRegistration->agentGroupSize();
+			cache.mAgentOffset = agentRange[0];
 
-			//			std::cout << "agentGroupSize " << agentGroupSize << "\n";
-			//            std::cout << "ar0 " << agentRange[0] << " ar1 " << agentRange[1] << "\n";
+			// packed registrations send all agents of the range in a single group
+			bool packValues = pRegistration->packValues();
+			int agentGroupSize = packValues == true ? std::max(agentRange[1] - agentRange[0], 1) : pRegistration->agentGroupSize();
+			std::string addressPrefix = "/" + swarmName + "/";
+			std::string addressSuffix = "/" + parameterName;
 
 			for (int aI = agentRange[0]; aI < agentRange[1]; )
 			{
 				int startAI = aI;
 				int parameterCount = std::min(agentGroupSize, agentRange[1] - aI);
-				std::vector<Parameter*> _parameters(parameterCount);
+
+				cache.mParameterGroups.push_back(std::vector<Parameter*>(parameterCount));
+				std::vector<Parameter*>& _parameters = cache.mParameterGroups.back();
 
 				for (int i = 0; i<parameterCount; ++i, ++aI)
 				{
-					//std::cout << "aI " << aI << " i " << i << " par " << agents[aI]->parameter( parameterIndex ) << "\n";
-
 					_parameters[i] = agents[aI]->parameter(parameterIndex);
 				}
 
-				if (agentGroupSize > 1)
+				if (packValues == true)
+				{
+					cache.mAddresses->push_back("/" + swarmName + addressSuffix);
+				}
+				else if (agentGroupSize > 1)
 				{
 					int endAI = aI - 1;
-					sendMessage(pSender, pRegistration, std::string("/" + swarmName + "/" + std::to_string(startAI) + "/" + std::to_string(endAI) + "/" + parameterName), _parameters, pExtendedOscMode);
+					cache.mAddresses->push_back(addressPrefix + std::to_string(startAI) + "/" + std::to_string(endAI) + addressSuffix);
 				}
 				else
 				{
-					sendMessage(pSender, pRegistration, std::string("/" + swarmName + "/" + std::to_string(startAI) + "/" + parameterName), _parameters, pExtendedOscMode);
+					cache.mAddresses->push_back(addressPrefix + std::to_string(startAI) + addressSuffix);
 				}
 			}
 		}
@@ -1697,19 +1924,28 @@ FlockCom::sendMessage(std::shared_ptr<OscSender> pSender, ParameterRegistration*
 	}
 	catch (dab::Exception& e)
 	{
-		e += dab::Exception("COM ERROR: failed to send message", __FILE__, __FUNCTION__, __LINE__);
+		cache.mAddresses->clear();
+		cache.mParameterGroups.clear();
+
+		e += dab::Exception("COM ERROR: failed to resolve registration of parameter " + parameterName + " for swarm " + swarmName, __FILE__, __FUNCTION__, __LINE__);
 		throw e;
 	}
+
+	cache.mStructureVersion = structureVersion;
+	cache.mAgentRange = pRegistration->agentRange();
+	cache.mAgentGroupSize = pRegistration->agentGroupSize();
+	cache.mPackValues = pRegistration->packValues();
+	cache.mValid = true;
 }
 
 void
-FlockCom::sendMessage(std::shared_ptr<OscSender> pSender, ParameterRegistration* pRegistration, const std::string& pAddress, std::vector<Parameter*> pParameters, bool pExtendedOscMode) throw (Exception)
+FlockCom::sendMessage(std::shared_ptr<OscSender> pSender, ParameterRegistration* pRegistration, const std::string& pAddress, const std::vector<Parameter*>& pParameters, bool pExtendedOscMode) throw (Exception)
 {
 	//std::cout << "sendMessage sender " << pSender->name() << " address " << pAddress << "\n";
 
 	try
 	{
-		std::shared_ptr<OscMessage> message(new OscMessage());
+		std::shared_ptr<OscMessage> message = std::make_shared<OscMessage>();
 		message->setAddress(pAddress);
 		addMessageParameter(message, pRegistration, pParameters, pExtendedOscMode);
 
@@ -1731,7 +1967,7 @@ FlockCom::sendMessage(std::shared_ptr<OscSender> pSender, ParameterRegistration*
 
 	try
 	{
-		std::shared_ptr<OscMessage> message(new OscMessage());
+		std::shared_ptr<OscMessage> message = std::make_shared<OscMessage>();
 		message->setAddress(pAddress);
 
 		addMessageParameter(message, pRegistration, pParameter, pExtendedOscMode);
@@ -1747,7 +1983,7 @@ FlockCom::sendMessage(std::shared_ptr<OscSender> pSender, ParameterRegistration*
 }
 
 void
-FlockCom::addMessageParameter(std::shared_ptr<OscMessage> pMessage, ParameterRegistration* pRegistration, std::vector<Parameter*> pParameters, bool pExtendedOscMode) throw (Exception)
+FlockCom::addMessageParameter(std::shared_ptr<OscMessage> pMessage, ParameterRegistration* pRegistration, const std::vector<Parameter*>& pParameters, bool pExtendedOscMode) throw (Exception)
 {
 	try
 	{
@@ -1935,6 +2171,160 @@ FlockCom::addMessageParameter(std::shared_ptr<OscMessage> pMessage, ParameterReg
 	}
 }
 
+void
+FlockCom::addFrameValues(std::shared_ptr<OscSender> pSender, ParameterRegistration* pRegistration, bool pExtendedOscMode) throw (Exception)
+{
+	const ParameterRegistration::Cache& cache = pRegistration->mCache;
+	const std::vector< std::vector<Parameter*> >& parameterGroups = cache.mParameterGroups;
+
+	unsigned int groupCount = parameterGroups.size();
+	if (groupCount == 0) return;
+
+	unsigned int sendDim = sendValueDim(pRegistration);
+
+	unsigned int parameterCount = 0;
+	for (unsigned int gI = 0; gI < groupCount; ++gI) parameterCount += parameterGroups[gI].size();
+
+	float* values;
+
+	if (cache.mPackValues == true)
+	{
+		values = mOutput.addPackedValues(pSender, cache.mAddresses, pRegistration->mPackFormat, pRegistration->mPackSequence++, cache.mAgentOffset, parameterCount, sendDim, maxBlobSize((*cache.mAddresses)[0]));
+	}
+	else
+	{
+		unsigned int groupSize = cache.mSwarmParameter == true ? 1 : pRegistration->agentGroupSize();
+		values = mOutput.addValues(pSender, cache.mAddresses, pExtendedOscMode, parameterCount, groupSize, sendDim);
+	}
+
+	writeSendValues(pRegistration, values);
+}
+
+void
+FlockCom::sendPackedMessage(std::shared_ptr<OscSender> pSender, ParameterRegistration* pRegistration) throw (Exception)
+{
+	const ParameterRegistration::Cache& cache = pRegistration->mCache;
+	if (cache.mParameterGroups.size() == 0) return;
+
+	const std::string& address = (*cache.mAddresses)[0];
+	unsigned int sendDim = sendValueDim(pRegistration);
+	unsigned int parameterCount = cache.mParameterGroups[0].size();
+
+	mPackBuffer.resize(parameterCount * sendDim);
+	writeSendValues(pRegistration, mPackBuffer.data());
+
+	mPacker.pack(pRegistration->mPackFormat, pRegistration->mPackSequence++, cache.mAgentOffset, parameterCount, sendDim, mPackBuffer.data(), maxBlobSize(address));
+
+	unsigned int blobCount = mPacker.blobCount();
+	for (unsigned int bI = 0; bI < blobCount; ++bI)
+	{
+		const std::vector<char>& blob = mPacker.blob(bI);
+
+		std::shared_ptr<OscMessage> message = std::make_shared<OscMessage>();
+		message->setAddress(address);
+		message->add(ofBuffer(blob.data(), blob.size()));
+
+		pSender->send(message);
+	}
+}
+
+unsigned int
+FlockCom::sendValueDim(ParameterRegistration* pRegistration) throw (Exception)
+{
+	unsigned int parDim = pRegistration->mCache.mParameterGroups[0][0]->values().rows();
+	const Eigen::VectorXf& parValueScale = pRegistration->parValueScale();
+
+	if (pRegistration->normalise() == true && parDim != parValueScale.rows()) throw dab::Exception("COM ERROR: value scale dimension (" + std::to_string(parValueScale.rows()) + ") does not match parameter dimension (" + std::to_string(parDim) + ")", __FILE__, __FUNCTION__, __LINE__);
+	if (pRegistration->mCache.mPackValues == true && pRegistration->mPackFormat == ValuePacker::Int16Format && pRegistration->normalise() == false) throw dab::Exception("COM ERROR: int16 packing requires min and max parameter values", __FILE__, __FUNCTION__, __LINE__);
+
+	if (pRegistration->maskValues() == false) return parDim;
+
+	const std::vector<bool>& parValueMask = pRegistration->parValueMask();
+	unsigned int sendDim = 0;
+	for (unsigned int d = 0; d<parDim; ++d) if (parValueMask[d] == true) sendDim++;
+
+	return sendDim;
+}
+
+void
+FlockCom::writeSendValues(ParameterRegistration* pRegistration, float* pValues)
+{
+	const std::vector< std::vector<Parameter*> >& parameterGroups = pRegistration->mCache.mParameterGroups;
+	unsigned int groupCount = parameterGroups.size();
+
+	unsigned int parDim = parameterGroups[0][0]->values().rows();
+	bool normalise = pRegistration->normalise();
+	bool maskValues = pRegistration->maskValues();
+	const std::vector<bool>& parValueMask = pRegistration->parValueMask();
+	const Eigen::VectorXf& parValueScale = pRegistration->parValueScale();
+	const Eigen::VectorXf& parValueOffset = pRegistration->parValueOffset();
+	float parSendValue;
+
+	for (unsigned int gI = 0, i = 0; gI < groupCount; ++gI)
+	{
+		const std::vector<Parameter*>& parameters = parameterGroups[gI];
+		unsigned int groupParameterCount = parameters.size();
+
+		for (unsigned int pI = 0; pI < groupParameterCount; ++pI)
+		{
+			const Eigen::VectorXf& parValues = parameters[pI]->values();
+
+			for (unsigned int d = 0; d<parDim; ++d)
+			{
+				if (maskValues == true && parValueMask[d] == false) continue;
+
+				parSendValue = parValues[d];
+
+				if (normalise == true)
+				{
+					parSendValue = (parSendValue - parValueOffset[d]) * parValueScale[d];
+					parSendValue = std::max(std::min(parSendValue, 1.0f), 0.0f);
+				}
+
+				pValues[i++] = parSendValue;
+			}
+		}
+	}
+}
+
+unsigned int
+FlockCom::maxBlobSize(const std::string& pAddress) const
+{
+	// osc overhead: padded address, type tag ",b" and blob size
+	unsigned int overhead = (pAddress.size() / 4 + 1) * 4 + 4 + 4;
+
+	if (mMaxPacketSize <= overhead) return 0;
+
+	return ((mMaxPacketSize - overhead) / 4) * 4;
+}
+
+unsigned int
+FlockCom::maxPacketSize() const
+{
+	return mMaxPacketSize;
+}
+
+void
+FlockCom::setMaxPacketSize(unsigned int pMaxPacketSize)
+{
+	mMaxPacketSize = pMaxPacketSize;
+}
+
+void
+FlockCom::setParameterPacking(const std::string& pSenderName, const std::string& pSwarmName, const std::string& pParameterName, bool pPackValues, ValuePacker::Format pFormat) throw (Exception)
+{
+	try
+	{
+		ParameterRegistration* registration = parameterRegistration(sender(pSenderName), pSwarmName, pParameterName);
+		registration->setPacking(pPackValues, pFormat);
+	}
+	catch (Exception& e)
+	{
+		e += Exception("FLOCK ERROR: failed to set packing of parameter " + pParameterName + " of swarm " + pSwarmName, __FILE__, __FUNCTION__, __LINE__);
+		throw e;
+	}
+}
+
 void
 FlockCom::addMessageParameter(std::shared_ptr<OscMessage> pMessage, ParameterRegistration* pRegistration, Parameter* pParameter, bool pExtendedOscMode) throw (dab::Exception)
 {
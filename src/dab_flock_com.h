@@ -16,6 +16,9 @@
 #include "dab_singleton.h"
 #include "dab_index_map.h"
 #include "dab_osc_messenger.h"
+#include "dab_flock_osc_output.h"
+#include "dab_flock_value_packer.h"
+#include "dab_flock_symbol.h"
 
 namespace dab
 {
@@ -74,6 +77,8 @@ namespace dab
 
 			const std::string& swarmName() const;
 			const std::string& parameterName() const;
+			const Symbol& swarmSymbol() const;
+			const Symbol& parameterSymbol() const;
 			const std::string& senderName() const;
 			unsigned int sendInterval() const;
 			unsigned int& currentSendInterval();
@@ -86,13 +91,51 @@ namespace dab
 			const Eigen::VectorXf& parValueOffset() const;
 			const std::vector<bool>& parValueMask() const;
 			bool maskValues() const;
+			bool packValues() const;
+			ValuePacker::Format packFormat() const;
+
+			/**
+			\brief send all values of the registered agent range in packed blobs instead of one message per agent group
+			\param pPackValues pack values
+			\param pFormat value format
+			\exception Exception int16 format requires normalised values
+			*/
+			void setPacking(bool pPackValues, ValuePacker::Format pFormat) throw (Exception);
 
 			bool operator==(const ParameterRegistration& pRegistration) const;
 			bool match(const std::string& pSwarmName, const std::string& pParameterName) const;
 
 		protected:
+			friend class FlockCom;
+
+			/**
+			\brief parameters and osc addresses resolved from the registration
+
+			the cache is rebuilt when the structure of the simulation (agents or parameters) or the agent range, group size or packing of the registration change\n
+			packed registrations have a single group containing all parameters
+			*/
+			class Cache
+			{
+			public:
+				Cache();
+
+				bool mValid; /// \brief cache has been built
+				unsigned long mStructureVersion; /// \brief simulation structure version the cache has been built for
+				std::array<int, 2> mAgentRange; /// \brief agent range the cache has been built for
+				unsigned int mAgentGroupSize; /// \brief agent group size the cache has been built for
+				bool mPackValues; /// \brief packing the cache has been built for
+				bool mSwarmParameter; /// \brief registered parameter is a swarm parameter
+				std::shared_ptr< std::vector<std::string> > mAddresses; /// \brief osc address per agent group (reallocated on rebuild since queued output frames keep referring to it)
+				std::vector< std::vector<Parameter*> > mParameterGroups; /// \brief parameters per agent group
+				unsigned int mAgentOffset; /// \brief index of first agent
+			};
+
+			Cache mCache; /// \brief resolved parameters and osc addresses
+
 			std::string mSwarmName;
 			std::string mParameterName;
+			Symbol mSwarmSymbol;
+			Symbol mParameterSymbol;
 			std::string mSenderName;
 			std::array<int, 2> mAgentRange;
 			unsigned int mAgentGroupSize;
@@ -105,6 +148,9 @@ namespace dab
 			std::vector<bool> mParValueMask;
 			unsigned int mSendInterval;
 			unsigned int mCurrentSendInterval;
+			bool mPackValues; /// \brief send values in packed blobs
+			ValuePacker::Format mPackFormat; /// \brief format of packed values
+			unsigned int mPackSequence; /// \brief sequence number of next packed send
 		};
 
 #pragma mark flock messenger
@@ -398,13 +444,66 @@ namespace dab
 			*/
 			void deregisterParameter(const std::string& pSenderName, const std::string& pSwarmName, const std::string& pParameterName) throw (Exception);
 
+			/**
+			\brief send all values of a registered parameter in packed blobs instead of one message per agent group
+			\param pSenderName name of sender
+			\param pSwarmName name of swarm
+			\param pParameterName name of parameter
+			\param pPackValues pack values
+			\param pFormat value format (int16 requires min and max parameter values)
+			\exception Exception parameter not registered or int16 format without min and max parameter values
+			*/
+			void setParameterPacking(const std::string& pSenderName, const std::string& pSwarmName, const std::string& pParameterName, bool pPackValues, ValuePacker::Format pFormat = ValuePacker::Float32Format) throw (Exception);
+
+			/**
+			\brief return maximum size of osc packets containing packed values
+			\return maximum packet size in bytes
+			*/
+			unsigned int maxPacketSize() const;
+
+			/**
+			\brief set maximum size of osc packets containing packed values
+			\param pMaxPacketSize maximum packet size in bytes (default: 1472, the udp payload of an ethernet MTU)
+			*/
+			void setMaxPacketSize(unsigned int pMaxPacketSize);
+
 
 			/**
-			\brief update messenger
+			\brief update messenger, executes queued control commands and sends registered parameters
 			\Exception Exception failed to update messenger
 			*/
 			virtual void update() throw (Exception);
 
+			/**
+			\brief return whether parameter messages are sent by a separate sender thread
+			\return true if output is asynchronous
+			*/
+			bool asyncOutput() const;
+
+			/**
+			\brief set whether parameter messages are sent by a separate sender thread
+			\param pAsyncOutput output is asynchronous
+
+			the sender thread is started or stopped during the next update
+			*/
+			void setAsyncOutput(bool pAsyncOutput);
+
+			/**
+			\brief return asynchronous output stage
+			\return output stage (for queue settings and frame counters)
+			*/
+			OscOutput& output();
+
+			/**
+			\brief send message with a named sender
+			\param pSenderName sender name
+			\param pMessage osc message
+			\exception Exception failed to send message
+
+			used for error, profiler and save messages, the message is sent while holding the send lock of the output stage since its sender thread might use the same sender
+			*/
+			void sendMessage(const std::string& pSenderName, std::shared_ptr<OscMessage> pMessage) throw (Exception);
+
 		protected:
 			std::shared_ptr<OscReceiver> mControlReceiver;
 			std::shared_ptr<OscSender> mErrorSender;
@@ -415,6 +514,13 @@ namespace dab
 
 			double mTime;
 
+			bool mAsyncOutput; /// \brief parameter messages are sent by the sender thread of mOutput
+			OscOutput mOutput; /// \brief asynchronous output stage
+
+			unsigned int mMaxPacketSize; /// \brief maximum size of osc packets containing packed values
+			ValuePacker mPacker; /// \brief packer for synchronous output
+			std::vector<float> mPackBuffer; /// \brief send values for synchronous packed output
+
 
 			/**
 			\brief default constructor
@@ -469,11 +575,57 @@ namespace dab
 			*/
 			void sendMessage(std::shared_ptr<OscSender> pSender, ParameterRegistration* pRegistration, const std::string& pAddress, Parameter* pParameter, bool pExtendedOscMode) throw (Exception);
 
-			void sendMessage(std::shared_ptr<OscSender> pSender, ParameterRegistration* pRegistration, const std::string& pAddress, std::vector<Parameter*> pParameters, bool pExtendedOscMode) throw (Exception);
+			void sendMessage(std::shared_ptr<OscSender> pSender, ParameterRegistration* pRegistration, const std::string& pAddress, const std::vector<Parameter*>& pParameters, bool pExtendedOscMode) throw (Exception);
 
 			void addMessageParameter(std::shared_ptr<OscMessage> pMessage, ParameterRegistration* pRegistration, Parameter* pParameter, bool pExtendedOscMode) throw (Exception);
 
-			void addMessageParameter(std::shared_ptr<OscMessage> pMessage, ParameterRegistration* pRegistration, std::vector<Parameter*> pParameters, bool pExtendedOscMode) throw (Exception);
+			void addMessageParameter(std::shared_ptr<OscMessage> pMessage, ParameterRegistration* pRegistration, const std::vector<Parameter*>& pParameters, bool pExtendedOscMode) throw (Exception);
+
+			/**
+			\brief write send values of registered parameters into the current frame of the asynchronous output stage
+			\param pSender sender
+			\param pRegistration parameter registration (with valid cache)
+			\param pExtendedOscMode use extended osc protocol
+			\exception Exception value scale dimension does not match parameter dimension
+			*/
+			void addFrameValues(std::shared_ptr<OscSender> pSender, ParameterRegistration* pRegistration, bool pExtendedOscMode) throw (Exception);
+
+			/**
+			\brief send values of registered parameters in packed blobs
+			\param pSender sender
+			\param pRegistration parameter registration (with valid cache)
+			\exception Exception failed to pack or send values
+			*/
+			void sendPackedMessage(std::shared_ptr<OscSender> pSender, ParameterRegistration* pRegistration) throw (Exception);
+
+			/**
+			\brief return number of send values per parameter
+			\param pRegistration parameter registration (with valid cache)
+			\return number of send values per parameter
+			\exception Exception value scale dimension does not match parameter dimension or int16 packing without normalisation
+			*/
+			unsigned int sendValueDim(ParameterRegistration* pRegistration) throw (Exception);
+
+			/**
+			\brief write normalised and masked send values of all cached parameters
+			\param pRegistration parameter registration (with valid cache)
+			\param pValues destination
+			*/
+			void writeSendValues(ParameterRegistration* pRegistration, float* pValues);
+
+			/**
+			\brief return maximum blob size for which an osc packet does not exceed the maximum packet size
+			\param pAddress osc address
+			\return maximum blob size in bytes
+			*/
+			unsigned int maxBlobSize(const std::string& pAddress) const;
+
+			/**
+			\brief resolve swarm, parameters and osc addresses of registration if the cached ones are outdated
+			\param pRegistration parameter registration
+			\exception Exception swarm or parameter not found
+			*/
+			void updateRegistrationCache(ParameterRegistration* pRegistration) throw (Exception);
 
 		};
 
@@ -0,0 +1,249 @@
+/** \file dab_flock_control_command.cpp
+ */
+
+#include "dab_flock_control_command.h"
+
+using namespace dab;
+using namespace dab::flock;
+
+const unsigned int ControlCommand::sArgumentCapacity = 16;
+const unsigned int ControlCommand::sValueCapacity = 64;
+
+ControlArgument::ControlArgument(ControlCommand* pCommand)
+: mCommand(pCommand)
+, mType(OSC_TYPE_NONE)
+, mValueCount(0)
+, mValueOffset(0)
+{}
+
+OscType
+ControlArgument::oscType() const
+{
+	return mType;
+}
+
+unsigned int
+ControlArgument::valueCount() const
+{
+	return mValueCount;
+}
+
+ControlArgument::operator int32_t() const
+{
+	if(mType == OSC_TYPE_INT32 || mType == EXT_TYPE_ARG_INT32_ARRAY) return mCommand->mIntValues[mValueOffset];
+	if(mType == OSC_TYPE_FLOAT || mType == EXT_TYPE_ARG_FLOAT_ARRAY) return static_cast<int32_t>( mCommand->mFloatValues[mValueOffset] );
+	return 0;
+}
+
+ControlArgument::operator float() const
+{
+	if(mType == OSC_TYPE_FLOAT || mType == EXT_TYPE_ARG_FLOAT_ARRAY) return mCommand->mFloatValues[mValueOffset];
+	if(mType == OSC_TYPE_INT32 || mType == EXT_TYPE_ARG_INT32_ARRAY) return static_cast<float>( mCommand->mIntValues[mValueOffset] );
+	return 0.0;
+}
+
+ControlArgument::operator int32_t*() const
+{
+	if(mType == OSC_TYPE_INT32 || mType == EXT_TYPE_ARG_INT32_ARRAY) return mCommand->mIntValues.data() + mValueOffset;
+	return nullptr;
+}
+
+ControlArgument::operator float*() const
+{
+	if(mType == OSC_TYPE_FLOAT || mType == EXT_TYPE_ARG_FLOAT_ARRAY) return mCommand->mFloatValues.data() + mValueOffset;
+	return nullptr;
+}
+
+ControlArgument::operator const std::string&() const
+{
+	return mString;
+}
+
+ControlCommand::ControlCommand()
+: mArgumentCount(0)
+{
+	mArguments.reserve(sArgumentCapacity);
+	mIntValues.reserve(sValueCapacity);
+	mFloatValues.reserve(sValueCapacity);
+}
+
+const std::string&
+ControlCommand::address() const
+{
+	return mAddress;
+}
+
+unsigned int
+ControlCommand::size() const
+{
+	return mArgumentCount;
+}
+
+const ControlArgument*
+ControlCommand::operator[](unsigned int pIndex) const
+{
+	return &( mArguments[pIndex] );
+}
+
+void
+ControlCommand::clear()
+{
+	mAddress.clear();
+	mArgumentCount = 0;
+	mIntValues.clear();
+	mFloatValues.clear();
+}
+
+void
+ControlCommand::parse(const OscMessage& pMessage)
+{
+	clear();
+
+	mAddress = pMessage.address();
+
+	const std::vector<_OscArg*>& arguments = pMessage.arguments();
+	unsigned int argCount = arguments.size();
+
+	if(pMessage.arrayCount() > 0) // message already contains value groups, simply copy them
+	{
+		for(unsigned int aI=0; aI<argCount; ++aI) addArgument(arguments[aI]);
+	}
+	else // group consecutive arguments of the same type
+	{
+		OscType currentType = OSC_TYPE_NONE;
+		unsigned int groupStart = 0;
+		unsigned int groupSize = 0;
+
+		for(unsigned int aI=0; aI<argCount; ++aI)
+		{
+			_OscArg* arg = arguments[aI];
+
+			if(arg->oscType() == currentType && arg->oscType() != OSC_TYPE_STRING)
+			{
+				groupSize++;
+			}
+			else
+			{
+				if(groupSize > 0)
+				{
+					addGroup(arguments, groupStart, groupSize);
+					groupSize = 0;
+				}
+
+				if(arg->oscType() == OSC_TYPE_CHAR)
+				{
+					currentType = OSC_TYPE_NONE;
+				}
+				else if(arg->oscType() == OSC_TYPE_STRING && arg->valueCount() == 1)
+				{
+					currentType = OSC_TYPE_NONE;
+				}
+				else
+				{
+					groupStart = aI;
+					groupSize = 1;
+					currentType = arg->oscType();
+				}
+			}
+		}
+
+		if(groupSize > 0) addGroup(arguments, groupStart, groupSize);
+	}
+}
+
+ControlArgument&
+ControlCommand::addArgument(OscType pType)
+{
+	if(mArgumentCount == mArguments.size()) mArguments.push_back(ControlArgument(this));
+
+	ControlArgument& argument = mArguments[mArgumentCount++];
+	argument.mCommand = this;
+	argument.mType = pType;
+	argument.mValueCount = 0;
+	argument.mValueOffset = 0;
+	argument.mString.clear();
+
+	return argument;
+}
+
+void
+ControlCommand::addArgument(_OscArg* pArgument)
+{
+	OscType type = pArgument->oscType();
+	ControlArgument& argument = addArgument(type);
+	unsigned int valueCount = pArgument->valueCount();
+
+	if(type == OSC_TYPE_STRING)
+	{
+		argument.mString = pArgument->operator const std::string&();
+		argument.mValueCount = valueCount;
+	}
+	else if(type == OSC_TYPE_INT32)
+	{
+		int32_t value = *pArgument;
+		argument.mValueOffset = mIntValues.size();
+		argument.mValueCount = 1;
+		mIntValues.push_back(value);
+	}
+	else if(type == OSC_TYPE_FLOAT)
+	{
+		float value = *pArgument;
+		argument.mValueOffset = mFloatValues.size();
+		argument.mValueCount = 1;
+		mFloatValues.push_back(value);
+	}
+	else if(type == EXT_TYPE_ARG_INT32_ARRAY)
+	{
+		int32_t* values = *pArgument;
+		argument.mValueOffset = mIntValues.size();
+		argument.mValueCount = valueCount;
+		mIntValues.insert(mIntValues.end(), values, values + valueCount);
+	}
+	else if(type == EXT_TYPE_ARG_FLOAT_ARRAY)
+	{
+		float* values = *pArgument;
+		argument.mValueOffset = mFloatValues.size();
+		argument.mValueCount = valueCount;
+		mFloatValues.insert(mFloatValues.end(), values, values + valueCount);
+	}
+	else // types without accessors keep their type only, handlers reject them
+	{
+		argument.mValueCount = valueCount;
+	}
+}
+
+void
+ControlCommand::addGroup(const std::vector<_OscArg*>& pArguments, unsigned int pGroupStart, unsigned int pGroupSize)
+{
+	if(pGroupSize == 1)
+	{
+		addArgument(pArguments[pGroupStart]);
+		return;
+	}
+
+	OscType groupType = pArguments[pGroupStart]->oscType();
+
+	if(groupType == OSC_TYPE_INT32)
+	{
+		ControlArgument& argument = addArgument(EXT_TYPE_ARG_INT32_ARRAY);
+		argument.mValueOffset = mIntValues.size();
+		argument.mValueCount = pGroupSize;
+		for(unsigned int vI=0; vI<pGroupSize; ++vI)
+		{
+			int32_t value = *(pArguments[pGroupStart + vI]);
+			mIntValues.push_back(value);
+		}
+	}
+	else if(groupType == OSC_TYPE_FLOAT)
+	{
+		ControlArgument& argument = addArgument(EXT_TYPE_ARG_FLOAT_ARRAY);
+		argument.mValueOffset = mFloatValues.size();
+		argument.mValueCount = pGroupSize;
+		for(unsigned int vI=0; vI<pGroupSize; ++vI)
+		{
+			float value = *(pArguments[pGroupStart + vI]);
+			mFloatValues.push_back(value);
+		}
+	}
+	// groups of other types are dropped
+}
@@ -0,0 +1,144 @@
+/** \file dab_flock_control_command.h
+ *  \class dab::flock::ControlArgument argument of a preparsed osc control command
+ *  \class dab::flock::ControlCommand preparsed osc control command
+ *  \brief preparsed osc control command
+ *
+ *  OscControl parses each incoming message on the receiving thread into a ControlCommand that lives in a slot of its ControlQueue. The simulation thread executes the command later on.\n
+ *  Consecutive numeric osc arguments of the same type are grouped into arrays, as OscControl always did. Numeric values are stored in value arenas owned by the command, strings in their arguments.\n
+ *  Arenas and arguments keep their capacity when a slot is reused, once the largest message has been seen, parsing does not allocate anymore.\n
+ *  Arguments offer the same accessors as osc arguments (type, value count and conversion operators), so the command handlers of OscControl read them the same way.\n
+ */
+
+#ifndef _dab_flock_control_command_h_
+#define _dab_flock_control_command_h_
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "dab_osc_message.h"
+
+namespace dab
+{
+
+namespace flock
+{
+
+class ControlCommand;
+
+class ControlArgument
+{
+public:
+    /**
+     \brief create argument
+     \param pCommand command that owns the value arenas
+     */
+    ControlArgument(ControlCommand* pCommand);
+
+    /**
+     \brief return argument type
+     \return osc type (EXT_TYPE_ARG_INT32_ARRAY or EXT_TYPE_ARG_FLOAT_ARRAY for grouped values)
+     */
+    OscType oscType() const;
+
+    /**
+     \brief return number of values
+     \return number of values
+     */
+    unsigned int valueCount() const;
+
+    operator int32_t() const;
+    operator float() const;
+    operator int32_t*() const;
+    operator float*() const;
+    operator const std::string&() const;
+
+protected:
+    friend class ControlCommand;
+
+    ControlCommand* mCommand; /// \brief command that owns the value arenas
+    OscType mType; /// \brief osc type
+    unsigned int mValueCount; /// \brief number of values
+    unsigned int mValueOffset; /// \brief offset of first value in the value arena of the type
+    std::string mString; /// \brief string value
+};
+
+class ControlCommand
+{
+public:
+    /**
+     \brief default constructor
+     */
+    ControlCommand();
+
+    /**
+     \brief return osc address
+     \return address (empty if the command has not been parsed)
+     */
+    const std::string& address() const;
+
+    /**
+     \brief return number of arguments
+     \return number of arguments
+     */
+    unsigned int size() const;
+
+    /**
+     \brief return argument
+     \param pIndex argument index
+     \return argument
+     */
+    const ControlArgument* operator[](unsigned int pIndex) const;
+
+    /**
+     \brief parse osc message, replaces previous content
+     \param pMessage osc message
+     */
+    void parse(const OscMessage& pMessage);
+
+    /**
+     \brief remove address and arguments, keeps capacity
+     */
+    void clear();
+
+protected:
+    friend class ControlArgument;
+
+    static const unsigned int sArgumentCapacity; /// \brief number of arguments reserved in advance
+    static const unsigned int sValueCapacity; /// \brief number of values per type reserved in advance
+
+    std::string mAddress; /// \brief osc address
+    std::vector<ControlArgument> mArguments; /// \brief arguments (only the first mArgumentCount are in use)
+    unsigned int mArgumentCount; /// \brief number of arguments in use
+    std::vector<int32_t> mIntValues; /// \brief integer value arena
+    std::vector<float> mFloatValues; /// \brief float value arena
+
+    ControlCommand(const ControlCommand& pCommand);
+    ControlCommand& operator=(const ControlCommand& pCommand);
+
+    /**
+     \brief append argument
+     \param pType osc type
+     \return argument
+     */
+    ControlArgument& addArgument(OscType pType);
+
+    /**
+     \brief append copy of osc argument
+     \param pArgument osc argument
+     */
+    void addArgument(_OscArg* pArgument);
+
+    /**
+     \brief append group of consecutive osc arguments of the same type as one argument
+     \param pArguments osc arguments
+     \param pGroupStart index of first argument of group
+     \param pGroupSize number of arguments in group
+     */
+    void addGroup(const std::vector<_OscArg*>& pArguments, unsigned int pGroupStart, unsigned int pGroupSize);
+};
+
+};
+
+};
+
+#endif
@@ -0,0 +1,121 @@
+/** \file dab_flock_control_queue.cpp
+ */
+
+#include "dab_flock_control_queue.h"
+
+using namespace dab;
+using namespace dab::flock;
+
+ControlQueue::ControlQueue(unsigned int pCapacity)
+: mEnqueuePosition(0)
+, mDequeuePosition(0)
+, mPushedCount(0)
+, mDroppedCount(0)
+, mMaxSize(0)
+{
+	size_t capacity = 2;
+	while(capacity < pCapacity) capacity *= 2;
+
+	mSlots = std::vector<Slot>(capacity);
+	mMask = capacity - 1;
+
+	for(size_t sI=0; sI<capacity; ++sI) mSlots[sI].mSequence.store(sI, std::memory_order_relaxed);
+}
+
+unsigned int
+ControlQueue::capacity() const
+{
+	return mSlots.size();
+}
+
+unsigned int
+ControlQueue::size() const
+{
+	return mEnqueuePosition.load(std::memory_order_relaxed) - mDequeuePosition.load(std::memory_order_relaxed);
+}
+
+bool
+ControlQueue::push(const OscMessage& pMessage)
+{
+	size_t position = mEnqueuePosition.load(std::memory_order_relaxed);
+	Slot* slot;
+
+	while(true)
+	{
+		slot = &( mSlots[position & mMask] );
+		size_t sequence = slot->mSequence.load(std::memory_order_acquire);
+		intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+		if(difference == 0)
+		{
+			if(mEnqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed) == true) break;
+		}
+		else if(difference < 0) // slot has not been consumed yet, queue is full
+		{
+			mDroppedCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else // slot has been claimed by another producer
+		{
+			position = mEnqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->mCommand.parse(pMessage);
+	slot->mSequence.store(position + 1, std::memory_order_release);
+
+	mPushedCount.fetch_add(1, std::memory_order_relaxed);
+
+	unsigned int queueSize = position + 1 - mDequeuePosition.load(std::memory_order_relaxed);
+	unsigned int maxSize = mMaxSize.load(std::memory_order_relaxed);
+	while(queueSize > maxSize && mMaxSize.compare_exchange_weak(maxSize, queueSize, std::memory_order_relaxed) == false);
+
+	return true;
+}
+
+const ControlCommand*
+ControlQueue::front()
+{
+	size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+	Slot& slot = mSlots[position & mMask];
+
+	if(slot.mSequence.load(std::memory_order_acquire) != position + 1) return nullptr;
+
+	return &( slot.mCommand );
+}
+
+void
+ControlQueue::pop()
+{
+	size_t position = mDequeuePosition.load(std::memory_order_relaxed);
+	Slot& slot = mSlots[position & mMask];
+
+	slot.mSequence.store(position + mMask + 1, std::memory_order_release);
+	mDequeuePosition.store(position + 1, std::memory_order_relaxed);
+}
+
+unsigned long
+ControlQueue::pushedCount() const
+{
+	return mPushedCount.load(std::memory_order_relaxed);
+}
+
+unsigned long
+ControlQueue::droppedCount() const
+{
+	return mDroppedCount.load(std::memory_order_relaxed);
+}
+
+unsigned int
+ControlQueue::maxSize() const
+{
+	return mMaxSize.load(std::memory_order_relaxed);
+}
+
+void
+ControlQueue::resetCounters()
+{
+	mPushedCount.store(0, std::memory_order_relaxed);
+	mDroppedCount.store(0, std::memory_order_relaxed);
+	mMaxSize.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,117 @@
+/** \file dab_flock_control_queue.h
+ *  \class dab::flock::ControlQueue bounded lock-free queue of preparsed osc control commands
+ *  \brief bounded lock-free queue of preparsed osc control commands
+ *
+ *  Any number of receiving threads push osc messages, the simulation thread is the only consumer.\n
+ *  The queue is a fixed ring of slots, each slot holds a sequence number and a ControlCommand. A producer claims a slot with a compare and swap on the enqueue position, parses the message into the slot and publishes it by advancing the sequence number. Neither producers nor the consumer ever block.\n
+ *  Commands are parsed in place, slots are reused and keep the capacity of their arenas.\n
+ *  If all slots are taken, the message is dropped and counted, a control client can read the counters to throttle itself.\n
+ *  The consumer processes commands in the order in which the slots have been claimed. A slot that has been claimed but is still being parsed holds back later slots until it has been published.\n
+ */
+
+#ifndef _dab_flock_control_queue_h_
+#define _dab_flock_control_queue_h_
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include "dab_flock_control_command.h"
+
+namespace dab
+{
+
+namespace flock
+{
+
+class ControlQueue
+{
+public:
+    /**
+     \brief create queue
+     \param pCapacity maximum number of queued commands (rounded up to a power of two)
+     */
+    ControlQueue(unsigned int pCapacity = 256);
+
+    /**
+     \brief return capacity
+     \return maximum number of queued commands
+     */
+    unsigned int capacity() const;
+
+    /**
+     \brief return number of queued commands
+     \return number of claimed slots that have not been popped yet
+     */
+    unsigned int size() const;
+
+    /**
+     \brief parse osc message into a free slot (any thread)
+     \param pMessage osc message
+     \return false if the queue is full and the message has been dropped
+     */
+    bool push(const OscMessage& pMessage);
+
+    /**
+     \brief return oldest published command (consumer thread only)
+     \return command or nullptr if no command has been published
+     */
+    const ControlCommand* front();
+
+    /**
+     \brief release oldest command, must follow a front() that returned a command (consumer thread only)
+     */
+    void pop();
+
+    /**
+     \brief return number of queued messages
+     \return number of messages pushed since the queue has been created
+     */
+    unsigned long pushedCount() const;
+
+    /**
+     \brief return number of dropped messages
+     \return number of messages dropped because the queue was full
+     */
+    unsigned long droppedCount() const;
+
+    /**
+     \brief return maximum queue length
+     \return largest number of commands that have been queued at the same time
+     */
+    unsigned int maxSize() const;
+
+    /**
+     \brief reset counters
+     */
+    void resetCounters();
+
+protected:
+    /**
+     \brief queue slot
+     */
+    class Slot
+    {
+    public:
+        std::atomic<size_t> mSequence; /// \brief equals the position for which the slot is free, position + 1 once the command has been published
+        ControlCommand mCommand; /// \brief command
+    };
+
+    std::vector<Slot> mSlots; /// \brief ring of slots
+    size_t mMask; /// \brief capacity - 1
+    std::atomic<size_t> mEnqueuePosition; /// \brief position of next slot to claim (producers)
+    char mPadding[64]; /// \brief keeps enqueue and dequeue positions in separate cache lines
+    std::atomic<size_t> mDequeuePosition; /// \brief position of next slot to consume (consumer)
+
+    std::atomic<unsigned long> mPushedCount; /// \brief number of queued messages
+    std::atomic<unsigned long> mDroppedCount; /// \brief number of dropped messages
+    std::atomic<unsigned int> mMaxSize; /// \brief maximum queue length
+
+    ControlQueue(const ControlQueue& pQueue);
+    ControlQueue& operator=(const ControlQueue& pQueue);
+};
+
+};
+
+};
+
+#endif
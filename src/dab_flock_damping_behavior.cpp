@@ -95,4 +95,41 @@ DampingBehavior::act()
     
 	//std::cout << "DampingBehavior end: out values" << mOutputParameters[0]->values() << " bValues " << mOutputParameters[0]->backupValues() << "\n";
 	//assert(std::isnan(force[0]) == false && "isNan");
-}
\ No newline at end of file
+}
+
+bool
+DampingBehavior::shareable() const
+{
+	return true;
+}
+
+void
+DampingBehavior::createBindings()
+{
+	Behavior::createBindings();
+	
+	bindParameter( mVelocityPar );
+	bindParameter( mForcePar );
+	bindParameter( mPrefVelocityPar );
+	bindParameter( mAmountPar );
+}
+
+void
+DampingBehavior::actAll(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount)
+{
+	// the qualified call bypasses virtual dispatch and can be inlined
+	if( mShared == true )
+	{
+		DampingBehavior* behavior = static_cast<DampingBehavior*>( worker() );
+		
+		for(unsigned int aI=0; aI<pAgentCount; ++aI)
+		{
+			behavior->bind( pAgents[aI] );
+			behavior->DampingBehavior::act();
+		}
+	}
+	else
+	{
+		for(unsigned int bI=0; bI<pAgentCount; ++bI) static_cast<DampingBehavior*>( pBehaviors[bI] )->DampingBehavior::act();
+	}
+}
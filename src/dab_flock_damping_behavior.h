@@ -79,7 +79,26 @@ public:
      */
     void act();
     
+    /**
+     \brief perform behavior for a span of agents
+     \param pAgents agents
+     \param pBehaviors behaviors of equal name and class, one for each agent
+     \param pAgentCount number of agents
+     */
+    void actAll(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount);
+    
+    /**
+     \brief check whether a single instance of the behavior can act on behalf of all agents of a swarm
+     \return true
+     */
+    bool shareable() const;
+    
 protected:
+    /**
+     \brief register parameter pointers that need to be redirected when a worker acts on an agent
+     */
+    void createBindings();
+    
     Parameter* mVelocityPar; /// \brief velocity parameter (input)
     Parameter* mForcePar; /// \brief force parameter (output)
     Parameter* mPrefVelocityPar; /// \brief preferred velocity parameter (internal)
@@ -25,6 +25,7 @@ EnvAgentInteractBehavior::EnvAgentInteractBehavior(Env* pEnv, const std::string&
 	if( mEnvPar == nullptr ) throw Exception( "FLOCK ERROR: input parameter " + mInputParameters[0]->name() + " is not an environment parameter", __FILE__, __FUNCTION__, __LINE__ );
     
 	mAgentParName = mInputAgentParameterNames[mInputParameters[0]->name()][0];
+	mAgentParSymbol = Symbol( mAgentParName );
     
 	// create internal parameters
 	unsigned int envValueDim = mEnvPar->valueDim();
@@ -67,8 +68,9 @@ EnvAgentInteractBehavior::act()
 	//space::SpaceGrid& envGrid = mEnvPar->backupGrid();
 	const Eigen::VectorXf& amount = mAmountPar->values();
     
-    std::shared_ptr<space::Space> envSpace = mEnvPar->space();
-    std::vector<space::SpaceObject*> spaceObjects;
+    // space objects are collected into reused storage
+    std::vector<space::SpaceObject*>& spaceObjects = mSpaceObjects;
+    spaceObjects.clear();
 	mEnvPar->spaceObjects( spaceObjects );
     
 	unsigned oC = spaceObjects.size();
@@ -83,12 +85,13 @@ EnvAgentInteractBehavior::act()
 		
 		// get agent parameter values
 		const Eigen::VectorXf& agentPosition = agentPositionPar->values();
-		const Eigen::VectorXf& agentParValue = agent->parameter( mAgentParName )->values();
+		const Eigen::VectorXf& agentParValue = agent->parameter( mAgentParSymbol )->values();
         
 		//std::cout << "agent " << oI << " name " << agent->name().toStdString() << " par " << agentPositionPar->name().toStdString() << " value "<< agentPosition << " weight " << agentWeight << "\n";
         
 		// change grid
-		mEnvPar->change( agentPosition, agentParValue * amount, space::Interpol );
+		mChangeValues.noalias() = agentParValue * amount;
+		mEnvPar->change( agentPosition, mChangeValues, space::Interpol );
 	}
 	
 	//mEnvPar->flush();
@@ -5,6 +5,7 @@
 #define _dab_flock_env_agent_interact_behavior_h_
 
 #include "dab_flock_env_behavior.h"
+#include "dab_flock_symbol.h"
 
 namespace dab
 {
@@ -42,6 +43,9 @@ protected:
     EnvParameter* mEnvPar; // input par
     Parameter* mAmountPar; // interal par
     std::string mAgentParName; // agent input par
+    Symbol mAgentParSymbol; // agent input par name symbol
+    std::vector<space::SpaceObject*> mSpaceObjects; // space objects of env par (reused by act)
+    Eigen::VectorXf mChangeValues; // grid change values (reused by act)
     
     
 };
@@ -80,7 +80,7 @@ EnvDecayBehavior::act()
 {
 	space::SpaceGrid* inputGrid = mInputEnvPar->grid();
 	space::SpaceGrid* outputGrid = mOutputEnvPar->backupGrid();
-    Eigen::VectorXf decay = mDecayPar->values();
+    const Eigen::VectorXf& decay = mDecayPar->values();
     
 	math::VectorField<float>& inputField = inputGrid->vectorField();
 	math::VectorField<float>& outputField = outputGrid->vectorField();
@@ -95,7 +95,6 @@ EnvDiffusionBehavior::act()
 	int gridHeight = gridSize[1];
 	int gridWidth_1 = gridWidth - 1;
 	int gridHeight_1 = gridHeight - 1;
-    Eigen::VectorXf gridValue( vectorDim );
 	
 	// boundary conditions : corners
 	// top left
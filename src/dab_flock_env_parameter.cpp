@@ -208,7 +208,7 @@ EnvParameter::randomize(float pMinParameterValue, float pMaxParameterValue)
 {
 	if( isnan( pMinParameterValue ) == false && isnan( pMaxParameterValue ) == true ) return;
     
-	math::Math<>& math = math::Math<>::get();
+	RandomStream random = Simulation::get().randomStream( RandomStream::streamId( mName ) );
 	
 	math::VectorField<float>& vectorField = mBackupValueGrid->vectorField();
 	unsigned int vC = vectorField.vectorCount();
@@ -220,7 +220,7 @@ EnvParameter::randomize(float pMinParameterValue, float pMaxParameterValue)
         
 		for(unsigned int c=0; c<mDim; ++c)
 		{
-			vector[c] = math.random( pMinParameterValue, pMaxParameterValue );
+			vector[c] = random.uniform( pMinParameterValue, pMaxParameterValue );
 		}
 	}
 	
@@ -233,7 +233,7 @@ EnvParameter::randomize(const Eigen::VectorXf& pMinParameterValues, const Eigen:
 	if(pMinParameterValues.rows() != mDim) throw Exception( "FLOCK ERROR: valueCount mismatch: " + std::to_string(mDim) + " != " + std::to_string(pMinParameterValues.rows()) + " for parameter " + mName, __FILE__, __FUNCTION__, __LINE__ );
 	if(pMaxParameterValues.rows() != mDim) throw Exception( "FLOCK ERROR: valueCount mismatch: " + std::to_string(mDim) + " != " + std::to_string(pMaxParameterValues.rows()) + " for parameter " + mName, __FILE__, __FUNCTION__, __LINE__ );
 
-	math::Math<>& math = math::Math<>::get();
+	RandomStream random = Simulation::get().randomStream( RandomStream::streamId( mName ) );
     
 	math::VectorField<float>& vectorField = mBackupValueGrid->vectorField();
 	unsigned int vC = vectorField.vectorCount();
@@ -245,7 +245,7 @@ EnvParameter::randomize(const Eigen::VectorXf& pMinParameterValues, const Eigen:
         
 		for(unsigned int c=0; c<mDim; ++c)
 		{
-			if( isnan( pMinParameterValues[c] ) == false && isnan( pMaxParameterValues[c] ) == false ) vector[c] = math.random( pMinParameterValues[c], pMaxParameterValues[c] );
+			if( isnan( pMinParameterValues[c] ) == false && isnan( pMaxParameterValues[c] ) == false ) vector[c] = random.uniform( pMinParameterValues[c], pMaxParameterValues[c] );
 		}
 	}
 	
@@ -255,7 +255,7 @@ EnvParameter::randomize(const Eigen::VectorXf& pMinParameterValues, const Eigen:
 void
 EnvParameter::randomize(float pMinParameterValue, float pMaxParameterValue, float pThresholdValue)
 {
-	math::Math<>& math = math::Math<>::get();
+	RandomStream random = Simulation::get().randomStream( RandomStream::streamId( mName ) );
 	
 	math::VectorField<float>& vectorField = mBackupValueGrid->vectorField();
 	unsigned int vC = vectorField.vectorCount();
@@ -267,7 +267,7 @@ EnvParameter::randomize(float pMinParameterValue, float pMaxParameterValue, floa
         
 		for(unsigned int c=0; c<mDim; ++c)
 		{
-			if( math.random(0.0, 1.0) >= pThresholdValue ) vector[c] = pMaxParameterValue;
+			if( random.uniform() >= pThresholdValue ) vector[c] = pMaxParameterValue;
 			else vector[c] = pMinParameterValue;
 		}
 	}
@@ -282,7 +282,7 @@ EnvParameter::randomize(const Eigen::VectorXf& pMinParameterValues, const Eigen:
 	if(pMaxParameterValues.rows() != mDim) throw Exception( "FLOCK ERROR: valueCount mismatch: " + std::to_string(mDim) + " != " + std::to_string(pMaxParameterValues.rows()) + " for parameter " + mName, __FILE__, __FUNCTION__, __LINE__ );
 	if(pThresholdValues.rows() != mDim) throw Exception( "FLOCK ERROR: valueCount mismatch: " + std::to_string(mDim) + " != " + std::to_string(pThresholdValues.rows()) + " for parameter " + mName, __FILE__, __FUNCTION__, __LINE__ );
     
-	math::Math<>& math = math::Math<>::get();
+	RandomStream random = Simulation::get().randomStream( RandomStream::streamId( mName ) );
 	
 	math::VectorField<float>& vectorField = mBackupValueGrid->vectorField();
 	unsigned int vC = vectorField.vectorCount();
@@ -294,7 +294,7 @@ EnvParameter::randomize(const Eigen::VectorXf& pMinParameterValues, const Eigen:
         
 		for(unsigned int c=0; c<mDim; ++c)
 		{
-			if( math.random(0.0, 1.0) >= pThresholdValues[c] ) vector[c] = pMaxParameterValues[c];
+			if( random.uniform() >= pThresholdValues[c] ) vector[c] = pMaxParameterValues[c];
 			else vector[c] = pMinParameterValues[c];
 		}
 	}
@@ -10,6 +10,7 @@ using namespace dab::flock;
 
 EulerIntegration::EulerIntegration(const std::string& pInputParameterString, const std::string& pOutputParameterString)
 : Behavior(pInputParameterString, pOutputParameterString)
+, mKernelDim(0)
 {
 	mClassName = "EulerIntegration";
 }
@@ -38,6 +39,12 @@ EulerIntegration::EulerIntegration(Agent* pAgent, const std::string& pBehaviorNa
 	
 	// internal parameter
 	mTimeStepPar = createInternalParameter("timestep", { 0.1f } );
+	
+	// remaining stuff
+	// the fixed kernel maps all input and output parameters
+	unsigned int dim = mDerivative0ParOut->dim();
+	bool fixedDim = mDerivative0ParIn->dim() == dim && mDerivative1ParIn->dim() == dim && mDerivative2Par->dim() == dim && mDerivative1ParOut->dim() == dim;
+	mKernelDim = ( sFixedDimKernels == true && dim <= 3 && fixedDim == true ) ? dim : 0;
 }
 
 EulerIntegration::~EulerIntegration()
@@ -71,6 +78,82 @@ EulerIntegration::create(const std::string& pInputParameterString, const std::st
 
 void
 EulerIntegration::act()
+{
+	switch(mKernelDim)
+	{
+		case 1: actFixed<1>(); break;
+		case 2: actFixed<2>(); break;
+		case 3: actFixed<3>(); break;
+		default: actDynamic();
+	}
+}
+
+bool
+EulerIntegration::shareable() const
+{
+	return true;
+}
+
+void
+EulerIntegration::createBindings()
+{
+	Behavior::createBindings();
+	
+	bindParameter( mDerivative0ParIn );
+	bindParameter( mDerivative1ParIn );
+	bindParameter( mDerivative2Par );
+	bindParameter( mDerivative0ParOut );
+	bindParameter( mDerivative1ParOut );
+	bindParameter( mTimeStepPar );
+}
+
+void
+EulerIntegration::actAll(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount)
+{
+	switch(mKernelDim)
+	{
+		case 1: actAllFixed<1>(pAgents, pBehaviors, pAgentCount); break;
+		case 2: actAllFixed<2>(pAgents, pBehaviors, pAgentCount); break;
+		case 3: actAllFixed<3>(pAgents, pBehaviors, pAgentCount); break;
+		default: Behavior::actAll(pAgents, pBehaviors, pAgentCount);
+	}
+}
+
+template<int Dim>
+void
+EulerIntegration::actAllFixed(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount)
+{
+	// a shared behavior acts with the worker of the calling thread, rebound to each agent
+	EulerIntegration* behavior = mShared == true ? static_cast<EulerIntegration*>( worker() ) : nullptr;
+	
+	for(unsigned int aI=0; aI<pAgentCount; ++aI)
+	{
+		if( mShared == true ) behavior->bind( pAgents[aI] );
+		else behavior = static_cast<EulerIntegration*>( pBehaviors[aI] );
+		
+		if( behavior->mKernelDim == Dim ) behavior->actFixed<Dim>();
+		else behavior->act();
+	}
+}
+
+template<int Dim>
+void
+EulerIntegration::actFixed()
+{
+	typedef Eigen::Matrix<float, Dim, 1> Vector;
+	
+	Eigen::Map<const Vector> derivative1In( mDerivative1ParIn->values().data() );
+	Eigen::Map<const Vector> derivative2( mDerivative2Par->values().data() );
+	Eigen::Map<Vector> derivative0Out( mDerivative0ParOut->backupValues().data() );
+	Eigen::Map<Vector> derivative1Out( mDerivative1ParOut->backupValues().data() );
+	float timeStep = mTimeStepPar->value();
+	
+	derivative0Out += derivative1In * timeStep;
+	derivative1Out += derivative2 * timeStep;
+}
+
+void
+EulerIntegration::actDynamic()
 {
     Eigen::VectorXf& derivative0In = mDerivative0ParIn->values();
 	Eigen::VectorXf& derivative1In = mDerivative1ParIn->values();
@@ -63,13 +63,53 @@ public:
      */
     virtual void act();
     
+    /**
+     \brief perform behavior for a span of agents
+     \param pAgents agents
+     \param pBehaviors behaviors of equal name and class, one for each agent
+     \param pAgentCount number of agents
+     */
+    virtual void actAll(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount);
+    
+    /**
+     \brief check whether a single instance of the behavior can act on behalf of all agents of a swarm
+     \return true
+     */
+    bool shareable() const;
+    
 protected:
+    /**
+     \brief register parameter pointers that need to be redirected when a worker acts on an agent
+     */
+    void createBindings();
+    
+    /**
+     \brief perform behavior with fixed size vectors
+     \tparam Dim parameter dimension
+     */
+    template<int Dim> void actFixed();
+    
+    /**
+     \brief perform behavior for a span of agents with fixed size vectors
+     \tparam Dim parameter dimension
+     \param pAgents agents
+     \param pBehaviors behaviors of equal name and class, one for each agent
+     \param pAgentCount number of agents
+     */
+    template<int Dim> void actAllFixed(Agent** pAgents, Behavior** pBehaviors, unsigned int pAgentCount);
+    
+    /**
+     \brief perform behavior with dynamically sized vectors
+     */
+    void actDynamic();
+    
     Parameter* mDerivative0ParIn; /// \brief zero order derivative (input)
     Parameter* mDerivative1ParIn; /// \brief first order derivative (input)
     Parameter* mDerivative2Par; /// \brief second order derivative (input)
     Parameter* mDerivative0ParOut; /// \brief zero order derivative (output)
     Parameter* mDerivative1ParOut; /// \brief first order derivative (output)
     Parameter* mTimeStepPar; /// \brief integration time step (internal)
+    unsigned int mKernelDim; /// \brief parameter dimension of fixed size kernel (0: dynamic kernel)
 };
 
 };
@@ -9,6 +9,7 @@ using namespace dab::flock;
 
 EvasionBehavior::EvasionBehavior(const std::string& pInputParameterString, const std::string& pOutputParameterString)
 : Behavior(pInputParameterString, pOutputParameterString)
+, mKernelDim(0)
 {
 	mClassName = "EvasionBehavior";
 }
@@ -39,6 +40,8 @@ EvasionBehavior::EvasionBehavior(Agent* pAgent, const std::string& pBehaviorName
 	// remaining stuff
 	unsigned int dim = mForcePar->dim();
 	mTmpForce.resize(dim, 1);
+	// the fixed kernel maps the force and the neighbor directions, the latter possess the dimension of the position
+	mKernelDim = ( sFixedDimKernels == true && dim <= 3 && mPositionPar->dim() == dim ) ? dim : 0;
 }
 
 EvasionBehavior::~EvasionBehavior()
@@ -78,6 +81,59 @@ EvasionBehavior::act()
 	
 	if(mActivePar->value() <= 0.0) return;
     
+	switch(mKernelDim)
+	{
+		case 1: actFixed<1>(); break;
+		case 2: actFixed<2>(); break;
+		case 3: actFixed<3>(); break;
+		default: actDynamic();
+	}
+}
+
+template<int Dim>
+void
+EvasionBehavior::actFixed()
+{
+	typedef Eigen::Matrix<float, Dim, 1> Vector;
+	
+	space::NeighborGroup& positionNeighbors = *mPositionNeighbors;
+	Eigen::Map<Vector> force( mForcePar->backupValues().data() );
+	float maxDist = mMaxDistPar->value();
+	float amount = mAmountPar->value();
+	
+	unsigned int totalNeighborCount = positionNeighbors.neighborCount();
+	unsigned int neighborCount = 0;
+	
+	if(totalNeighborCount == 0) return;
+	
+	float distance;
+	float scale;
+	
+	Vector tmpForce = Vector::Zero();
+	
+	for(unsigned int i=0; i<totalNeighborCount; ++i)
+	{
+		distance = positionNeighbors.distance(i);
+		
+		if(maxDist > 0.0 && distance > maxDist) continue;
+		
+		scale = (maxDist - distance) / maxDist;
+		
+		tmpForce += Eigen::Map<const Vector>( positionNeighbors.direction(i).data() ) * scale;
+		neighborCount++;
+	}
+	
+	if(neighborCount == 0) return;
+	
+	tmpForce /= static_cast<float>(neighborCount);
+	tmpForce *= -1.0 * amount;
+	
+	force += tmpForce;
+}
+
+void
+EvasionBehavior::actDynamic()
+{
     Eigen::VectorXf& position = mPositionPar->values();
 	space::NeighborGroup& positionNeighbors = *mPositionNeighbors;
 	Eigen::VectorXf& force = mForcePar->backupValues();
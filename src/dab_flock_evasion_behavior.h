@@ -77,6 +77,17 @@ public:
     void act();
     
 protected:
+    /**
+     \brief perform behavior with fixed size vectors
+     \tparam Dim parameter dimension
+     */
+    template<int Dim> void actFixed();
+    
+    /**
+     \brief perform behavior with dynamically sized vectors
+     */
+    void actDynamic();
+    
     Parameter* mPositionPar; /// \brief position parameter (input)
     Parameter* mForcePar; /// \brief force parameter (output)
     Parameter* mMaxDistPar; /// \brief minimum distance parameter (internal)
@@ -84,6 +95,7 @@ protected:
     space::NeighborGroup* mPositionNeighbors; /// \brief position neighbor group
     
     Eigen::VectorXf mTmpForce; /// \brief temporary force
+    unsigned int mKernelDim; /// \brief parameter dimension of fixed size kernel (0: dynamic kernel)
 };
 
 };
@@ -7,8 +7,10 @@
 #include "dab_flock_euler_integration.h"
 #include "dab_flock_behavior_includes.h"
 #include "dab_flock_serialize.h"
+#include "dab_flock_profiler.h"
 #include "dab_flock_visual.h"
 #include "dab_flock_visual_swarm.h"
+#include <algorithm>
 
 using namespace dab;
 using namespace dab::flock;
@@ -17,13 +19,21 @@ OscControl::OscControl()
 : Singleton<OscControl>()
 , OscListener()
 , mErrorSender(nullptr)
-{}
+, mFailedCommandCount(0)
+, mCoalescedCommandCount(0)
+{
+    initCommandTable();
+}
 
 OscControl::OscControl( std::shared_ptr<OscSender> pErrorSender )
 : Singleton<OscControl>()
 , OscListener()
 , mErrorSender(pErrorSender)
-{}
+, mFailedCommandCount(0)
+, mCoalescedCommandCount(0)
+{
+    initCommandTable();
+}
 
 OscControl::~OscControl()
 {}
@@ -110,170 +120,228 @@ OscControl::gridUpdateMode( const std::string& pGridUpdateMode ) throw (Exceptio
 }
 
 void
-OscControl::groupOscArgs( std::shared_ptr<OscMessage> pMessage, std::vector< std::shared_ptr<_OscArg> >& pGroupedArgs )
+OscControl::notify(std::shared_ptr<OscMessage> pMessage)
+{
+    mCommands.push(*pMessage);
+}
+
+void
+OscControl::update()
+{
+    unsigned int commandCount = mCommands.capacity();
+    
+    for(unsigned int cI=0; cI<commandCount; ++cI)
+    {
+        const ControlCommand* command = mCommands.front();
+        if(command == nullptr) break;
+        
+        execute(*command);
+        mCommands.pop();
+    }
+    
+    flushSetParameterEvents();
+}
+
+void
+OscControl::addCommand( const std::string& pAddress, CommandHandler pHandler )
+{
+    std::shared_ptr<Command> command( new Command() );
+    command->mHandler = pHandler;
+    
+    std::lock_guard<std::mutex> lock(mCommandLock);
+    
+    mCommandTable[pAddress] = command;
+}
+
+void
+OscControl::removeCommand( const std::string& pAddress )
 {
-//    std::cout << *pMessage << "\n";
-//    
-//    std::cout << "arrayCount " << pMessage->arrayCount() << "\n";
+    std::lock_guard<std::mutex> lock(mCommandLock);
     
-    const std::vector<_OscArg*> arguments = pMessage->arguments();
-    int argCount = arguments.size();
+    mCommandTable.erase(pAddress);
+}
+
+bool
+OscControl::checkCommand( const std::string& pAddress )
+{
+    std::lock_guard<std::mutex> lock(mCommandLock);
     
-    if(pMessage->arrayCount() > 0) // message alread contains value groups, simple copy them
+    return mCommandTable.find(pAddress) != mCommandTable.end();
+}
+
+unsigned long
+OscControl::receivedCommandCount() const
+{
+    return mCommands.pushedCount() + mCommands.droppedCount();
+}
+
+unsigned long
+OscControl::droppedCommandCount() const
+{
+    return mCommands.droppedCount();
+}
+
+unsigned long
+OscControl::failedCommandCount() const
+{
+    return mFailedCommandCount;
+}
+
+unsigned int
+OscControl::maxQueuedCommandCount() const
+{
+    return mCommands.maxSize();
+}
+
+unsigned long
+OscControl::coalescedCommandCount() const
+{
+    return mCoalescedCommandCount;
+}
+
+void
+OscControl::resetCommandCounters()
+{
+    mCommands.resetCounters();
+    mFailedCommandCount = 0;
+    mCoalescedCommandCount = 0;
+}
+
+bool
+OscControl::SetParameterTarget::operator==(const SetParameterTarget& pTarget) const
+{
+    return mSwarmId == pTarget.mSwarmId && mParameterId == pTarget.mParameterId && mAgentRangeStartIndex == pTarget.mAgentRangeStartIndex && mAgentRangeEndIndex == pTarget.mAgentRangeEndIndex;
+}
+
+size_t
+OscControl::SetParameterTargetHash::operator()(const SetParameterTarget& pTarget) const
+{
+    size_t hash = pTarget.mSwarmId;
+    hash = hash * 31 + pTarget.mParameterId;
+    hash = hash * 31 + static_cast<unsigned int>(pTarget.mAgentRangeStartIndex);
+    hash = hash * 31 + static_cast<unsigned int>(pTarget.mAgentRangeEndIndex);
+    
+    return hash;
+}
+
+void
+OscControl::addSetParameterEvent( std::shared_ptr<SetParameterEvent> pEvent )
+{
+    std::array<int, 2> agentRange = pEvent->agentRange();
+    
+    SetParameterTarget target;
+    target.mSwarmId = pEvent->swarmSymbol().id();
+    target.mParameterId = pEvent->parameterSymbol().id();
+    target.mAgentRangeStartIndex = agentRange[0];
+    target.mAgentRangeEndIndex = agentRange[1];
+    
+    auto iter = mPendingSetParameterIndices.find(target);
+    
+    if(iter != mPendingSetParameterIndices.end())
     {
-        for(int aI=0; aI<argCount; ++aI)
-        {
-            _OscArg* arg = arguments[aI];
-            
-            //std::cout << "arg " << aI << " " << *arg << "\n";
-            //std::cout << "valueCount " << arg->valueCount() << "\n";
-            
-            pGroupedArgs.push_back( std::shared_ptr<_OscArg>(arg->copy()));
-        }
+        // the later command wins, it moves to the end so that overlapping targets (e.g. a single agent and the whole swarm) are still applied in order of arrival
+        mPendingSetParameterEvents[iter->second] = nullptr;
+        iter->second = mPendingSetParameterEvents.size();
+        mCoalescedCommandCount++;
     }
     else
     {
-        std::vector< std::vector<_OscArg*> > groupedArgs;
-        
-        OscType currentType = OSC_TYPE_NONE;
-        std::vector<_OscArg*> currentGroup;
-        std::string tmp;
+        mPendingSetParameterIndices[target] = mPendingSetParameterEvents.size();
+    }
+    
+    mPendingSetParameterEvents.push_back(pEvent);
+}
+
+void
+OscControl::flushSetParameterEvents()
+{
+    unsigned int eventCount = mPendingSetParameterEvents.size();
+    
+    for(unsigned int eI=0; eI<eventCount; ++eI)
+    {
+        if(mPendingSetParameterEvents[eI] == nullptr) continue;
         
-        for(int aI=0; aI<argCount; ++aI)
+        try
         {
-            _OscArg* arg = arguments[aI];
-            
-//            std::cout << "arg " << aI << " " << *arg << "\n";
-//            std::cout << "valueCount " << arg->valueCount() << "\n";
-//            std::cout << "byteCount " << arg->byteCount() << "\n";
-            
-            if(arg->oscType() == currentType && arg->oscType() != OSC_TYPE_STRING)
-            {
-                currentGroup.push_back(arg);
-            }
-            else
-            {
-                if( currentGroup.size() > 0 )
-                {
-                    groupedArgs.push_back(currentGroup);
-                    currentGroup.clear();
-                }
-                
-                if(arg->oscType() == OSC_TYPE_CHAR)
-                {
-                    currentType = OSC_TYPE_NONE;
-                }
-                else if(arg->oscType() == OSC_TYPE_STRING && arg->valueCount() == 1 )
-                {
-                    currentType = OSC_TYPE_NONE;
-                }
-                else
-                {
-                    currentGroup.push_back(arg);
-                    currentType = arg->oscType();
-                }
-            }
+            Simulation::get().event().addEvent( mPendingSetParameterEvents[eI] );
         }
-        
-        if(currentGroup.size() > 0) groupedArgs.push_back(currentGroup);
-        
-        int groupCount = groupedArgs.size();
-        
-        //std::cout << "groupCount " << groupCount << "\n";
-        
-        for(int gI=0; gI<groupCount; ++gI)
+        catch(dab::Exception& e)
         {
-            std::vector<_OscArg*>& group = groupedArgs[gI];
-            int groupSize = group.size();
-            OscType groupType = group[0]->oscType();
-            
-            //std::cout << "group " << gI << " size " << groupSize << " type " << groupType << "\n";
-            
-            if(groupSize == 1)
-            {
-                pGroupedArgs.push_back( std::shared_ptr<_OscArg>(group[0]->copy()));
-            }
-            else
-            {
-                if(groupType == OSC_TYPE_INT32)
-                {
-                    std::vector<int32_t> valueVec(groupSize);
-                    for(int vI=0; vI<groupSize; ++vI)
-                    {
-                        valueVec[vI] = *(group[vI]);
-                    }
-                    
-                    pGroupedArgs.push_back( std::shared_ptr<_OscArg>(new OscArg<int32_t>( valueVec.data(), valueVec.size())));
-                }
-                else if(groupType == OSC_TYPE_FLOAT)
-                {
-                    
-                    
-                    std::vector<float> valueVec(groupSize);
-                    for(int vI=0; vI<groupSize; ++vI)
-                    {
-                        valueVec[vI] = *(group[vI]);
-                    }
-                    
-                    pGroupedArgs.push_back(std::shared_ptr<_OscArg>(new OscArg<float>( valueVec.data(), valueVec.size())));
-                }
-                // etc more types
-            }
-            
-            //std::cout << "new group " << *(pGroupedArgs[ pGroupedArgs.size() - 1]) << "\n";
+            Simulation::get().exceptionReport(e);
         }
     }
+    
+    mPendingSetParameterEvents.clear();
+    mPendingSetParameterIndices.clear();
 }
 
+void
+OscControl::initCommandTable()
+{
+    addCommand("/ClearSimulation", [this](const ControlCommand& pCommand) { clearSimulation(); });
+    addCommand("/RestoreSimulation", [this](const ControlCommand& pCommand) { restoreSimulation(pCommand); });
+    addCommand("/SaveSimulation", [this](const ControlCommand& pCommand) { saveSimulation(pCommand); });
+    addCommand("/SetSimulationRate", [this](const ControlCommand& pCommand) { setSimulationRate(pCommand); });
+    addCommand("/FreezeSimulation", [this](const ControlCommand& pCommand) { freezeSimulation(pCommand); });
+    addCommand("/SetThreadCount", [this](const ControlCommand& pCommand) { setThreadCount(pCommand); });
+    addCommand("/SetProfiling", [this](const ControlCommand& pCommand) { setProfiling(pCommand); });
+    addCommand("/AddSpace", [this](const ControlCommand& pCommand) { addSpace(pCommand); });
+    addCommand("/AddAgents", [this](const ControlCommand& pCommand) { addAgents(pCommand); });
+    addCommand("/RemoveAgents", [this](const ControlCommand& pCommand) { removeAgents(pCommand); });
+    addCommand("/SetParameter", [this](const ControlCommand& pCommand) { setParameter(pCommand); });
+    addCommand("/SetAgentParameters", [this](const ControlCommand& pCommand) { setAgentParameters(pCommand); });
+    addCommand("/AssignNeighbors", [this](const ControlCommand& pCommand) { assignNeighbors(pCommand); });
+    addCommand("/ShowSwarm", [this](const ControlCommand& pCommand) { showSwarm(pCommand); });
+    addCommand("/HideSwarm", [this](const ControlCommand& pCommand) { hideSwarm(pCommand); });
+    addCommand("/ShowSpace", [this](const ControlCommand& pCommand) { showSpace(pCommand); });
+    addCommand("/HideSpace", [this](const ControlCommand& pCommand) { hideSpace(pCommand); });
+    addCommand("/DisplayPosition", [this](const ControlCommand& pCommand) { setDisplayPosition(pCommand); });
+    addCommand("/DisplayOrientation", [this](const ControlCommand& pCommand) { setDisplayOrientation(pCommand); });
+    addCommand("/DisplayOrientationChange", [this](const ControlCommand& pCommand) { changeDisplayOrientation(pCommand); });
+    addCommand("/DisplayZoom", [this](const ControlCommand& pCommand) { setDisplayZoom(pCommand); });
+    addCommand("/AgentColor", [this](const ControlCommand& pCommand) { setAgentColor(pCommand); });
+    addCommand("/AgentScale", [this](const ControlCommand& pCommand) { setAgentScale(pCommand); });
+    addCommand("/AgentLineWidth", [this](const ControlCommand& pCommand) { setAgentLineWidth(pCommand); });
+    addCommand("/TrailColor", [this](const ControlCommand& pCommand) { setTrailColor(pCommand); });
+    addCommand("/TrailLength", [this](const ControlCommand& pCommand) { setTrailLength(pCommand); });
+    addCommand("/TrailDecay", [this](const ControlCommand& pCommand) { setTrailDecay(pCommand); });
+    addCommand("/TrailLineWidth", [this](const ControlCommand& pCommand) { setTrailLineWidth(pCommand); });
+}
 
 void
-OscControl::notify(std::shared_ptr<OscMessage> pMessage)
+OscControl::execute( const ControlCommand& pCommand )
 {
-    mLock.lock();
+    // other commands may depend on parameter values (or change the agents a parameter is set for), keep their order
+    if(mPendingSetParameterEvents.size() > 0 && pCommand.address() != "/SetParameter") flushSetParameterEvents();
+    
+    std::shared_ptr<Command> command;
+    
+    mCommandLock.lock();
     
-    //std::cout << "OSCControl::notify\n";
+    auto commandIter = mCommandTable.find(pCommand.address());
+    if(commandIter != mCommandTable.end()) command = commandIter->second;
+    
+    mCommandLock.unlock();
+    
+    if(command == nullptr) return;
     
     try
     {
-        std::string oscCommand = pMessage->address();
-        std::vector< std::shared_ptr<_OscArg> > groupedOscArgs;
-        groupOscArgs(pMessage, groupedOscArgs);
-
-		//std::cout << "oscCommand " << oscCommand << "\n";
-
-        if(oscCommand == "/ClearSimulation") clearSimulation();
-        else if(oscCommand == "/RestoreSimulation") restoreSimulation(groupedOscArgs);
-		else if(oscCommand == "/SaveSimulation") saveSimulation(groupedOscArgs);
-        else if(oscCommand == "/SetSimulationRate") setSimulationRate(groupedOscArgs);
-        else if(oscCommand == "/FreezeSimulation") freezeSimulation(groupedOscArgs);
-        else if(oscCommand == "/AddSpace") addSpace(groupedOscArgs);
-        else if(oscCommand == "/AddAgents") addAgents(groupedOscArgs);
-        else if(oscCommand == "/RemoveAgents") removeAgents(groupedOscArgs);
-        else if(oscCommand == "/SetParameter") setParameter(groupedOscArgs);
-		else if (oscCommand == "/AssignNeighbors") assignNeighbors(groupedOscArgs);
-        else if(oscCommand == "/ShowSwarm") showSwarm(groupedOscArgs);
-        else if(oscCommand == "/HideSwarm") hideSwarm(groupedOscArgs);
-        else if(oscCommand == "/ShowSpace") showSpace(groupedOscArgs);
-        else if(oscCommand == "/HideSpace") hideSpace(groupedOscArgs);
-		else if (oscCommand == "/DisplayPosition") setDisplayPosition(groupedOscArgs);
-		else if (oscCommand == "/DisplayOrientation") setDisplayOrientation(groupedOscArgs);
-		else if (oscCommand == "/DisplayOrientationChange") changeDisplayOrientation(groupedOscArgs);
-		else if (oscCommand == "/DisplayZoom") setDisplayZoom(groupedOscArgs);
-        else if(oscCommand == "/AgentColor") setAgentColor(groupedOscArgs);
-        else if(oscCommand == "/AgentScale") setAgentScale(groupedOscArgs);
-        else if(oscCommand == "/AgentLineWidth") setAgentLineWidth(groupedOscArgs);
-        else if(oscCommand == "/TrailColor") setTrailColor(groupedOscArgs);
-        else if(oscCommand == "/TrailLength") setTrailLength(groupedOscArgs);
-        else if(oscCommand == "/TrailDecay") setTrailDecay(groupedOscArgs);
-        else if(oscCommand == "/TrailLineWidth") setTrailLineWidth(groupedOscArgs);
+        command->mHandler(pCommand);
     }
     catch(dab::Exception& e)
     {
-        e += dab::Exception("COM ERROR: OscControl notify failed", __FILE__, __FUNCTION__, __LINE__);
-        throw e;
+        mFailedCommandCount++;
+        
+        e += dab::Exception("COM ERROR: OscControl failed to execute " + pCommand.address(), __FILE__, __FUNCTION__, __LINE__);
+        Simulation::get().exceptionReport(e);
+    }
+    catch(std::exception& e)
+    {
+        mFailedCommandCount++;
+        
+        Simulation::get().exceptionReport( dab::Exception("COM ERROR: OscControl failed to execute " + pCommand.address() + ": " + e.what(), __FILE__, __FUNCTION__, __LINE__) );
     }
-    
-    mLock.unlock();
 }
 
 void
@@ -290,7 +358,7 @@ OscControl::clearSimulation() throw (Exception)
 }
 
 void
-OscControl::restoreSimulation(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::restoreSimulation(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -317,7 +385,7 @@ OscControl::restoreSimulation(const std::vector< std::shared_ptr<_OscArg> >& pPa
 }
 
 void
-OscControl::saveSimulation(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::saveSimulation(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -344,7 +412,7 @@ OscControl::saveSimulation(const std::vector< std::shared_ptr<_OscArg> >& pParam
 }
 
 void
-OscControl::setSimulationRate(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setSimulationRate(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -368,7 +436,7 @@ OscControl::setSimulationRate(const std::vector< std::shared_ptr<_OscArg> >& pPa
 }
 
 void
-OscControl::freezeSimulation(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::freezeSimulation(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -397,7 +465,68 @@ OscControl::freezeSimulation(const std::vector< std::shared_ptr<_OscArg> >& pPar
 }
 
 void
-OscControl::addSpace(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setThreadCount(const ControlCommand& pParameters) throw (Exception)
+{
+    try
+    {
+        if(pParameters.size() == 1 && pParameters[0]->oscType() == OSC_TYPE_INT32)
+        {
+            int threadCount = *(pParameters[0]);
+            if(threadCount < 1) throw Exception( "FLOCK ERROR: thread count must be at least 1", __FILE__, __FUNCTION__, __LINE__ );
+            
+            Simulation::get().setThreadCount( static_cast<unsigned int>(threadCount) );
+        }
+        else if(pParameters.size() == 1 && pParameters[0]->oscType() == OSC_TYPE_FLOAT)
+        {
+            float threadCount = *(pParameters[0]);
+            if(threadCount < 1.0) throw Exception( "FLOCK ERROR: thread count must be at least 1", __FILE__, __FUNCTION__, __LINE__ );
+            
+            Simulation::get().setThreadCount( static_cast<unsigned int>(threadCount) );
+        }
+        else throw Exception( "FLOCK ERROR: Wrong Parameters for /SetThreadCount", __FILE__, __FUNCTION__, __LINE__ );
+    }
+    catch(Exception& e)
+    {
+        throw;
+    }
+}
+
+void
+OscControl::setProfiling(const ControlCommand& pParameters) throw (Exception)
+{
+    try
+    {
+        FlockProfiler& profiler = FlockProfiler::get();
+        
+        if(pParameters.size() == 1 && pParameters[0]->oscType() == OSC_TYPE_INT32)
+        {
+            int enabled = *(pParameters[0]);
+            
+            profiler.setEnabled( enabled != 0 );
+            if( enabled == 0 ) profiler.stopStreaming();
+        }
+        else if(pParameters.size() == 3 && pParameters[0]->oscType() == OSC_TYPE_INT32 && pParameters[1]->oscType() == OSC_TYPE_STRING && pParameters[2]->oscType() == OSC_TYPE_INT32)
+        {
+            int enabled = *(pParameters[0]);
+            std::string senderName = pParameters[1]->operator const std::string&();
+            int sendInterval = *(pParameters[2]);
+            
+            if(sendInterval < 1) throw Exception( "FLOCK ERROR: send interval must be at least 1", __FILE__, __FUNCTION__, __LINE__ );
+            
+            profiler.setEnabled( enabled != 0 );
+            if( enabled != 0 ) profiler.startStreaming( senderName, static_cast<unsigned int>(sendInterval) );
+            else profiler.stopStreaming();
+        }
+        else throw Exception( "FLOCK ERROR: Wrong Parameters for /SetProfiling", __FILE__, __FUNCTION__, __LINE__ );
+    }
+    catch(Exception& e)
+    {
+        throw;
+    }
+}
+
+void
+OscControl::addSpace(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -458,7 +587,7 @@ OscControl::addSpace(const std::vector< std::shared_ptr<_OscArg> >& pParameters)
 }
 
 void
-OscControl::addAgents(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::addAgents(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -479,7 +608,7 @@ OscControl::addAgents(const std::vector< std::shared_ptr<_OscArg> >& pParameters
 }
 
 void
-OscControl::removeAgents(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::removeAgents(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -529,7 +658,7 @@ OscControl::removeAgents(const std::vector< std::shared_ptr<_OscArg> >& pParamet
 }
 
 void
-OscControl::setParameter(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setParameter(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -543,7 +672,7 @@ OscControl::setParameter(const std::vector< std::shared_ptr<_OscArg> >& pParamet
             Eigen::VectorXf parameterVec(1);
             parameterVec[0] = parameterValue;
             
-            Simulation::get().event().addEvent( std::shared_ptr<event::Event>(new SetParameterEvent(swarmName, parameterName, parameterVec)));
+            addSetParameterEvent( std::shared_ptr<SetParameterEvent>(new SetParameterEvent(swarmName, parameterName, parameterVec)));
         }
         else if(pParameters.size() == 3 && pParameters[0]->oscType() == OSC_TYPE_STRING && pParameters[1]->oscType() == OSC_TYPE_STRING && pParameters[2]->oscType() == EXT_TYPE_ARG_FLOAT_ARRAY)
         {
@@ -556,7 +685,7 @@ OscControl::setParameter(const std::vector< std::shared_ptr<_OscArg> >& pParamet
             Eigen::VectorXf parameterVec(parameterDim);
             for(int d=0; d<parameterDim; ++d) parameterVec[d] = parameterValues[d];
             
-            Simulation::get().event().addEvent( std::shared_ptr<event::Event>(new SetParameterEvent(swarmName, parameterName, parameterVec)));
+            addSetParameterEvent( std::shared_ptr<SetParameterEvent>(new SetParameterEvent(swarmName, parameterName, parameterVec)));
         }
         else if(pParameters.size() == 4 && pParameters[0]->oscType() == OSC_TYPE_STRING && pParameters[1]->oscType() == OSC_TYPE_STRING && pParameters[2]->oscType() == OSC_TYPE_FLOAT && pParameters[3]->oscType() == OSC_TYPE_FLOAT)
         {
@@ -569,7 +698,7 @@ OscControl::setParameter(const std::vector< std::shared_ptr<_OscArg> >& pParamet
             Eigen::VectorXf parameterVec(1);
             parameterVec[0] = parameterValue;
             
-            Simulation::get().event().addEvent( std::shared_ptr<event::Event>(new SetParameterEvent(swarmName, parameterName, parameterVec, duration)));
+            addSetParameterEvent( std::shared_ptr<SetParameterEvent>(new SetParameterEvent(swarmName, parameterName, parameterVec, duration)));
         }
         else if(pParameters.size() == 4 && pParameters[0]->oscType() == OSC_TYPE_STRING && pParameters[1]->oscType() == OSC_TYPE_STRING && pParameters[2]->oscType() == EXT_TYPE_ARG_FLOAT_ARRAY && pParameters[3]->oscType() == OSC_TYPE_FLOAT)
         {
@@ -583,7 +712,7 @@ OscControl::setParameter(const std::vector< std::shared_ptr<_OscArg> >& pParamet
             Eigen::VectorXf parameterVec(parameterDim);
             for(int d=0; d<parameterDim; ++d) parameterVec[d] = parameterValues[d];
             
-            Simulation::get().event().addEvent( std::shared_ptr<event::Event>(new SetParameterEvent(swarmName, parameterName, parameterVec, duration)));
+            addSetParameterEvent( std::shared_ptr<SetParameterEvent>(new SetParameterEvent(swarmName, parameterName, parameterVec, duration)));
         }
         else if(pParameters.size() == 4 && pParameters[0]->oscType() == OSC_TYPE_STRING && pParameters[1]->oscType() == OSC_TYPE_STRING && pParameters[2]->oscType() == OSC_TYPE_INT32 && pParameters[3]->oscType() == OSC_TYPE_FLOAT)
         {
@@ -597,7 +726,7 @@ OscControl::setParameter(const std::vector< std::shared_ptr<_OscArg> >& pParamet
             Eigen::VectorXf parameterVec(1);
             parameterVec[0] = parameterValue;
             
-            Simulation::get().event().addEvent( std::shared_ptr<event::Event>(new SetParameterEvent(swarmName, parameterName, agentIndex, parameterVec)));
+            addSetParameterEvent( std::shared_ptr<SetParameterEvent>(new SetParameterEvent(swarmName, parameterName, agentIndex, parameterVec)));
         }
         else if(pParameters.size() == 4 && pParameters[0]->oscType() == OSC_TYPE_STRING && pParameters[1]->oscType() == OSC_TYPE_STRING && pParameters[2]->oscType() == OSC_TYPE_INT32 && pParameters[3]->oscType() == EXT_TYPE_ARG_FLOAT_ARRAY)
         {
@@ -612,7 +741,7 @@ OscControl::setParameter(const std::vector< std::shared_ptr<_OscArg> >& pParamet
             Eigen::VectorXf parameterVec(parameterDim);
             for(int d=0; d<parameterDim; ++d) parameterVec[d] = parameterValues[d];
             
-            Simulation::get().event().addEvent( std::shared_ptr<event::Event>(new SetParameterEvent(swarmName, parameterName, agentIndex, parameterVec)));
+            addSetParameterEvent( std::shared_ptr<SetParameterEvent>(new SetParameterEvent(swarmName, parameterName, agentIndex, parameterVec)));
         }
         else if(pParameters.size() == 5 && pParameters[0]->oscType() == OSC_TYPE_STRING && pParameters[1]->oscType() == OSC_TYPE_STRING && pParameters[2]->oscType() == OSC_TYPE_INT32 && pParameters[3]->oscType() == OSC_TYPE_FLOAT && pParameters[4]->oscType() == OSC_TYPE_FLOAT)
         {
@@ -627,7 +756,7 @@ OscControl::setParameter(const std::vector< std::shared_ptr<_OscArg> >& pParamet
             Eigen::VectorXf parameterVec(1);
             parameterVec[0] = parameterValue;
             
-            Simulation::get().event().addEvent( std::shared_ptr<event::Event>(new SetParameterEvent(swarmName, parameterName, agentIndex, parameterVec, duration)));
+            addSetParameterEvent( std::shared_ptr<SetParameterEvent>(new SetParameterEvent(swarmName, parameterName, agentIndex, parameterVec, duration)));
         }
         else if(pParameters.size() == 5 && pParameters[0]->oscType() == OSC_TYPE_STRING && pParameters[1]->oscType() == OSC_TYPE_STRING && pParameters[2]->oscType() == OSC_TYPE_INT32 && pParameters[3]->oscType() == EXT_TYPE_ARG_FLOAT_ARRAY && pParameters[4]->oscType() == OSC_TYPE_FLOAT)
         {
@@ -643,7 +772,7 @@ OscControl::setParameter(const std::vector< std::shared_ptr<_OscArg> >& pParamet
             Eigen::VectorXf parameterVec(parameterDim);
             for(int d=0; d<parameterDim; ++d) parameterVec[d] = parameterValues[d];
             
-            Simulation::get().event().addEvent( std::shared_ptr<event::Event>(new SetParameterEvent(swarmName, parameterName, agentIndex, parameterVec, duration)));
+            addSetParameterEvent( std::shared_ptr<SetParameterEvent>(new SetParameterEvent(swarmName, parameterName, agentIndex, parameterVec, duration)));
         }
         else throw Exception( "FLOCK ERROR: Wrong Parameters for /SetParameter", __FILE__, __FUNCTION__, __LINE__ );
     }
@@ -653,8 +782,56 @@ OscControl::setParameter(const std::vector< std::shared_ptr<_OscArg> >& pParamet
     }
 }
 
+void
+OscControl::setAgentParameters(const ControlCommand& pParameters) throw (Exception)
+{
+    // values are written directly into the agents at the beginning of the step, without creating events
+    try
+    {
+        unsigned int parameterCount = pParameters.size();
+        
+        if( ( parameterCount == 3 || ( parameterCount == 4 && pParameters[2]->oscType() == OSC_TYPE_INT32 ) ) && pParameters[0]->oscType() == OSC_TYPE_STRING && pParameters[1]->oscType() == OSC_TYPE_STRING && ( pParameters[parameterCount - 1]->oscType() == EXT_TYPE_ARG_FLOAT_ARRAY || pParameters[parameterCount - 1]->oscType() == OSC_TYPE_FLOAT ) )
+        {
+            // swarm name / parameter name / (agent start index) / parameter values of consecutive agents
+            // names are only looked up, names that arrive via osc are not interned
+            const std::string& swarmName = pParameters[0]->operator const std::string&();
+            const std::string& parameterName = pParameters[1]->operator const std::string&();
+            int swarmId = SymbolTable::get().find( swarmName );
+            if( swarmId == -1 ) throw Exception( "FLOCK ERROR: swarm " + swarmName + " not found", __FILE__, __FUNCTION__, __LINE__ );
+            int parameterId = SymbolTable::get().find( parameterName );
+            if( parameterId == -1 ) throw Exception( "FLOCK ERROR: parameter " + parameterName + " does not exist", __FILE__, __FUNCTION__, __LINE__ );
+            Symbol swarmSymbol( static_cast<unsigned int>( swarmId ) );
+            Symbol parameterSymbol( static_cast<unsigned int>( parameterId ) );
+            int agentStartIndex = 0;
+            if( parameterCount == 4 ) agentStartIndex = *(pParameters[2]);
+            unsigned int valueCount = pParameters[parameterCount - 1]->valueCount();
+            float* values = *(pParameters[parameterCount - 1]);
+            
+            std::vector<Agent*>& agents = Simulation::get().swarm(swarmSymbol)->agents();
+            if( agentStartIndex < 0 || agentStartIndex >= static_cast<int>( agents.size() ) ) throw Exception( "FLOCK ERROR: agent index " + std::to_string(agentStartIndex) + " out of range for swarm " + swarmSymbol.name(), __FILE__, __FUNCTION__, __LINE__ );
+            
+            unsigned int parameterIndex = agents[0]->parameterIndex(parameterSymbol);
+            unsigned int parameterDim = agents[0]->parameter(parameterIndex)->dim();
+            if( valueCount % parameterDim != 0 ) throw Exception( "FLOCK ERROR: value count " + std::to_string(valueCount) + " is not a multiple of dimension " + std::to_string(parameterDim) + " of parameter " + parameterSymbol.name(), __FILE__, __FUNCTION__, __LINE__ );
+            
+            // values for agents beyond the end of the swarm are ignored
+            unsigned int agentEndIndex = std::min<unsigned int>( agentStartIndex + valueCount / parameterDim, agents.size() );
+            
+            for(unsigned int agentNr = agentStartIndex; agentNr < agentEndIndex; ++agentNr, values += parameterDim)
+            {
+                agents[agentNr]->parameter(parameterIndex)->setValues(parameterDim, values);
+            }
+        }
+        else throw Exception( "FLOCK ERROR: Wrong Parameters for /SetAgentParameters", __FILE__, __FUNCTION__, __LINE__ );
+    }
+    catch(Exception& e)
+    {
+        throw;
+    }
+}
+
 void 
-OscControl::assignNeighbors(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::assignNeighbors(const ControlCommand& pParameters) throw (Exception)
 {
 	// TODO: create an assign neighbor event for this
 	// TODO: this is marginal implementatiom only for changing the visibility of one parameter in one space only
@@ -682,7 +859,7 @@ OscControl::assignNeighbors(const std::vector< std::shared_ptr<_OscArg> >& pPara
 }
 
 void
-OscControl::showSwarm(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::showSwarm(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -719,7 +896,7 @@ OscControl::showSwarm(const std::vector< std::shared_ptr<_OscArg> >& pParameters
 }
 
 void
-OscControl::hideSwarm(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::hideSwarm(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -738,7 +915,7 @@ OscControl::hideSwarm(const std::vector< std::shared_ptr<_OscArg> >& pParameters
 }
 
 void
-OscControl::showSpace(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::showSpace(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -784,7 +961,7 @@ OscControl::showSpace(const std::vector< std::shared_ptr<_OscArg> >& pParameters
 }
 
 void
-OscControl::hideSpace(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::hideSpace(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -803,7 +980,7 @@ OscControl::hideSpace(const std::vector< std::shared_ptr<_OscArg> >& pParameters
 }
 
 void 
-OscControl::setDisplayPosition(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setDisplayPosition(const ControlCommand& pParameters) throw (Exception)
 {
 	try
 	{
@@ -826,7 +1003,7 @@ OscControl::setDisplayPosition(const std::vector< std::shared_ptr<_OscArg> >& pP
 }
 
 void 
-OscControl::setDisplayOrientation(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setDisplayOrientation(const ControlCommand& pParameters) throw (Exception)
 {
 	try
 	{
@@ -849,7 +1026,7 @@ OscControl::setDisplayOrientation(const std::vector< std::shared_ptr<_OscArg> >&
 }
 
 void 
-OscControl::changeDisplayOrientation(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::changeDisplayOrientation(const ControlCommand& pParameters) throw (Exception)
 {
 	try
 	{
@@ -872,7 +1049,7 @@ OscControl::changeDisplayOrientation(const std::vector< std::shared_ptr<_OscArg>
 }
 
 void 
-OscControl::setDisplayZoom(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setDisplayZoom(const ControlCommand& pParameters) throw (Exception)
 {
 	try
 	{
@@ -891,7 +1068,7 @@ OscControl::setDisplayZoom(const std::vector< std::shared_ptr<_OscArg> >& pParam
 }
 
 void
-OscControl::setAgentColor(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setAgentColor(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -919,7 +1096,7 @@ OscControl::setAgentColor(const std::vector< std::shared_ptr<_OscArg> >& pParame
 }
 
 void
-OscControl::setAgentScale(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setAgentScale(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -956,7 +1133,7 @@ OscControl::setAgentScale(const std::vector< std::shared_ptr<_OscArg> >& pParame
 }
 
 void
-OscControl::setAgentLineWidth(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setAgentLineWidth(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -978,7 +1155,7 @@ OscControl::setAgentLineWidth(const std::vector< std::shared_ptr<_OscArg> >& pPa
 }
 
 void
-OscControl::setTrailColor(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setTrailColor(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -1006,7 +1183,7 @@ OscControl::setTrailColor(const std::vector< std::shared_ptr<_OscArg> >& pParame
 }
 
 void
-OscControl::setTrailLength(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setTrailLength(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -1028,7 +1205,7 @@ OscControl::setTrailLength(const std::vector< std::shared_ptr<_OscArg> >& pParam
 }
 
 void
-OscControl::setTrailDecay(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setTrailDecay(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -1050,7 +1227,7 @@ OscControl::setTrailDecay(const std::vector< std::shared_ptr<_OscArg> >& pParame
 }
 
 void
-OscControl::setTrailLineWidth(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception)
+OscControl::setTrailLineWidth(const ControlCommand& pParameters) throw (Exception)
 {
     try
     {
@@ -17,7 +17,10 @@
 #include "dab_space_alg_grid.h"
 #include "dab_flock_behavior.h"
 #include "dab_flock_add_space_event.h"
-#include "ofTypes.h"
+#include "dab_flock_control_queue.h"
+#include <unordered_map>
+#include <functional>
+#include <mutex>
 
 namespace dab
 {
@@ -30,17 +33,87 @@ class Event;
 namespace flock
 {
 
+class SetParameterEvent;
+
 class OscControl : public Singleton<OscControl>, public OscListener
 {
 public:
+    typedef std::function<void(const ControlCommand&)> CommandHandler; /// \brief command handler, may throw Exception
+    
     OscControl();
     OscControl( std::shared_ptr<OscSender> pErrorSender );
     ~OscControl();
     
     void setErrorSender( std::shared_ptr<OscSender> pErrorSender );
     
+    /**
+     \brief queue osc message for execution by the simulation thread (called by the osc receiver)
+     \param pMessage osc message
+     */
     virtual void notify(std::shared_ptr<OscMessage> pMessage);
     
+    /**
+     \brief add command, replaces the handler if a command with the same address exists
+     \param pAddress osc address
+     \param pHandler command handler (called by the simulation thread)
+     */
+    void addCommand( const std::string& pAddress, CommandHandler pHandler );
+    
+    /**
+     \brief remove command
+     \param pAddress osc address
+     */
+    void removeCommand( const std::string& pAddress );
+    
+    /**
+     \brief check whether command exists
+     \param pAddress osc address
+     \return true if command exists
+     */
+    bool checkCommand( const std::string& pAddress );
+    
+    /**
+     \brief execute queued commands (called by FlockCom at the beginning of each simulation step)
+     
+     at most as many commands as the queue can hold are executed per call, a failing command is reported and does not affect the others
+     */
+    void update();
+    
+    /**
+     \brief return number of received messages
+     \return number of messages received since the last counter reset
+     */
+    unsigned long receivedCommandCount() const;
+    
+    /**
+     \brief return number of dropped messages
+     \return number of messages dropped because the command queue was full since the last counter reset
+     */
+    unsigned long droppedCommandCount() const;
+    
+    /**
+     \brief return number of failed commands
+     \return number of commands that threw an exception since the last counter reset
+     */
+    unsigned long failedCommandCount() const;
+    
+    /**
+     \brief return maximum command queue length
+     \return largest number of commands that have been waiting at the same time since the last counter reset
+     */
+    unsigned int maxQueuedCommandCount() const;
+    
+    /**
+     \brief return number of coalesced set parameter commands
+     \return number of /SetParameter commands that have been replaced by a later command for the same swarm, parameter and agent range within the same step since the last counter reset
+     */
+    unsigned long coalescedCommandCount() const;
+    
+    /**
+     \brief reset command counters
+     */
+    void resetCommandCounters();
+    
 protected:
     std::shared_ptr<OscSender> mErrorSender;
     
@@ -49,22 +122,83 @@ protected:
     std::map< std::string, space::GridAlg::GridUpdateMode > mGridUpdateModeMap;
     std::map< std::string, Behavior* > mBehaviorMap;
     
-    ofMutex mLock;
+    /**
+     \brief swarm, parameter and agent range targeted by a set parameter command
+     */
+    class SetParameterTarget
+    {
+    public:
+        unsigned int mSwarmId; /// \brief swarm symbol id
+        unsigned int mParameterId; /// \brief parameter symbol id
+        int mAgentRangeStartIndex; /// \brief first agent index (-1: swarm parameter and all agents)
+        int mAgentRangeEndIndex; /// \brief last agent index (-1: swarm parameter and all agents)
+        
+        bool operator==(const SetParameterTarget& pTarget) const;
+    };
+    
+    /**
+     \brief hash of set parameter target
+     */
+    class SetParameterTargetHash
+    {
+    public:
+        size_t operator()(const SetParameterTarget& pTarget) const;
+    };
+    
+    /**
+     \brief command of dispatch table
+     */
+    class Command
+    {
+    public:
+        CommandHandler mHandler; /// \brief command handler
+    };
+    
+    std::unordered_map< std::string, std::shared_ptr<Command> > mCommandTable; /// \brief commands by osc address
+    std::mutex mCommandLock; /// \brief guards the dispatch table, commands can be added from any thread
+    
+    ControlQueue mCommands; /// \brief commands waiting for execution
+    std::atomic<unsigned long> mFailedCommandCount; /// \brief number of commands that threw an exception
+    std::atomic<unsigned long> mCoalescedCommandCount; /// \brief number of set parameter commands that have been replaced by a later one
+    
+    std::vector< std::shared_ptr<SetParameterEvent> > mPendingSetParameterEvents; /// \brief set parameter events of current step in order of arrival (replaced events are nullptr)
+    std::unordered_map<SetParameterTarget, unsigned int, SetParameterTargetHash> mPendingSetParameterIndices; /// \brief index of pending set parameter event by target
     
     void initCreationMaps();
     space::SpaceAlgType spaceAlgType( const std::string& pSpaceAlgType ) throw (Exception);
     space::GridAlg::GridNeighborMode gridNeighborMode( const std::string& pGridNeighborMode ) throw (Exception);
     space::GridAlg::GridUpdateMode gridUpdateMode( const std::string& pGridUpdateMode ) throw (Exception);
     
-    void groupOscArgs( std::shared_ptr<OscMessage> pMessage, std::vector< std::shared_ptr<_OscArg> >& pGroupedArgs );
+    /**
+     \brief add built-in commands to dispatch table
+     */
+    void initCommandTable();
     
+    /**
+     \brief look up and execute command, failures are counted and reported
+     \param pCommand command
+     */
+    void execute( const ControlCommand& pCommand );
+    
+    /**
+     \brief hold back set parameter event until the end of the step, replaces a pending event with the same target
+     \param pEvent set parameter event
+     */
+    void addSetParameterEvent( std::shared_ptr<SetParameterEvent> pEvent );
+    
+    /**
+     \brief pass pending set parameter events to the event manager in order of arrival
+     */
+    void flushSetParameterEvents();
     
     void clearSimulation( ) throw (Exception);
-    void restoreSimulation(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void saveSimulation(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void setSimulationRate(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void freezeSimulation(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void addSpace(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
+    void restoreSimulation(const ControlCommand& pParameters) throw (Exception);
+    void saveSimulation(const ControlCommand& pParameters) throw (Exception);
+    void setSimulationRate(const ControlCommand& pParameters) throw (Exception);
+    void freezeSimulation(const ControlCommand& pParameters) throw (Exception);
+    void setThreadCount(const ControlCommand& pParameters) throw (Exception);
+    void setProfiling(const ControlCommand& pParameters) throw (Exception);
+    void addSpace(const ControlCommand& pParameters) throw (Exception);
 //    void removeSpace(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void addSender(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void removeSender(std::vector<_OscArg*>& pParameters()) throw (Exception);
@@ -72,37 +206,38 @@ protected:
 //    void removeReceiver(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void addSwarm(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void removeSwarm(std::vector<_OscArg*>& pParameters()) throw (Exception);
-    void addAgents(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void removeAgents(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
+    void addAgents(const ControlCommand& pParameters) throw (Exception);
+    void removeAgents(const ControlCommand& pParameters) throw (Exception);
 //    void addParameter(std::vector<_OscArg*>& pParameters()) throw (Exception);
-    void setParameter(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
+    void setParameter(const ControlCommand& pParameters) throw (Exception);
+    void setAgentParameters(const ControlCommand& pParameters) throw (Exception);
 //    void randomizeParameter(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void removeParameter(std::vector<_OscArg*>& pParameters()) throw (Exception);
-	void assignNeighbors(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
+	void assignNeighbors(const ControlCommand& pParameters) throw (Exception);
 //    void removeNeigbors(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void registerParameter(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void deregisterParameter(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void addBehavior(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void moveBehavior(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void removeBehavior(std::vector<_OscArg*>& pParameters()) throw (Exception);
-    void showSwarm(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void hideSwarm(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void showSpace(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void hideSpace(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
+    void showSwarm(const ControlCommand& pParameters) throw (Exception);
+    void hideSwarm(const ControlCommand& pParameters) throw (Exception);
+    void showSpace(const ControlCommand& pParameters) throw (Exception);
+    void hideSpace(const ControlCommand& pParameters) throw (Exception);
 //    void setDisplayColor(std::vector<_OscArg*>& pParameters()) throw (Exception);
-	void setDisplayPosition(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-	void setDisplayOrientation(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-	void changeDisplayOrientation(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-	void setDisplayZoom(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
+	void setDisplayPosition(const ControlCommand& pParameters) throw (Exception);
+	void setDisplayOrientation(const ControlCommand& pParameters) throw (Exception);
+	void changeDisplayOrientation(const ControlCommand& pParameters) throw (Exception);
+	void setDisplayZoom(const ControlCommand& pParameters) throw (Exception);
 //    void setWindowSettings(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    virtual void toggleFullScreen( ) throw (Exception);
-    void setAgentColor(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void setAgentScale(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void setAgentLineWidth(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void setTrailColor(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void setTrailLength(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void setTrailDecay(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
-    void setTrailLineWidth(const std::vector< std::shared_ptr<_OscArg> >& pParameters) throw (Exception);
+    void setAgentColor(const ControlCommand& pParameters) throw (Exception);
+    void setAgentScale(const ControlCommand& pParameters) throw (Exception);
+    void setAgentLineWidth(const ControlCommand& pParameters) throw (Exception);
+    void setTrailColor(const ControlCommand& pParameters) throw (Exception);
+    void setTrailLength(const ControlCommand& pParameters) throw (Exception);
+    void setTrailDecay(const ControlCommand& pParameters) throw (Exception);
+    void setTrailLineWidth(const ControlCommand& pParameters) throw (Exception);
 //    void setSpaceColor(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void setSpaceValueScale(std::vector<_OscArg*>& pParameters()) throw (Exception);
 //    void saveImage(std::vector<_OscArg*>& pParameters()) throw (Exception);
@@ -0,0 +1,365 @@
+/** \file dab_flock_osc_output.cpp
+ */
+
+#include "dab_flock_osc_output.h"
+#include "dab_osc_message.h"
+#include "dab_flock_simulation.h"
+#include "ofFileUtils.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace dab;
+using namespace dab::flock;
+
+OscOutput::OscOutput(unsigned int pQueueSize)
+: mQueueSize( std::max<unsigned int>(pQueueSize, 1) )
+, mRequestedQueueSize( mQueueSize )
+, mLateThreshold( 20.0 )
+, mQueueStart( 0 )
+, mQueueCount( 0 )
+, mFillFrame( -1 )
+, mSentFrameCount( 0 )
+, mDroppedFrameCount( 0 )
+, mLateFrameCount( 0 )
+, mRunning( false )
+, mTerminated( false )
+{
+	resetFrames();
+}
+
+OscOutput::~OscOutput()
+{
+	stop();
+}
+
+unsigned int
+OscOutput::queueSize() const
+{
+	return mRequestedQueueSize;
+}
+
+void
+OscOutput::setQueueSize(unsigned int pQueueSize)
+{
+	// the simulation thread might be filling a frame, the frames are therefore only reallocated when the next frame begins
+	mRequestedQueueSize = std::max<unsigned int>(pQueueSize, 1);
+}
+
+double
+OscOutput::lateThreshold() const
+{
+	return mLateThreshold;
+}
+
+void
+OscOutput::setLateThreshold(double pLateThreshold)
+{
+	mLateThreshold = pLateThreshold;
+}
+
+unsigned long
+OscOutput::sentFrameCount()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mSentFrameCount;
+}
+
+unsigned long
+OscOutput::droppedFrameCount()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mDroppedFrameCount;
+}
+
+unsigned long
+OscOutput::lateFrameCount()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mLateFrameCount;
+}
+
+void
+OscOutput::resetCounters()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+
+	mSentFrameCount = 0;
+	mDroppedFrameCount = 0;
+	mLateFrameCount = 0;
+}
+
+bool
+OscOutput::running() const
+{
+	return mRunning;
+}
+
+void
+OscOutput::start()
+{
+	if( mRunning == true ) return;
+
+	mTerminated = false;
+	mRunning = true;
+	mThread = std::thread( &OscOutput::work, this );
+}
+
+void
+OscOutput::stop()
+{
+	if( mRunning == false ) return;
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mTerminated = true;
+	}
+
+	mCondition.notify_one();
+	mThread.join();
+	mRunning = false;
+
+	// discard queued frames, a frame that is being filled is kept
+	std::lock_guard<std::mutex> lock( mMutex );
+
+	for(unsigned int qI=0; qI<mQueueCount; ++qI) mFreeFrames.push_back( mQueuedFrames[ ( mQueueStart + qI ) % mQueueSize ] );
+	mQueueStart = 0;
+	mQueueCount = 0;
+}
+
+std::mutex&
+OscOutput::sendLock()
+{
+	return mSendLock;
+}
+
+void
+OscOutput::beginFrame()
+{
+	if( mFillFrame >= 0 ) return;
+
+	unsigned int requestedQueueSize = mRequestedQueueSize;
+
+	if( requestedQueueSize != mQueueSize )
+	{
+		bool running = mRunning;
+
+		stop();
+		mQueueSize = requestedQueueSize;
+		resetFrames();
+		if( running == true ) start();
+	}
+
+	std::lock_guard<std::mutex> lock( mMutex );
+
+	// endFrame keeps at most mQueueSize frames queued and the sender thread holds at most one, one frame is therefore always free
+	assert( mFreeFrames.empty() == false );
+
+	mFillFrame = mFreeFrames.back();
+	mFreeFrames.pop_back();
+
+	Frame& frame = mFrames[mFillFrame];
+	frame.mEntries.clear();
+	frame.mValues.clear();
+}
+
+bool
+OscOutput::filling() const
+{
+	return mFillFrame >= 0;
+}
+
+float*
+OscOutput::addValues(std::shared_ptr<OscSender> pSender, const std::shared_ptr< const std::vector<std::string> >& pAddresses, bool pExtendedOscMode, unsigned int pParameterCount, unsigned int pGroupSize, unsigned int pSendDim)
+{
+	Frame& frame = mFrames[mFillFrame];
+
+	unsigned int valueIndex = frame.mValues.size();
+	frame.mValues.resize( valueIndex + pParameterCount * pSendDim );
+
+	frame.mEntries.resize( frame.mEntries.size() + 1 );
+	Entry& entry = frame.mEntries.back();
+	entry.mSender = pSender;
+	entry.mAddresses = pAddresses;
+	entry.mExtendedOscMode = pExtendedOscMode;
+	entry.mValueIndex = valueIndex;
+	entry.mParameterCount = pParameterCount;
+	entry.mGroupSize = std::max<unsigned int>(pGroupSize, 1);
+	entry.mSendDim = pSendDim;
+	entry.mPacked = false;
+
+	return frame.mValues.data() + valueIndex;
+}
+
+float*
+OscOutput::addPackedValues(std::shared_ptr<OscSender> pSender, const std::shared_ptr< const std::vector<std::string> >& pAddresses, ValuePacker::Format pFormat, unsigned int pSequence, unsigned int pAgentOffset, unsigned int pAgentCount, unsigned int pSendDim, unsigned int pMaxBlobSize)
+{
+	float* values = addValues( pSender, pAddresses, false, pAgentCount, pAgentCount, pSendDim );
+
+	Entry& entry = mFrames[mFillFrame].mEntries.back();
+	entry.mPacked = true;
+	entry.mPackFormat = pFormat;
+	entry.mPackSequence = pSequence;
+	entry.mAgentOffset = pAgentOffset;
+	entry.mMaxBlobSize = pMaxBlobSize;
+
+	return values;
+}
+
+void
+OscOutput::endFrame()
+{
+	if( mFillFrame < 0 ) return;
+
+	Frame& frame = mFrames[mFillFrame];
+	frame.mTime = Clock::now();
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+
+		if( frame.mEntries.empty() == true ) mFreeFrames.push_back(mFillFrame);
+		else
+		{
+			// queue is full, drop oldest frame
+			if( mQueueCount == mQueueSize )
+			{
+				mFreeFrames.push_back( mQueuedFrames[mQueueStart] );
+				mQueueStart = ( mQueueStart + 1 ) % mQueueSize;
+				mQueueCount--;
+				mDroppedFrameCount++;
+			}
+
+			mQueuedFrames[ ( mQueueStart + mQueueCount ) % mQueueSize ] = mFillFrame;
+			mQueueCount++;
+		}
+	}
+
+	mFillFrame = -1;
+	mCondition.notify_one();
+}
+
+void
+OscOutput::resetFrames()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+
+	// one frame is filled by the simulation thread and one is sent by the sender thread while the queue is full
+	unsigned int frameCount = mQueueSize + 2;
+
+	mFrames.clear();
+	mFrames.resize( frameCount );
+	mFreeFrames.clear();
+	for(unsigned int fI=0; fI<frameCount; ++fI) mFreeFrames.push_back( frameCount - 1 - fI );
+	mQueuedFrames.assign( mQueueSize, 0 );
+	mQueueStart = 0;
+	mQueueCount = 0;
+	mFillFrame = -1;
+}
+
+void
+OscOutput::work()
+{
+	while( true )
+	{
+		unsigned int frameIndex;
+
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			mCondition.wait( lock, [this]{ return mTerminated == true || mQueueCount > 0; } );
+
+			if( mTerminated == true ) return;
+
+			frameIndex = mQueuedFrames[mQueueStart];
+			mQueueStart = ( mQueueStart + 1 ) % mQueueSize;
+			mQueueCount--;
+		}
+
+		Frame& frame = mFrames[frameIndex];
+		bool late = std::chrono::duration<double, std::milli>( Clock::now() - frame.mTime ).count() > mLateThreshold;
+
+		sendFrame( frame );
+
+		// release senders
+		frame.mEntries.clear();
+
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+
+			mFreeFrames.push_back( frameIndex );
+			mSentFrameCount++;
+			if( late == true ) mLateFrameCount++;
+		}
+	}
+}
+
+void
+OscOutput::sendFrame(Frame& pFrame)
+{
+	unsigned int entryCount = pFrame.mEntries.size();
+
+	for(unsigned int eI=0; eI<entryCount; ++eI)
+	{
+		const Entry& entry = pFrame.mEntries[eI];
+		const std::vector<std::string>& addresses = *entry.mAddresses;
+		unsigned int groupCount = addresses.size();
+		const float* values = pFrame.mValues.data() + entry.mValueIndex;
+
+		if( entry.mPacked == true )
+		{
+			sendPacked( entry, values );
+			continue;
+		}
+
+		for(unsigned int gI=0, pI=0; gI<groupCount && pI<entry.mParameterCount; ++gI)
+		{
+			unsigned int parameterCount = std::min( entry.mGroupSize, entry.mParameterCount - pI );
+			unsigned int valueCount = parameterCount * entry.mSendDim;
+
+			try
+			{
+				std::shared_ptr<OscMessage> message(new OscMessage());
+				message->setAddress( addresses[gI] );
+
+				if( entry.mExtendedOscMode == true ) message->add( values, valueCount );
+				else for(unsigned int vI=0; vI<valueCount; ++vI) message->add( values[vI] );
+
+				std::lock_guard<std::mutex> lock( mSendLock );
+				entry.mSender->send( message );
+			}
+			catch(Exception& e)
+			{
+				Simulation::get().exceptionReport( e );
+			}
+
+			values += valueCount;
+			pI += parameterCount;
+		}
+	}
+}
+
+void
+OscOutput::sendPacked(const Entry& pEntry, const float* pValues)
+{
+	try
+	{
+		const std::string& address = (*pEntry.mAddresses)[0];
+
+		mPacker.pack( pEntry.mPackFormat, pEntry.mPackSequence, pEntry.mAgentOffset, pEntry.mParameterCount, pEntry.mSendDim, pValues, pEntry.mMaxBlobSize );
+
+		unsigned int blobCount = mPacker.blobCount();
+		for(unsigned int bI=0; bI<blobCount; ++bI)
+		{
+			const std::vector<char>& blob = mPacker.blob(bI);
+
+			std::shared_ptr<OscMessage> message(new OscMessage());
+			message->setAddress( address );
+			message->add( ofBuffer( blob.data(), blob.size() ) );
+
+			std::lock_guard<std::mutex> lock( mSendLock );
+			pEntry.mSender->send( message );
+		}
+	}
+	catch(Exception& e)
+	{
+		Simulation::get().exceptionReport( e );
+	}
+}
@@ -0,0 +1,248 @@
+/** \file dab_flock_osc_output.h
+ *  \class dab::flock::OscOutput asynchronous osc output stage
+ *  \brief asynchronous osc output stage
+ *
+ *  The simulation thread writes the send values of all registered parameters into a frame. Frames are passed through a bounded queue to a sender thread which creates and sends the osc messages.\n
+ *  Frames are preallocated and reused. If the queue is full (e.g. because the network stalls) the oldest queued frame is dropped.\n
+ *  OSC senders are not thread safe, the sender thread therefore holds a send lock while it sends a message. Other threads that send with the same senders take the same lock (see FlockCom::sendMessage).\n
+ */
+
+#ifndef _dab_flock_osc_output_h_
+#define _dab_flock_osc_output_h_
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include "dab_exception.h"
+#include "dab_osc_sender.h"
+#include "dab_flock_value_packer.h"
+
+namespace dab
+{
+
+namespace flock
+{
+
+class OscOutput
+{
+public:
+    /**
+     \brief create output stage
+     \param pQueueSize maximum number of frames waiting to be sent
+     */
+    OscOutput(unsigned int pQueueSize = 4);
+
+    /**
+     \brief destructor
+     */
+    ~OscOutput();
+
+    /**
+     \brief return maximum number of frames waiting to be sent
+     \return queue size
+     */
+    unsigned int queueSize() const;
+
+    /**
+     \brief set maximum number of frames waiting to be sent
+     \param pQueueSize queue size
+
+     the size is applied by the simulation thread when it begins the next frame, this stops and restarts the sender thread and discards queued frames
+     */
+    void setQueueSize(unsigned int pQueueSize);
+
+    /**
+     \brief return delay after which a frame counts as late
+     \return late threshold (milliseconds)
+     */
+    double lateThreshold() const;
+
+    /**
+     \brief set delay after which a frame counts as late
+     \param pLateThreshold late threshold (milliseconds)
+     */
+    void setLateThreshold(double pLateThreshold);
+
+    /**
+     \brief return number of sent frames
+     \return number of sent frames
+     */
+    unsigned long sentFrameCount();
+
+    /**
+     \brief return number of frames dropped because the queue was full
+     \return number of dropped frames
+     */
+    unsigned long droppedFrameCount();
+
+    /**
+     \brief return number of frames whose sending started later than the late threshold after they had been created
+     \return number of late frames
+     */
+    unsigned long lateFrameCount();
+
+    /**
+     \brief reset frame counters
+     */
+    void resetCounters();
+
+    /**
+     \brief check whether sender thread is running
+     \return true if sender thread is running
+     */
+    bool running() const;
+
+    /**
+     \brief start sender thread
+     */
+    void start();
+
+    /**
+     \brief stop sender thread, queued frames are discarded
+     */
+    void stop();
+
+    /**
+     \brief return lock that serializes sending
+     \return send lock
+     
+     osc senders are not thread safe, the sender thread holds this lock while sending a message and other threads need to hold it when they send with the same senders
+     */
+    std::mutex& sendLock();
+
+    /**
+     \brief begin new frame (called by the simulation thread)
+     */
+    void beginFrame();
+
+    /**
+     \brief check whether a frame is being filled
+     \return true if a frame is being filled
+     */
+    bool filling() const;
+
+    /**
+     \brief add values of one parameter registration to the current frame (called by the simulation thread)
+     \param pSender osc sender
+     \param pAddresses osc address per agent group
+     \param pExtendedOscMode use extended osc protocol
+     \param pParameterCount total number of parameters
+     \param pGroupSize number of parameters per agent group
+     \param pSendDim number of send values per parameter
+     \return storage for pParameterCount * pSendDim values, only valid until the next call
+
+     the values of agent group i start at i * pGroupSize * pSendDim
+     */
+    float* addValues(std::shared_ptr<OscSender> pSender, const std::shared_ptr< const std::vector<std::string> >& pAddresses, bool pExtendedOscMode, unsigned int pParameterCount, unsigned int pGroupSize, unsigned int pSendDim);
+
+    /**
+     \brief add values of one packed parameter registration to the current frame (called by the simulation thread)
+     \param pSender osc sender
+     \param pAddresses osc address (first element)
+     \param pFormat value format
+     \param pSequence sequence number
+     \param pAgentOffset index of first agent
+     \param pAgentCount number of agents
+     \param pSendDim number of send values per agent
+     \param pMaxBlobSize maximum blob size in bytes
+     \return storage for pAgentCount * pSendDim values, only valid until the next call
+     */
+    float* addPackedValues(std::shared_ptr<OscSender> pSender, const std::shared_ptr< const std::vector<std::string> >& pAddresses, ValuePacker::Format pFormat, unsigned int pSequence, unsigned int pAgentOffset, unsigned int pAgentCount, unsigned int pSendDim, unsigned int pMaxBlobSize);
+
+    /**
+     \brief finish current frame and queue it for sending (called by the simulation thread)
+     */
+    void endFrame();
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     \brief values of one parameter registration
+     */
+    class Entry
+    {
+    public:
+        std::shared_ptr<OscSender> mSender; /// \brief osc sender
+        std::shared_ptr< const std::vector<std::string> > mAddresses; /// \brief osc address per agent group
+        bool mExtendedOscMode; /// \brief use extended osc protocol
+        unsigned int mValueIndex; /// \brief index of first value in frame
+        unsigned int mParameterCount; /// \brief total number of parameters
+        unsigned int mGroupSize; /// \brief number of parameters per agent group
+        unsigned int mSendDim; /// \brief number of send values per parameter
+        bool mPacked; /// \brief values are sent in packed blobs
+        ValuePacker::Format mPackFormat; /// \brief format of packed values
+        unsigned int mPackSequence; /// \brief sequence number of packed values
+        unsigned int mAgentOffset; /// \brief index of first agent of packed values
+        unsigned int mMaxBlobSize; /// \brief maximum blob size in bytes
+    };
+
+    /**
+     \brief values of all parameter registrations of one simulation step
+     */
+    class Frame
+    {
+    public:
+        std::vector<Entry> mEntries; /// \brief entries
+        std::vector<float> mValues; /// \brief send values of all entries
+        Clock::time_point mTime; /// \brief time at which the frame has been completed
+    };
+
+    unsigned int mQueueSize; /// \brief maximum number of queued frames
+    std::atomic<unsigned int> mRequestedQueueSize; /// \brief queue size that is applied when the next frame begins
+    double mLateThreshold; /// \brief delay after which a frame counts as late (milliseconds)
+
+    std::vector<Frame> mFrames; /// \brief preallocated frames (queue size + the one being filled + the one being sent)
+    std::vector<unsigned int> mFreeFrames; /// \brief indices of unused frames
+    std::vector<unsigned int> mQueuedFrames; /// \brief ring of indices of frames waiting to be sent
+    unsigned int mQueueStart; /// \brief ring index of oldest queued frame
+    unsigned int mQueueCount; /// \brief number of queued frames
+    int mFillFrame; /// \brief index of frame being filled (-1: none)
+
+    unsigned long mSentFrameCount; /// \brief number of sent frames
+    unsigned long mDroppedFrameCount; /// \brief number of dropped frames
+    unsigned long mLateFrameCount; /// \brief number of late frames
+
+    ValuePacker mPacker; /// \brief packer used by the sender thread
+
+    std::thread mThread; /// \brief sender thread
+    bool mRunning; /// \brief sender thread running
+    bool mTerminated; /// \brief sender thread termination flag
+    std::mutex mMutex; /// \brief guards the queue and counters
+    std::condition_variable mCondition; /// \brief signals the sender thread that a frame has been queued
+    std::mutex mSendLock; /// \brief serializes sending of messages
+
+    /**
+     \brief allocate frames and clear queue (only while no frame is being filled)
+     */
+    void resetFrames();
+
+    /**
+     \brief sender thread loop
+     */
+    void work();
+
+    /**
+     \brief create and send osc messages of frame
+     \param pFrame frame
+     */
+    void sendFrame(Frame& pFrame);
+
+    /**
+     \brief pack values of entry and send them as osc blobs
+     \param pEntry entry
+     \param pValues values of entry
+     */
+    void sendPacked(const Entry& pEntry, const float* pValues);
+};
+
+};
+
+};
+
+#endif
@@ -196,11 +196,11 @@ Parameter::randomize(float pMinParameterValue, float pMaxParameterValue)
 {
 	if( isnan( pMinParameterValue ) == true || isnan( pMaxParameterValue ) == true ) return;
     
-	math::Math<>& math = math::Math<>::get();
+	RandomStream random = Simulation::get().randomStream( RandomStream::streamId( mName ) );
     
 	for(unsigned int d=0; d<mDim; ++d)
 	{
-		mBackupValues[d] = math.random( pMinParameterValue, pMaxParameterValue );
+		mBackupValues[d] = random.uniform( pMinParameterValue, pMaxParameterValue );
 	}
 }
 
@@ -210,14 +210,14 @@ Parameter::randomize(const std::initializer_list<float>& pMinParameterValues, co
     if(pMinParameterValues.size() != mDim) throw Exception( "FLOCK ERROR: valueCount mismatch: " + std::to_string(mDim) + " != " + std::to_string(pMinParameterValues.size()) + " for parameter " + mName, __FILE__, __FUNCTION__, __LINE__ );
 	if(pMaxParameterValues.size() != mDim) throw Exception( "FLOCK ERROR: valueCount mismatch: " + std::to_string(mDim) + " != " + std::to_string(pMaxParameterValues.size()) + " for parameter " + mName, __FILE__, __FUNCTION__, __LINE__ );
     
-	math::Math<>& math = math::Math<>::get();
+	RandomStream random = Simulation::get().randomStream( RandomStream::streamId( mName ) );
     
     auto minIter = pMinParameterValues.begin();
     auto maxIter = pMaxParameterValues.begin();
     
     for(int d=0; d<mDim; ++d, ++minIter, ++maxIter)
     {
-        if( isnan( *minIter ) == false && isnan( *maxIter ) == false ) mBackupValues[d] = math.random( *minIter, *maxIter );
+        if( isnan( *minIter ) == false && isnan( *maxIter ) == false ) mBackupValues[d] = random.uniform( *minIter, *maxIter );
     }
 }
 
@@ -227,12 +227,8 @@ Parameter::randomize(const Eigen::VectorXf& pMinParameterValues, const Eigen::Ve
     if(pMinParameterValues.rows() != mDim) throw Exception( "FLOCK ERROR: valueCount mismatch: " + std::to_string(mDim) + " != " + std::to_string(pMinParameterValues.rows()) + " for parameter " + mName, __FILE__, __FUNCTION__, __LINE__ );
 	if(pMaxParameterValues.rows() != mDim) throw Exception( "FLOCK ERROR: valueCount mismatch: " + std::to_string(mDim) + " != " + std::to_string(pMaxParameterValues.rows()) + " for parameter " + mName, __FILE__, __FUNCTION__, __LINE__ );
 
-	math::Math<>& math = math::Math<>::get();
-    
-	for(unsigned int d=0; d<mDim; ++d)
-	{
-		mBackupValues[d] = math.random( pMinParameterValues[d], pMaxParameterValues[d] );
-	}
+	RandomStream random = Simulation::get().randomStream( RandomStream::streamId( mName ) );
+	random.fill( mBackupValues, pMinParameterValues, pMaxParameterValues );
 }
 
 Agent*
@@ -244,9 +240,9 @@ Parameter::agent()
 void
 Parameter::flush()
 {
-    //	mValues = mBackupValues;
-	
-	for(unsigned int d=0; d<mDim; ++d) mValues[d] = mBackupValues[d];
+	// both vectors have the same size, the assignment is a vectorized copy without reallocation
+	// the buffers aren't swapped since neighbor spaces may refer to the value storage
+	mValues = mBackupValues;
     
 	unsigned int neighborListCount = mNeighborLists.size();
 	for(unsigned int i=0; i<neighborListCount; ++i) mNeighborLists[i]->setValues(mValues);
@@ -334,6 +334,8 @@ protected:
 	
 	/**
      \brief parameter values
+     
+     the values are the position of the space object of this parameter, they can therefore not be stored in a contiguous block shared by the agents of a swarm
      */
 	Eigen::VectorXf& mValues;
 	
@@ -24,6 +24,7 @@ ParameterList::~ParameterList()
 	}
 	
 	mParameters.clear();
+	mSymbolSlots.clear();
 }
 
 unsigned int
@@ -52,6 +53,21 @@ ParameterList::parameterIndex(const std::string& pName) const throw (Exception)
 	}
 }
 
+bool
+ParameterList::contains(const Symbol& pSymbol) const
+{
+	return symbolSlot( pSymbol.id() ) >= 0;
+}
+
+unsigned int
+ParameterList::parameterIndex(const Symbol& pSymbol) const throw (Exception)
+{
+	int slot = symbolSlot( pSymbol.id() );
+	if( slot < 0 ) throw Exception( "FLOCK ERROR: parameter " + pSymbol.name() + " not found", __FILE__, __FUNCTION__, __LINE__ );
+	
+	return mSymbolSlots[slot].second;
+}
+
 Parameter*
 ParameterList::parameter(unsigned int pIndex) throw (Exception)
 {
@@ -84,12 +100,31 @@ ParameterList::parameter(const std::string& pName) const throw (Exception)
 	return mParameters[pName];
 }
 
+Parameter*
+ParameterList::parameter(const Symbol& pSymbol) throw (Exception)
+{
+	int slot = symbolSlot( pSymbol.id() );
+	if( slot < 0 ) throw Exception( "FLOCK ERROR: parameter name " + pSymbol.name() + " not found", __FILE__, __FUNCTION__, __LINE__ );
+	
+	return mParameters[ mSymbolSlots[slot].second ];
+}
+
+const Parameter*
+ParameterList::parameter(const Symbol& pSymbol) const throw (Exception)
+{
+	int slot = symbolSlot( pSymbol.id() );
+	if( slot < 0 ) throw Exception( "FLOCK ERROR: parameter name " + pSymbol.name() + " not found", __FILE__, __FUNCTION__, __LINE__ );
+	
+	return mParameters[ mSymbolSlots[slot].second ];
+}
+
 void
 ParameterList::addParameter(Parameter* pParameter) throw (Exception)
 {
     if( mParameters.contains(pParameter->name()) == true ) throw Exception( "FLOCK ERROR: parameter name " + pParameter->name() + " already exists", __FILE__, __FUNCTION__, __LINE__ );
     
 	mParameters.add(pParameter->name(), pParameter);
+	addSymbolSlot( pParameter->name(), mParameters.size() - 1 );
 }
 
 void
@@ -99,6 +134,7 @@ ParameterList::addParameter(Agent* pAgent, const std::string& pName, unsigned in
     
 	Parameter* par = new Parameter(pAgent, pName, pDim);
 	mParameters.add(pName, par);
+	addSymbolSlot( pName, mParameters.size() - 1 );
 }
 
 void
@@ -108,10 +144,71 @@ ParameterList::removeParameter(const std::string& pName) throw (Exception)
 
 	Parameter* par = mParameters[pName];
 	mParameters.remove(pName);
+	updateSymbolSlots();
     
 	delete par;
 }
 
+int
+ParameterList::symbolSlot(unsigned int pSymbolId) const
+{
+	unsigned int slotCount = mSymbolSlots.size();
+	if( slotCount == 0 ) return -1;
+	
+	unsigned int mask = slotCount - 1;
+	unsigned int key = pSymbolId + 1;
+	
+	for(unsigned int slot = ( pSymbolId * 2654435761u ) & mask; ; slot = ( slot + 1 ) & mask)
+	{
+		if( mSymbolSlots[slot].first == key ) return slot;
+		if( mSymbolSlots[slot].first == 0 ) return -1;
+	}
+}
+
+void
+ParameterList::addSymbolSlot(const std::string& pName, unsigned int pIndex)
+{
+	// keep a load factor of at most one half
+	if( mParameters.size() * 2 > mSymbolSlots.size() )
+	{
+		updateSymbolSlots();
+		return;
+	}
+	
+	unsigned int symbolId = SymbolTable::get().id( pName );
+	unsigned int mask = mSymbolSlots.size() - 1;
+	unsigned int slot = ( symbolId * 2654435761u ) & mask;
+	
+	while( mSymbolSlots[slot].first != 0 ) slot = ( slot + 1 ) & mask;
+	
+	mSymbolSlots[slot] = std::make_pair( symbolId + 1, pIndex );
+}
+
+void
+ParameterList::updateSymbolSlots()
+{
+	unsigned int parameterCount = mParameters.size();
+	
+	// power of two with room to grow before the next rebuild
+	unsigned int slotCount = 16;
+	while( slotCount < parameterCount * 4 ) slotCount *= 2;
+	
+	mSymbolSlots.assign( slotCount, std::make_pair( 0u, 0u ) );
+	
+	SymbolTable& symbolTable = SymbolTable::get();
+	unsigned int mask = slotCount - 1;
+	
+	for(unsigned int pI=0; pI<parameterCount; ++pI)
+	{
+		unsigned int symbolId = symbolTable.id( mParameters[pI]->name() );
+		unsigned int slot = ( symbolId * 2654435761u ) & mask;
+		
+		while( mSymbolSlots[slot].first != 0 ) slot = ( slot + 1 ) & mask;
+		
+		mSymbolSlots[slot] = std::make_pair( symbolId + 1, pI );
+	}
+}
+
 Eigen::VectorXf&
 ParameterList::values(const std::string& pName) throw (Exception)
 {
@@ -15,6 +15,7 @@
 #include "dab_exception.h"
 #include "dab_index_map.h"
 #include "dab_flock_parameter.h"
+#include "dab_flock_symbol.h"
 
 namespace dab
 {
@@ -61,6 +62,21 @@ public:
      */
     unsigned int parameterIndex(const std::string& pName) const throw (Exception);
     
+    /**
+     \brief checks if parameter list contains parameter
+     \param pSymbol parameter name symbol
+     \return true, if parameter name exists
+     */
+    bool contains(const Symbol& pSymbol) const;
+    
+    /**
+     \brief return index of parameter
+     \param pSymbol parameter name symbol
+     \return index of parameter
+     \exception Exception parameter not found
+     */
+    unsigned int parameterIndex(const Symbol& pSymbol) const throw (Exception);
+    
     /**
      \brief get parameter
      \param pIndex parameter index
@@ -93,6 +109,22 @@ public:
      */
     const Parameter* parameter(const std::string& pName) const throw (Exception);
     
+    /**
+     \brief get parameter
+     \param pSymbol parameter name symbol
+     \return parameter
+     \exception Exception parameter not found
+     */
+    Parameter* parameter(const Symbol& pSymbol) throw (Exception);
+    
+    /**
+     \brief get parameter
+     \param pSymbol parameter name symbol
+     \return parameter
+     \exception Exception parameter not found
+     */
+    const Parameter* parameter(const Symbol& pSymbol) const throw (Exception);
+    
     /**
      \brief add parameter
      \param pParameter parameter
@@ -173,6 +205,30 @@ protected:
      \brief parameters
      */
     IndexMap<std::string, Parameter*> mParameters;
+    
+    /**
+     \brief open addressing hash table of parameter indices by symbol id (first: symbol id + 1 or 0 for an empty slot, second: parameter index)
+     */
+    std::vector< std::pair<unsigned int, unsigned int> > mSymbolSlots;
+    
+    /**
+     \brief return slot of parameter index for symbol
+     \param pSymbolId symbol id
+     \return slot index or -1 if the symbol is not contained
+     */
+    int symbolSlot(unsigned int pSymbolId) const;
+    
+    /**
+     \brief add parameter index to symbol hash table
+     \param pName parameter name
+     \param pIndex parameter index
+     */
+    void addSymbolSlot(const std::string& pName, unsigned int pIndex);
+    
+    /**
+     \brief rebuild the symbol hash table from the parameter names
+     */
+    void updateSymbolSlots();
 };
 
 };
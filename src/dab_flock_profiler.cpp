@@ -0,0 +1,419 @@
+/** \file dab_flock_profiler.cpp
+ */
+
+#include "dab_flock_profiler.h"
+#include "dab_flock_simulation.h"
+#include "dab_flock_agent.h"
+#include "dab_flock_swarm.h"
+#include "dab_flock_behavior.h"
+#include "dab_flock_com.h"
+#include "dab_flock_allocation_counter.h"
+#include <sstream>
+#include <algorithm>
+
+using namespace dab;
+using namespace dab::flock;
+
+std::vector<std::string> FlockProfiler::sPhaseNames = { "com", "event", "space", "act", "flush", "stats" };
+
+FlockProfiler::BehaviorSlot::BehaviorSlot(const std::string& pName, const std::string& pClassName)
+: mName(pName)
+, mClassName(pClassName)
+, mTime(0.0)
+, mStreamTime(0.0)
+, mAllocationCount(0)
+{}
+
+FlockProfiler::FlockProfiler()
+: mEnabled(false)
+, mStepCount(0)
+, mPhaseStartAllocationCount(0)
+, mSendInterval(1)
+, mStreamStepCount(0)
+{
+	for(unsigned int pI=0; pI<PhaseCount; ++pI)
+	{
+		mPhaseTimes[pI] = 0.0;
+		mLastPhaseTimes[pI] = 0.0;
+		mStreamPhaseTimes[pI] = 0.0;
+		mPhaseAllocationCounts[pI] = 0;
+		mLastPhaseAllocationCounts[pI] = 0;
+	}
+}
+
+FlockProfiler::~FlockProfiler()
+{}
+
+bool
+FlockProfiler::enabled() const
+{
+	return mEnabled;
+}
+
+void
+FlockProfiler::setEnabled(bool pEnabled)
+{
+	mEnabled = pEnabled;
+}
+
+void
+FlockProfiler::reset()
+{
+	// discard act times that have not been collected yet
+	std::vector<Agent*>& agents = Simulation::get().agents();
+	unsigned int agentCount = agents.size();
+
+	for(unsigned int aI=0; aI<agentCount; ++aI)
+	{
+		Agent* agent = agents[aI];
+
+		unsigned int behaviorCount = agent->behaviorCount();
+		for(unsigned int bI=0; bI<behaviorCount; ++bI)
+		{
+			agent->behavior(bI)->takeProfileTime();
+			agent->behavior(bI)->takeProfileAllocationCount();
+		}
+
+		Swarm* swarm = dynamic_cast<Swarm*>(agent);
+		if( swarm == nullptr ) continue;
+
+		unsigned int swarmBehaviorCount = swarm->swarmBehaviorCount();
+		for(unsigned int bI=0; bI<swarmBehaviorCount; ++bI)
+		{
+			swarm->swarmBehavior(bI)->takeProfileTime();
+			swarm->swarmBehavior(bI)->takeProfileAllocationCount();
+		}
+	}
+
+	mStepCount = 0;
+	mStreamStepCount = 0;
+
+	for(unsigned int pI=0; pI<PhaseCount; ++pI)
+	{
+		mPhaseTimes[pI] = 0.0;
+		mLastPhaseTimes[pI] = 0.0;
+		mStreamPhaseTimes[pI] = 0.0;
+		mPhaseAllocationCounts[pI] = 0;
+		mLastPhaseAllocationCounts[pI] = 0;
+	}
+
+	// slots are kept since the behaviors cache their indices
+	unsigned int slotCount = mBehaviorSlots.size();
+	for(unsigned int sI=0; sI<slotCount; ++sI)
+	{
+		mBehaviorSlots[sI].mTime = 0.0;
+		mBehaviorSlots[sI].mStreamTime = 0.0;
+		mBehaviorSlots[sI].mAllocationCount = 0;
+	}
+}
+
+unsigned long
+FlockProfiler::stepCount() const
+{
+	return mStepCount;
+}
+
+const std::string&
+FlockProfiler::phaseName(Phase pPhase)
+{
+	return sPhaseNames[pPhase];
+}
+
+double
+FlockProfiler::phaseTime(Phase pPhase) const
+{
+	return mPhaseTimes[pPhase];
+}
+
+double
+FlockProfiler::lastPhaseTime(Phase pPhase) const
+{
+	return mLastPhaseTimes[pPhase];
+}
+
+std::map<std::string, double>
+FlockProfiler::behaviorTimes() const
+{
+	std::map<std::string, double> times;
+
+	unsigned int slotCount = mBehaviorSlots.size();
+	for(unsigned int sI=0; sI<slotCount; ++sI) times[ mBehaviorSlots[sI].mName ] += mBehaviorSlots[sI].mTime;
+
+	return times;
+}
+
+std::map<std::string, double>
+FlockProfiler::behaviorClassTimes() const
+{
+	std::map<std::string, double> times;
+
+	unsigned int slotCount = mBehaviorSlots.size();
+	for(unsigned int sI=0; sI<slotCount; ++sI) times[ mBehaviorSlots[sI].mClassName ] += mBehaviorSlots[sI].mTime;
+
+	return times;
+}
+
+bool
+FlockProfiler::allocationAudit() const
+{
+	return AllocationCounter::available();
+}
+
+unsigned long
+FlockProfiler::phaseAllocationCount(Phase pPhase) const
+{
+	return mPhaseAllocationCounts[pPhase];
+}
+
+unsigned long
+FlockProfiler::lastPhaseAllocationCount(Phase pPhase) const
+{
+	return mLastPhaseAllocationCounts[pPhase];
+}
+
+unsigned long
+FlockProfiler::lastStepAllocationCount() const
+{
+	unsigned long count = 0;
+	for(unsigned int pI=0; pI<PhaseCount; ++pI) count += mLastPhaseAllocationCounts[pI];
+
+	return count;
+}
+
+std::map<std::string, unsigned long>
+FlockProfiler::behaviorAllocationCounts() const
+{
+	std::map<std::string, unsigned long> counts;
+
+	unsigned int slotCount = mBehaviorSlots.size();
+	for(unsigned int sI=0; sI<slotCount; ++sI) counts[ mBehaviorSlots[sI].mName ] += mBehaviorSlots[sI].mAllocationCount;
+
+	return counts;
+}
+
+void
+FlockProfiler::startStreaming(const std::string& pSenderName, unsigned int pSendInterval) throw (Exception)
+{
+	if( FlockCom::get().checkSender(pSenderName) == false ) throw Exception( "FLOCK ERROR: sender " + pSenderName + " not found", __FILE__, __FUNCTION__, __LINE__ );
+
+	std::lock_guard<std::mutex> lock( mStreamLock );
+
+	mSenderName = pSenderName;
+	mSendInterval = std::max<unsigned int>(pSendInterval, 1);
+	mStreamStepCount = 0;
+
+	for(unsigned int pI=0; pI<PhaseCount; ++pI) mStreamPhaseTimes[pI] = 0.0;
+
+	unsigned int slotCount = mBehaviorSlots.size();
+	for(unsigned int sI=0; sI<slotCount; ++sI) mBehaviorSlots[sI].mStreamTime = 0.0;
+}
+
+void
+FlockProfiler::stopStreaming()
+{
+	std::lock_guard<std::mutex> lock( mStreamLock );
+
+	mSenderName = "";
+}
+
+void
+FlockProfiler::beginStep()
+{
+	mPhaseStartTime = now();
+	mPhaseStartAllocationCount = AllocationCounter::count();
+}
+
+void
+FlockProfiler::endPhase(Phase pPhase)
+{
+	Clock::time_point endTime = now();
+	double time = elapsed( mPhaseStartTime, endTime );
+
+	mLastPhaseTimes[pPhase] = time;
+	mPhaseTimes[pPhase] += time;
+	mStreamPhaseTimes[pPhase] += time;
+
+	mPhaseStartTime = endTime;
+
+	unsigned long allocationCount = AllocationCounter::count();
+
+	mLastPhaseAllocationCounts[pPhase] = allocationCount - mPhaseStartAllocationCount;
+	mPhaseAllocationCounts[pPhase] += allocationCount - mPhaseStartAllocationCount;
+
+	mPhaseStartAllocationCount = allocationCount;
+}
+
+void
+FlockProfiler::skipPhase()
+{
+	mPhaseStartTime = now();
+	mPhaseStartAllocationCount = AllocationCounter::count();
+}
+
+void
+FlockProfiler::endStep()
+{
+	std::vector<Agent*>& agents = Simulation::get().agents();
+	unsigned int agentCount = agents.size();
+
+	for(unsigned int aI=0; aI<agentCount; ++aI)
+	{
+		Agent* agent = agents[aI];
+
+		unsigned int behaviorCount = agent->behaviorCount();
+		for(unsigned int bI=0; bI<behaviorCount; ++bI) collect( agent->behavior(bI) );
+
+		Swarm* swarm = dynamic_cast<Swarm*>(agent);
+		if( swarm == nullptr ) continue;
+
+		unsigned int swarmBehaviorCount = swarm->swarmBehaviorCount();
+		for(unsigned int bI=0; bI<swarmBehaviorCount; ++bI) collect( swarm->swarmBehavior(bI) );
+	}
+
+	mStepCount++;
+
+	std::lock_guard<std::mutex> lock( mStreamLock );
+
+	if( mSenderName.empty() == true ) return;
+
+	mStreamStepCount++;
+
+	if( mStreamStepCount >= mSendInterval ) stream();
+}
+
+FlockProfiler::Clock::time_point
+FlockProfiler::now()
+{
+	return Clock::now();
+}
+
+double
+FlockProfiler::elapsed(const Clock::time_point& pStartTime, const Clock::time_point& pEndTime)
+{
+	return std::chrono::duration<double, std::milli>( pEndTime - pStartTime ).count();
+}
+
+void
+FlockProfiler::collect(Behavior* pBehavior)
+{
+	if( pBehavior->mProfileSlot < 0 )
+	{
+		std::string slotName = pBehavior->mClassName + "/" + pBehavior->mName;
+
+		auto slotIter = mBehaviorSlotIndices.find( slotName );
+
+		if( slotIter != mBehaviorSlotIndices.end() ) pBehavior->mProfileSlot = slotIter->second;
+		else
+		{
+			pBehavior->mProfileSlot = mBehaviorSlots.size();
+			mBehaviorSlotIndices[slotName] = pBehavior->mProfileSlot;
+			mBehaviorSlots.push_back( BehaviorSlot( pBehavior->mName, pBehavior->mClassName ) );
+		}
+	}
+
+	double time = pBehavior->takeProfileTime();
+
+	BehaviorSlot& slot = mBehaviorSlots[ pBehavior->mProfileSlot ];
+	slot.mTime += time;
+	slot.mStreamTime += time;
+	slot.mAllocationCount += pBehavior->takeProfileAllocationCount();
+}
+
+void
+FlockProfiler::stream()
+{
+	FlockCom& flockCom = FlockCom::get();
+
+	if( flockCom.checkSender(mSenderName) == false )
+	{
+		mSenderName = "";
+		return;
+	}
+
+	float stepScale = 1.0 / static_cast<float>(mStreamStepCount);
+
+	try
+	{
+		// average phase times per step
+		std::shared_ptr<OscMessage> phaseMessage( new OscMessage("/FlockProfile/Phases") );
+		phaseMessage->add( static_cast<int>(mStreamStepCount) );
+
+		for(unsigned int pI=0; pI<PhaseCount; ++pI)
+		{
+			phaseMessage->add( sPhaseNames[pI] );
+			phaseMessage->add( static_cast<float>(mStreamPhaseTimes[pI]) * stepScale );
+			mStreamPhaseTimes[pI] = 0.0;
+		}
+
+		flockCom.sendMessage( mSenderName, phaseMessage );
+
+		// average behavior times per step
+		unsigned int slotCount = mBehaviorSlots.size();
+		for(unsigned int sI=0; sI<slotCount; ++sI)
+		{
+			BehaviorSlot& slot = mBehaviorSlots[sI];
+
+			std::shared_ptr<OscMessage> behaviorMessage( new OscMessage("/FlockProfile/Behavior") );
+			behaviorMessage->add( slot.mClassName );
+			behaviorMessage->add( slot.mName );
+			behaviorMessage->add( static_cast<float>(slot.mStreamTime) * stepScale );
+			slot.mStreamTime = 0.0;
+
+			flockCom.sendMessage( mSenderName, behaviorMessage );
+		}
+	}
+	catch(Exception& e)
+	{
+		Simulation::get().exceptionReport(e);
+	}
+
+	mStreamStepCount = 0;
+}
+
+FlockProfiler::operator std::string() const
+{
+	return info();
+}
+
+std::string
+FlockProfiler::info(int pPropagationLevel) const
+{
+	std::stringstream ss;
+
+	double stepScale = mStepCount > 0 ? 1.0 / static_cast<double>(mStepCount) : 0.0;
+
+	ss << "Profile steps " << mStepCount << " (ms per step)\n";
+
+	for(unsigned int pI=0; pI<PhaseCount; ++pI)
+	{
+		ss << "phase " << sPhaseNames[pI] << " " << mPhaseTimes[pI] * stepScale << "\n";
+	}
+
+	std::map<std::string, double> classTimes = behaviorClassTimes();
+	for(auto iter = classTimes.begin(); iter != classTimes.end(); ++iter)
+	{
+		ss << "class " << iter->first << " " << iter->second * stepScale << "\n";
+	}
+
+	unsigned int slotCount = mBehaviorSlots.size();
+	for(unsigned int sI=0; sI<slotCount; ++sI)
+	{
+		ss << "behavior " << mBehaviorSlots[sI].mName << " (" << mBehaviorSlots[sI].mClassName << ") " << mBehaviorSlots[sI].mTime * stepScale << "\n";
+	}
+
+	if( AllocationCounter::available() == false ) return ss.str();
+
+	ss << "Allocations (per step)\n";
+
+	for(unsigned int pI=0; pI<PhaseCount; ++pI)
+	{
+		ss << "phase " << sPhaseNames[pI] << " " << static_cast<double>( mPhaseAllocationCounts[pI] ) * stepScale << "\n";
+	}
+
+	for(unsigned int sI=0; sI<slotCount; ++sI)
+	{
+		ss << "behavior " << mBehaviorSlots[sI].mName << " (" << mBehaviorSlots[sI].mClassName << ") " << static_cast<double>( mBehaviorSlots[sI].mAllocationCount ) * stepScale << "\n";
+	}
+
+	return ss.str();
+}
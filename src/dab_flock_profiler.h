@@ -0,0 +1,274 @@
+/** \file dab_flock_profiler.h
+ *  \class dab::flock::FlockProfiler simulation profiler
+ *  \brief simulation profiler
+ *
+ *  Measures the wall time of the phases of a simulation step and the cumulative act time of behaviors (aggregated per behavior name and per behavior class across all agents).\n
+ *  In applications compiled with DAB_FLOCK_ALLOCATION_AUDIT, heap allocations are counted per phase and per behavior as well (see AllocationCounter).\n
+ *  While disabled, the only cost is a flag check per phase and per agent.\n
+ *  The profile can optionally be streamed over OSC through FlockCom at a regular interval.\n
+ */
+
+#ifndef _dab_flock_profiler_h_
+#define _dab_flock_profiler_h_
+
+#include <vector>
+#include <map>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include "dab_singleton.h"
+#include "dab_exception.h"
+
+namespace dab
+{
+
+namespace flock
+{
+
+class Behavior;
+
+class FlockProfiler : public Singleton<FlockProfiler>
+{
+    friend class Singleton<FlockProfiler>;
+    friend class BehaviorList;
+
+public:
+    enum Phase
+    {
+        ComPhase,
+        EventPhase,
+        SpacePhase,
+        ActPhase,
+        FlushPhase,
+        StatsPhase,
+        PhaseCount
+    };
+
+    /**
+     \brief return whether profiling is enabled
+     \return true if profiling is enabled
+     */
+    bool enabled() const;
+
+    /**
+     \brief enable or disable profiling
+     \param pEnabled profiling enabled
+     */
+    void setEnabled(bool pEnabled);
+
+    /**
+     \brief clear all measurements
+
+     must be called from the simulation thread or while the simulation is not running
+     */
+    void reset();
+
+    /**
+     \brief return number of profiled simulation steps
+     \return number of profiled simulation steps
+     */
+    unsigned long stepCount() const;
+
+    /**
+     \brief return name of phase
+     \param pPhase phase
+     \return name of phase
+     */
+    static const std::string& phaseName(Phase pPhase);
+
+    /**
+     \brief return cumulative time of phase
+     \param pPhase phase
+     \return cumulative time (milliseconds)
+     */
+    double phaseTime(Phase pPhase) const;
+
+    /**
+     \brief return time of phase during the last profiled simulation step
+     \param pPhase phase
+     \return time (milliseconds)
+     */
+    double lastPhaseTime(Phase pPhase) const;
+
+    /**
+     \brief return cumulative act time per behavior name
+     \return map of behavior name to act time (milliseconds)
+     */
+    std::map<std::string, double> behaviorTimes() const;
+
+    /**
+     \brief return cumulative act time per behavior class
+     \return map of behavior class name to act time (milliseconds)
+     */
+    std::map<std::string, double> behaviorClassTimes() const;
+
+    /**
+     \brief return whether heap allocations are counted
+     \return true if the application has been compiled with DAB_FLOCK_ALLOCATION_AUDIT
+     */
+    bool allocationAudit() const;
+
+    /**
+     \brief return cumulative number of heap allocations of phase
+     \param pPhase phase
+     \return number of allocations (of all threads)
+     */
+    unsigned long phaseAllocationCount(Phase pPhase) const;
+
+    /**
+     \brief return number of heap allocations of phase during the last profiled simulation step
+     \param pPhase phase
+     \return number of allocations (of all threads)
+     */
+    unsigned long lastPhaseAllocationCount(Phase pPhase) const;
+
+    /**
+     \brief return number of heap allocations of all phases during the last profiled simulation step
+     \return number of allocations (of all threads)
+
+     a steady state simulation step is expected to return zero
+     */
+    unsigned long lastStepAllocationCount() const;
+
+    /**
+     \brief return cumulative number of heap allocations per behavior name
+     \return map of behavior name to number of allocations
+     */
+    std::map<std::string, unsigned long> behaviorAllocationCounts() const;
+
+    /**
+     \brief stream profile over osc
+     \param pSenderName name of FlockCom sender
+     \param pSendInterval send interval (number of profiled simulation steps)
+     \exception Exception sender not found
+
+     the streamed times are averages per simulation step over the send interval
+     */
+    void startStreaming(const std::string& pSenderName, unsigned int pSendInterval) throw (Exception);
+
+    /**
+     \brief stop streaming profile over osc
+     */
+    void stopStreaming();
+
+    /**
+     \brief begin profiling of simulation step (called by the simulation)
+     */
+    void beginStep();
+
+    /**
+     \brief end phase and begin next phase (called by the simulation)
+     \param pPhase phase that ends
+     */
+    void endPhase(Phase pPhase);
+
+    /**
+     \brief restart phase timer without accounting for the elapsed time (called by the simulation)
+     */
+    void skipPhase();
+
+    /**
+     \brief end profiling of simulation step, aggregates behavior times and streams profile (called by the simulation)
+     */
+    void endStep();
+
+    /**
+     \brief print profile
+     */
+    operator std::string() const;
+
+    /**
+     \brief print profile
+     \param pPropagationLevel how far the propagation method proceeds through composite classes (-1: unlimited, 0: no proceeding, >0: limited proceeding)
+     */
+    std::string info(int pPropagationLevel = 0) const;
+
+    /**
+     \brief retrieve textual profile
+     \param pOstream output text stream
+     \param pProfiler profiler
+     */
+    friend std::ostream& operator << ( std::ostream& pOstream, const FlockProfiler& pProfiler )
+    {
+        pOstream << pProfiler.info();
+
+        return pOstream;
+    };
+
+protected:
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     \brief measurements of behaviors that share a name and class
+     */
+    class BehaviorSlot
+    {
+    public:
+        BehaviorSlot(const std::string& pName, const std::string& pClassName);
+
+        std::string mName; /// \brief behavior name
+        std::string mClassName; /// \brief behavior class name
+        double mTime; /// \brief cumulative act time (milliseconds)
+        double mStreamTime; /// \brief act time since last stream (milliseconds)
+        unsigned long mAllocationCount; /// \brief cumulative number of heap allocations
+    };
+
+    static std::vector<std::string> sPhaseNames; /// \brief phase names
+
+    std::atomic<bool> mEnabled; /// \brief profiling enabled (set from the application thread, read by the simulation thread)
+    unsigned long mStepCount; /// \brief number of profiled simulation steps
+    Clock::time_point mPhaseStartTime; /// \brief start time of current phase
+    double mPhaseTimes[PhaseCount]; /// \brief cumulative phase times (milliseconds)
+    double mLastPhaseTimes[PhaseCount]; /// \brief phase times of last simulation step (milliseconds)
+    double mStreamPhaseTimes[PhaseCount]; /// \brief phase times since last stream (milliseconds)
+    unsigned long mPhaseStartAllocationCount; /// \brief allocation count at start of current phase
+    unsigned long mPhaseAllocationCounts[PhaseCount]; /// \brief cumulative phase allocation counts
+    unsigned long mLastPhaseAllocationCounts[PhaseCount]; /// \brief phase allocation counts of last simulation step
+    std::vector<BehaviorSlot> mBehaviorSlots; /// \brief behavior measurements
+    std::map<std::string, unsigned int> mBehaviorSlotIndices; /// \brief behavior slot index per class name and behavior name
+    std::mutex mStreamLock; /// \brief guards the streaming settings, which can be changed from the osc control thread
+    std::string mSenderName; /// \brief name of FlockCom sender for streaming (empty: no streaming)
+    unsigned int mSendInterval; /// \brief send interval (number of profiled simulation steps)
+    unsigned int mStreamStepCount; /// \brief number of profiled simulation steps since last stream
+
+    /**
+     \brief default constructor
+     */
+    FlockProfiler();
+
+    /**
+     \brief destructor
+     */
+    ~FlockProfiler();
+
+    /**
+     \brief return current time
+     \return current time
+     */
+    static Clock::time_point now();
+
+    /**
+     \brief return elapsed time in milliseconds
+     \param pStartTime start time
+     \param pEndTime end time
+     \return elapsed time (milliseconds)
+     */
+    static double elapsed(const Clock::time_point& pStartTime, const Clock::time_point& pEndTime);
+
+    /**
+     \brief move the act time and allocation count accumulated by a behavior into its slot
+     \param pBehavior behavior
+     */
+    void collect(Behavior* pBehavior);
+
+    /**
+     \brief send profile to osc sender
+     */
+    void stream();
+};
+
+};
+
+};
+
+#endif
@@ -0,0 +1,110 @@
+/** \file dab_flock_random.cpp
+ */
+
+#include "dab_flock_random.h"
+
+using namespace dab;
+using namespace dab::flock;
+
+RandomStream::RandomStream(uint64_t pSeed, uint32_t pStreamId, uint32_t pAgentIndex, uint64_t pStep)
+: mBlockIndex(4)
+{
+	mKey[0] = static_cast<uint32_t>( pSeed );
+	mKey[1] = static_cast<uint32_t>( pSeed >> 32 ) ^ static_cast<uint32_t>( pStep >> 32 );
+
+	mCounter[0] = 0;
+	mCounter[1] = static_cast<uint32_t>( pStep );
+	mCounter[2] = pAgentIndex;
+	mCounter[3] = pStreamId;
+}
+
+uint32_t
+RandomStream::streamId(const std::string& pName)
+{
+	// FNV-1a
+	uint32_t hash = 2166136261u;
+
+	for(unsigned char c : pName)
+	{
+		hash ^= c;
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+float
+RandomStream::uniform()
+{
+	if( mBlockIndex == 4 )
+	{
+		generate( mBlock );
+		mBlockIndex = 0;
+	}
+
+	return mBlock[mBlockIndex++];
+}
+
+float
+RandomStream::uniform(float pMinValue, float pMaxValue)
+{
+	return pMinValue + ( pMaxValue - pMinValue ) * uniform();
+}
+
+void
+RandomStream::fill(float* pValues, unsigned int pCount)
+{
+	unsigned int vI = 0;
+
+	// use up numbers left over from a previous call
+	for(; vI < pCount && mBlockIndex < 4; ++vI) pValues[vI] = mBlock[mBlockIndex++];
+
+	// whole blocks are written directly
+	for(; vI + 4 <= pCount; vI += 4) generate( pValues + vI );
+
+	for(; vI < pCount; ++vI) pValues[vI] = uniform();
+}
+
+void
+RandomStream::fill(Eigen::VectorXf& pValues, const Eigen::VectorXf& pMinValues, const Eigen::VectorXf& pMaxValues)
+{
+	fill( pValues.data(), pValues.rows() );
+
+	pValues = pMinValues + ( pMaxValues - pMinValues ).cwiseProduct( pValues );
+}
+
+void
+RandomStream::generate(float* pValues)
+{
+	// Philox4x32-10
+	uint32_t c0 = mCounter[0];
+	uint32_t c1 = mCounter[1];
+	uint32_t c2 = mCounter[2];
+	uint32_t c3 = mCounter[3];
+	uint32_t k0 = mKey[0];
+	uint32_t k1 = mKey[1];
+
+	for(unsigned int rI=0; rI<10; ++rI)
+	{
+		uint64_t product0 = static_cast<uint64_t>( 0xD2511F53u ) * c0;
+		uint64_t product1 = static_cast<uint64_t>( 0xCD9E8D57u ) * c2;
+
+		c0 = static_cast<uint32_t>( product1 >> 32 ) ^ c1 ^ k0;
+		c2 = static_cast<uint32_t>( product0 >> 32 ) ^ c3 ^ k1;
+		c1 = static_cast<uint32_t>( product1 );
+		c3 = static_cast<uint32_t>( product0 );
+
+		k0 += 0x9E3779B9u;
+		k1 += 0xBB67AE85u;
+	}
+
+	mCounter[0]++;
+
+	// upper 24 bits map exactly onto the float mantissa, the result is strictly smaller than 1.0
+	const float scale = 1.0f / 16777216.0f;
+
+	pValues[0] = static_cast<float>( c0 >> 8 ) * scale;
+	pValues[1] = static_cast<float>( c1 >> 8 ) * scale;
+	pValues[2] = static_cast<float>( c2 >> 8 ) * scale;
+	pValues[3] = static_cast<float>( c3 >> 8 ) * scale;
+}
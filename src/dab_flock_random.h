@@ -0,0 +1,90 @@
+/** \file dab_flock_random.h
+ *  \class dab::flock::RandomStream counter-based random number stream
+ *  \brief counter-based random number stream
+ *
+ *  Generates uniformly distributed random numbers with the Philox4x32-10 counter-based generator.\n
+ *  A stream has no state apart from its key and counter: the key is the simulation seed, the counter combines simulation step, agent index and stream id.\n
+ *  Streams are therefore cheap to create on the fly, can be used from any thread without locking, and produce the same numbers regardless of the number of threads or the order in which agents act.\n
+ */
+
+#ifndef _dab_flock_random_h_
+#define _dab_flock_random_h_
+
+#include <cstdint>
+#include <string>
+#include <Eigen/Dense>
+
+namespace dab
+{
+
+namespace flock
+{
+
+class RandomStream
+{
+public:
+    /**
+     \brief create random stream
+     \param pSeed simulation seed
+     \param pStreamId stream id (e.g. hashed behavior name)
+     \param pAgentIndex agent index
+     \param pStep simulation step
+     */
+    RandomStream(uint64_t pSeed, uint32_t pStreamId, uint32_t pAgentIndex, uint64_t pStep);
+
+    /**
+     \brief create stream id from name
+     \param pName name (e.g. behavior or parameter name)
+     \return stream id
+     */
+    static uint32_t streamId(const std::string& pName);
+
+    /**
+     \brief return random number
+     \return random number in the range [0.0, 1.0)
+     */
+    float uniform();
+
+    /**
+     \brief return random number
+     \param pMinValue minimum value
+     \param pMaxValue maximum value
+     \return random number in the range [pMinValue, pMaxValue)
+     */
+    float uniform(float pMinValue, float pMaxValue);
+
+    /**
+     \brief fill values with random numbers in the range [0.0, 1.0)
+     \param pValues values
+     \param pCount number of values
+
+     generates four values per generator round
+     */
+    void fill(float* pValues, unsigned int pCount);
+
+    /**
+     \brief fill values with random numbers
+     \param pValues values
+     \param pMinValues minimum values (same dimension as pValues)
+     \param pMaxValues maximum values (same dimension as pValues)
+     */
+    void fill(Eigen::VectorXf& pValues, const Eigen::VectorXf& pMinValues, const Eigen::VectorXf& pMaxValues);
+
+protected:
+    uint32_t mKey[2]; /// \brief generator key (seed)
+    uint32_t mCounter[4]; /// \brief generator counter (block index, step, agent index, stream id)
+    float mBlock[4]; /// \brief random numbers of current block
+    unsigned int mBlockIndex; /// \brief index of next unused number in current block
+
+    /**
+     \brief generate next block of four random numbers
+     \param pValues destination
+     */
+    void generate(float* pValues);
+};
+
+};
+
+};
+
+#endif
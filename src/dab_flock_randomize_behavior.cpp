@@ -3,13 +3,14 @@
 
 #include "dab_flock_randomize_behavior.h"
 #include "dab_flock_agent.h"
-#include "dab_math.h"
+#include "dab_flock_simulation.h"
 
 using namespace dab;
 using namespace dab::flock;
 
 RandomizeBehavior::RandomizeBehavior(const std::string& pInputParameterString, const std::string& pOutputParameterString)
 : Behavior(pInputParameterString, pOutputParameterString)
+, mRandomStreamId(0)
 {
 	mClassName = "RandomizeBehavior";
 }
@@ -26,6 +27,11 @@ RandomizeBehavior::RandomizeBehavior(Agent* pAgent, const std::string& pBehavior
 	
 	// create internal parameters
 	mRangePar = createInternalParameter("range", mOutputParameters[0]->dim(), 1.0);
+	
+	// agents of a swarm and the swarm itself (whose behaviors are shared or copied to its agents) use the same stream id
+	const std::string& swarmName = mAgent->swarmSymbol().empty() == true ? mAgent->name() : mAgent->swarmSymbol().name();
+	mRandomStreamId = RandomStream::streamId( swarmName + ":" + mName );
+	mRandomValues.resize( mOutputParameters[0]->dim() );
 }
 
 RandomizeBehavior::~RandomizeBehavior()
@@ -67,12 +73,15 @@ RandomizeBehavior::act()
 	Eigen::VectorXf& output = mRandomizePar->backupValues();
 	Eigen::VectorXf& range = mRangePar->values();
     
-	math::Math<>& math = math::Math<>::get();
 	unsigned int dim = output.rows();
 	
+	// the stream depends only on seed, swarm, behavior, agent index within the swarm and step, which makes the behavior thread safe and independent of the number of agents created before
+	RandomStream random = Simulation::get().randomStream( mRandomStreamId, mAgent->swarmIndex() );
+	random.fill( mRandomValues.data(), dim );
+	
 	for(unsigned int i=0; i<dim; ++i)
 	{
-		output[i] += math.uniformRandom(-range[i], range[i]);
+		output[i] += range[i] * ( 2.0 * mRandomValues[i] - 1.0 );
 	}
     
 	//std::cout << "RandomizeBehavior end: out values" << mOutputParameters[0]->values() << " bValues " << mOutputParameters[0]->backupValues() << "\n";
@@ -78,6 +78,8 @@ public:
 protected:
     Parameter* mRandomizePar; /// \brief randomize parameter (output)
     Parameter* mRangePar; /// \brief randomize range parameter (internal)
+    uint32_t mRandomStreamId; /// \brief random stream id derived from swarm and behavior name
+    Eigen::VectorXf mRandomValues; /// \brief random values of current step
 };
 
 };
@@ -88,7 +88,7 @@ RemoveAgentsEvent::execute() throw (Exception)
 		Swarm* swarm = Simulation::get().swarm(mSwarmName);
 		
 		if( mAgentCount < 0 ) swarm->removeAgents();
-		if( mStartAgentIndex >= 0 ) swarm->removeAgents(mStartAgentIndex, mAgentCount);
+		else if( mStartAgentIndex >= 0 ) swarm->removeAgents(mStartAgentIndex, mAgentCount);
 		else swarm->removeAgents(mAgentCount);
 	}
 	catch(Exception& e)
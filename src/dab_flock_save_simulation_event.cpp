@@ -56,7 +56,8 @@ SaveSimulationEvent::execute() throw (Exception)
 	{
 		//std::cout << "SaveSimulationEvent::execute() begin\n";
 		
-		SerializeTools::get().save( mFileName, mMode );
+		// the snapshot is written by a background thread, the simulation only waits for the copy
+		SerializeTools::get().saveAsync( mFileName, mMode );
 		
 		//std::cout << "SaveSimulationEvent::execute() end\n";
 	}
@@ -17,6 +17,7 @@
 #include "dab_flock_visual_neighbor_space.h"
 #include "dab_flock_visual_grid_space.h"
 #include "dab_space_includes.h"
+#include <algorithm>
 
 using namespace dab;
 using namespace dab::flock;
@@ -38,13 +39,29 @@ SerializeTools::getValues<unsigned int>(const Json::Value& pData, const std::str
     }
 }
 
+std::atomic<bool> SerializeTools::sSavesCompleted(false);
+
 SerializeTools::SerializeTools()
+: mActiveSaveCount(0)
+, mSaveThreadRunning(false)
+, mSaveThreadTerminated(false)
 {
     if( mBehaviorMap.size() == 0 ) createBehaviorMap();
 }
 
 SerializeTools::~SerializeTools()
-{}
+{
+    // the writer thread finishes all queued snapshots before terminating
+    {
+        std::lock_guard<std::mutex> lock( mSaveMutex );
+        if( mSaveThreadRunning == false ) return;
+        mSaveThreadTerminated = true;
+    }
+    
+    mSaveCondition.notify_one();
+    mSaveThread.join();
+    mSaveThreadRunning = false;
+}
 
 void
 SerializeTools::createBehaviorMap()
@@ -101,6 +118,19 @@ SerializeTools::save( const std::string& pFileName, SerializeMode pMode ) throw
 	
 	try
 	{
+		if( BinarySnapshot::checkFileName(pFileName) == true )
+		{
+			if( pMode != ValuesMode ) throw Exception( "FLOCK ERROR: binary snapshots only support values mode", __FILE__, __FUNCTION__, __LINE__ );
+			
+			if( Simulation::get().paused() == false ) Simulation::get().switchPaused();
+			
+			mBinarySnapshot.save( ofToDataPath(pFileName) );
+			
+			if( Simulation::get().paused() == true ) Simulation::get().switchPaused();
+			
+			return;
+		}
+		
 		if( Simulation::get().paused() == false ) Simulation::get().switchPaused();
 		
 		Json::Value serializeData;
@@ -140,6 +170,419 @@ SerializeTools::save( const std::string& pFileName, SerializeMode pMode ) throw
 	//std::cout << "save end\n";
 }
 
+void
+SerializeTools::saveAsync( const std::string& pFileName, SerializeMode pMode ) throw (Exception)
+{
+	try
+	{
+		// the simulation thread only copies the values, building the json data, encoding and disk io are left to the writer thread
+		SaveJob job;
+		job.mFileName = pFileName;
+		job.mBinary = BinarySnapshot::checkFileName(pFileName);
+		job.mSaveValues = false;
+		
+		if( job.mBinary == true )
+		{
+			if( pMode != ValuesMode ) throw Exception( "FLOCK ERROR: binary snapshots only support values mode", __FILE__, __FUNCTION__, __LINE__ );
+			
+			mBinarySnapshot.encode( job.mBinaryData );
+		}
+		else
+		{
+			job.mJsonData["className"] = "Swarm";
+			job.mJsonData["configName"] = "Swarm";
+			
+			// the configuration does not grow with the number of agents and is serialized right away
+			if( pMode == ConfigMode || pMode == AllMode ) saveConfig( job.mJsonData );
+			
+			job.mSaveValues = ( pMode == ValuesMode || pMode == AllMode );
+			if( job.mSaveValues == true ) takeValues( job );
+		}
+		
+		{
+			std::lock_guard<std::mutex> lock( mSaveMutex );
+			
+			if( mSaveThreadRunning == false )
+			{
+				mSaveThreadTerminated = false;
+				mSaveThreadRunning = true;
+				mSaveThread = std::thread( &SerializeTools::saveWork, this );
+			}
+			
+			// swap instead of copy, the snapshot can be large
+			mSaveJobs.push_back( SaveJob() );
+			SaveJob& queuedJob = mSaveJobs.back();
+			queuedJob.mFileName.swap( job.mFileName );
+			queuedJob.mBinary = job.mBinary;
+			queuedJob.mSaveValues = job.mSaveValues;
+			queuedJob.mJsonData.swap( job.mJsonData );
+			queuedJob.mValueEntries.swap( job.mValueEntries );
+			queuedJob.mValues.swap( job.mValues );
+			queuedJob.mBinaryData.swap( job.mBinaryData );
+		}
+		
+		mSaveCondition.notify_one();
+	}
+	catch(Exception& e)
+	{
+		e += Exception("FLOCK ERROR: failed to save to file " + pFileName, __FILE__, __FUNCTION__, __LINE__);
+		throw e;
+	}
+}
+
+unsigned int
+SerializeTools::pendingSaveCount()
+{
+	std::lock_guard<std::mutex> lock( mSaveMutex );
+	
+	return mSaveJobs.size() + mActiveSaveCount;
+}
+
+bool
+SerializeTools::savesCompleted()
+{
+	return sSavesCompleted.load( std::memory_order_acquire );
+}
+
+void
+SerializeTools::reportSaves()
+{
+	if( sSavesCompleted.load( std::memory_order_acquire ) == false ) return;
+	
+	std::vector<std::string> savedFiles;
+	std::vector<Exception> saveErrors;
+	
+	{
+		std::lock_guard<std::mutex> lock( mSaveMutex );
+		
+		savedFiles.swap( mSavedFiles );
+		saveErrors.swap( mSaveErrors );
+		sSavesCompleted.store( false, std::memory_order_release );
+	}
+	
+	Simulation& simulation = Simulation::get();
+	
+	for(unsigned int eI=0; eI<saveErrors.size(); ++eI) simulation.exceptionReport( saveErrors[eI] );
+	
+	if( savedFiles.size() == 0 || FlockCom::get().checkSender("OSCErrorSender") == false ) return;
+	
+	for(unsigned int fI=0; fI<savedFiles.size(); ++fI)
+	{
+		std::shared_ptr<OscMessage> savedMessage = std::make_shared<OscMessage>("/SimulationSaved");
+		savedMessage->add( savedFiles[fI] );
+		
+		try
+		{
+			FlockCom::get().sendMessage("OSCErrorSender", savedMessage);
+		}
+		catch(Exception& e)
+		{
+			std::cout << e << "\n";
+		}
+	}
+}
+
+void
+SerializeTools::saveWork()
+{
+	SaveJob job;
+	
+	while( true )
+	{
+		{
+			std::unique_lock<std::mutex> lock( mSaveMutex );
+			mSaveCondition.wait( lock, [this]{ return mSaveJobs.empty() == false || mSaveThreadTerminated == true; } );
+			
+			if( mSaveJobs.empty() == true ) return;
+			
+			SaveJob& queuedJob = mSaveJobs.front();
+			job.mFileName.swap( queuedJob.mFileName );
+			job.mBinary = queuedJob.mBinary;
+			job.mSaveValues = queuedJob.mSaveValues;
+			job.mJsonData.swap( queuedJob.mJsonData );
+			job.mValueEntries.swap( queuedJob.mValueEntries );
+			job.mValues.swap( queuedJob.mValues );
+			job.mBinaryData.swap( queuedJob.mBinaryData );
+			mSaveJobs.pop_front();
+			mActiveSaveCount++;
+		}
+		
+		try
+		{
+			writeSaveJob( job );
+			
+			std::lock_guard<std::mutex> lock( mSaveMutex );
+			mSavedFiles.push_back( job.mFileName );
+		}
+		catch(Exception& e)
+		{
+			e += Exception("FLOCK ERROR: failed to save to file " + job.mFileName, __FILE__, __FUNCTION__, __LINE__);
+			
+			std::lock_guard<std::mutex> lock( mSaveMutex );
+			mSaveErrors.push_back( e );
+		}
+		
+		{
+			std::lock_guard<std::mutex> lock( mSaveMutex );
+			
+			mActiveSaveCount--;
+			sSavesCompleted.store( true, std::memory_order_release );
+		}
+		
+		job.mJsonData = Json::Value();
+		job.mValueEntries.clear();
+		job.mValues.clear();
+		job.mBinaryData.clear();
+	}
+}
+
+void
+SerializeTools::writeSaveJob( SaveJob& pJob ) throw (Exception)
+{
+	if( pJob.mBinary == true )
+	{
+		BinarySnapshot::writeFile( ofToDataPath(pJob.mFileName), pJob.mBinaryData );
+		return;
+	}
+	
+	try
+	{
+		if( pJob.mSaveValues == true ) saveValues( pJob, pJob.mJsonData );
+		
+		Json::StyledWriter styledWriter;
+		dab::FileIO::get().write(styledWriter.write(pJob.mJsonData), ofToDataPath(pJob.mFileName));
+	}
+	catch(dab::Exception& e)
+	{
+		e += dab::Exception("FILE ERROR: failed to write file " + pJob.mFileName, __FILE__, __FUNCTION__, __LINE__);
+		throw e;
+	}
+}
+
+void
+SerializeTools::takeValues( SaveJob& pJob ) throw (Exception)
+{
+	std::vector<ValueEntry>& entries = pJob.mValueEntries;
+	std::vector<float>& values = pJob.mValues;
+	
+	entries.clear();
+	values.clear();
+	
+	auto addEntry = [&entries, &values]( ValueEntryType pType, const std::string& pName, unsigned int pDim, unsigned int pCount ) -> ValueEntry&
+	{
+		entries.push_back( ValueEntry() );
+		ValueEntry& entry = entries.back();
+		entry.mType = pType;
+		entry.mName = pName;
+		entry.mDim = pDim;
+		entry.mCount = pCount;
+		entry.mOffset = values.size();
+		
+		return entry;
+	};
+	
+	auto copyValues = [&values]( const Eigen::VectorXf& pValues )
+	{
+		values.insert( values.end(), pValues.data(), pValues.data() + pValues.rows() );
+	};
+	
+	try
+	{
+		std::vector<Swarm*>& swarms = Simulation::get().swarms();
+		unsigned int swarmCount = swarms.size();
+		
+		for(unsigned int sI=0; sI<swarmCount; ++sI)
+		{
+			Swarm* swarm = swarms[sI];
+			unsigned int agentCount = swarm->agentCount();
+			
+			addEntry( SwarmEntry, swarm->name(), agentCount, 0 );
+			
+			unsigned int swarmParameterCount = swarm->swarmParameterCount();
+			for(unsigned int spI=0; spI<swarmParameterCount; ++spI)
+			{
+				const Parameter* swarmParameter = swarm->swarmParameter( spI );
+				
+				addEntry( SwarmParameterEntry, swarmParameter->name(), swarmParameter->values().rows(), 1 );
+				copyValues( swarmParameter->values() );
+			}
+			
+			// the swarm values are followed by the values of all agents, the writer thread decides whether individual values are saved
+			unsigned int agentParameterCount = swarm->parameterCount();
+			for(unsigned int apI=0; apI<agentParameterCount; ++apI)
+			{
+				const Parameter* agentParameter = static_cast<Agent*>( swarm )->parameter( apI );
+				
+				addEntry( AgentParameterEntry, agentParameter->name(), agentParameter->values().rows(), agentCount + 1 );
+				copyValues( agentParameter->values() );
+				
+				for(unsigned int aI=0; aI<agentCount; ++aI) copyValues( swarm->parameter( aI, apI )->values() );
+			}
+		}
+		
+		std::vector<Env*>& envs = Simulation::get().envs();
+		unsigned int envCount = envs.size();
+		
+		for(unsigned int eI=0; eI<envCount; ++eI)
+		{
+			Env* env = envs[eI];
+			
+			addEntry( EnvEntry, env->name(), env->dim(), 0 );
+			
+			unsigned int parameterCount = env->parameterCount();
+			for(unsigned int epI=0; epI<parameterCount; ++epI)
+			{
+				Parameter* parameter = env->parameter( epI );
+				EnvParameter* envParameter = dynamic_cast< EnvParameter* >( parameter );
+				unsigned int parameterDim = parameter->values().rows();
+				
+				if( envParameter != nullptr )
+				{
+					const math::VectorField<float>& parameterField = envParameter->grid()->vectorField();
+					unsigned int parameterVectorCount = parameterField.vectorCount();
+					const std::vector<Eigen::VectorXf>& parameterVectors = parameterField.vectors();
+					
+					ValueEntry& entry = addEntry( EnvGridParameterEntry, parameter->name(), parameterDim, parameterVectorCount );
+					
+					const dab::Array<unsigned int>& gridSize = envParameter->gridSize();
+					for(unsigned int gI=0; gI<gridSize.size(); ++gI) entry.mGridSize.push_back( gridSize[gI] );
+					
+					for(unsigned int pvI=0; pvI<parameterVectorCount; ++pvI) copyValues( parameterVectors[pvI] );
+				}
+				else
+				{
+					addEntry( EnvParameterEntry, parameter->name(), parameterDim, 1 );
+					copyValues( parameter->values() );
+				}
+			}
+		}
+	}
+	catch (Exception& e)
+	{
+		e += Exception("FLOCK ERROR: failed to copy values", __FILE__, __FUNCTION__, __LINE__);
+		throw e;
+	}
+}
+
+void
+SerializeTools::saveValues( const SaveJob& pJob, Json::Value& pSerializeData )
+{
+	Json::Value valuesData;
+	valuesData["className"] = "SwarmValues";
+	valuesData["configName"] = "SwarmValues";
+	
+	const std::vector<ValueEntry>& entries = pJob.mValueEntries;
+	const float* values = pJob.mValues.data();
+	unsigned int entryCount = entries.size();
+	unsigned int eI = 0;
+	
+	while( eI < entryCount )
+	{
+		const ValueEntry& groupEntry = entries[eI++];
+		
+		if( groupEntry.mType == SwarmEntry )
+		{
+			Json::Value swarmSerializeData;
+			swarmSerializeData["className"] = "Swarm";
+			swarmSerializeData["configName"] = "Swarm";
+			swarmSerializeData["name"] = groupEntry.mName;
+			swarmSerializeData["agentCount"] = groupEntry.mDim;
+			
+			for(; eI < entryCount && ( entries[eI].mType == SwarmParameterEntry || entries[eI].mType == AgentParameterEntry ); ++eI)
+			{
+				const ValueEntry& entry = entries[eI];
+				const float* parameterValues = values + entry.mOffset;
+				unsigned int dim = entry.mDim;
+				
+				if( entry.mType == SwarmParameterEntry )
+				{
+					Json::Value swarmParameterSerializeData;
+					swarmParameterSerializeData["className"] = "SwarmParameter";
+					swarmParameterSerializeData["configName"] = "SwarmParameter";
+					swarmParameterSerializeData["name"] = entry.mName;
+					swarmParameterSerializeData["values"] = addValues( parameterValues, dim );
+					
+					swarmSerializeData["SwarmParameters"].append(swarmParameterSerializeData);
+				}
+				else
+				{
+					Json::Value agentParameterSerializeData;
+					agentParameterSerializeData["className"] = "AgentParameter";
+					agentParameterSerializeData["configName"] = "AgentParameter";
+					agentParameterSerializeData["name"] = entry.mName;
+					agentParameterSerializeData["values"] = addValues( parameterValues, dim );
+					
+					// individual agent values are only saved if they differ from the swarm values
+					unsigned int agentCount = entry.mCount - 1;
+					bool saveIndividualAgentParameterValues = false;
+					
+					for(unsigned int aI=0; aI<agentCount; ++aI)
+					{
+						if( std::equal( parameterValues, parameterValues + dim, parameterValues + ( aI + 1 ) * dim ) == false )
+						{
+							saveIndividualAgentParameterValues = true;
+							break;
+						}
+					}
+					
+					if( saveIndividualAgentParameterValues == true )
+					{
+						for(unsigned int aI=0; aI<agentCount; ++aI) agentParameterSerializeData[ "value" + std::to_string(aI) ] = addValues( parameterValues + ( aI + 1 ) * dim, dim );
+					}
+					
+					swarmSerializeData["AgentParameters"].append(agentParameterSerializeData);
+				}
+			}
+			
+			valuesData["Swarms"].append( swarmSerializeData );
+		}
+		else if( groupEntry.mType == EnvEntry )
+		{
+			Json::Value envSerializeData;
+			envSerializeData["className"] = "Env";
+			envSerializeData["configName"] = "Env";
+			envSerializeData["name"] = groupEntry.mName;
+			envSerializeData["dim"] = groupEntry.mDim;
+			
+			for(; eI < entryCount && ( entries[eI].mType == EnvGridParameterEntry || entries[eI].mType == EnvParameterEntry ); ++eI)
+			{
+				const ValueEntry& entry = entries[eI];
+				const float* parameterValues = values + entry.mOffset;
+				unsigned int dim = entry.mDim;
+				
+				Json::Value parameterSerializeData;
+				parameterSerializeData["name"] = entry.mName;
+				
+				if( entry.mType == EnvGridParameterEntry )
+				{
+					parameterSerializeData["className"] = "EnvParameter";
+					parameterSerializeData["configName"] = "EnvParameter";
+					parameterSerializeData["valueDim"] = dim;
+					
+					Json::Value gridSizeData;
+					for(unsigned int gI=0; gI<entry.mGridSize.size(); ++gI) gridSizeData.append( entry.mGridSize[gI] );
+					parameterSerializeData["gridSize"] = gridSizeData;
+					
+					for(unsigned int pvI=0; pvI<entry.mCount; ++pvI) parameterSerializeData[ "vec" + std::to_string(pvI) ] = addValues( parameterValues + pvI * dim, dim );
+				}
+				else
+				{
+					parameterSerializeData["className"] = "Parameter";
+					parameterSerializeData["configName"] = "EnvParameter";
+					parameterSerializeData["dim"] = dim;
+					parameterSerializeData["values"] = addValues( parameterValues, dim );
+				}
+				
+				envSerializeData["Parameters"].append(parameterSerializeData);
+			}
+			
+			valuesData["Envs"].append( envSerializeData );
+		}
+	}
+	
+	pSerializeData["SwarmValues"] = valuesData;
+}
+
 void
 SerializeTools::saveConfig( Json::Value& pSerializeData ) throw (Exception)
 {
@@ -189,6 +632,19 @@ SerializeTools::restore( const std::string& pFileName, SerializeMode pMode ) thr
 {
 	try
 	{
+		if( BinarySnapshot::checkFile( ofToDataPath(pFileName) ) == true )
+		{
+			if( pMode == ConfigMode ) throw Exception( "FLOCK ERROR: binary snapshots only contain values", __FILE__, __FUNCTION__, __LINE__ );
+			
+			if( Simulation::get().paused() == false ) Simulation::get().switchPaused();
+			
+			mBinarySnapshot.restore( ofToDataPath(pFileName) );
+			
+			if( Simulation::get().paused() == true ) Simulation::get().switchPaused();
+			
+			return;
+		}
+		
 		if( Simulation::get().paused() == false ) Simulation::get().switchPaused();
         
         std::string serializeString;
@@ -2611,6 +3067,19 @@ SerializeTools::addValues(const Eigen::VectorXf& pValues)
     return valueData;
 }
 
+Json::Value
+SerializeTools::addValues(const float* pValues, unsigned int pDim)
+{
+    Json::Value valueData;
+    
+    for(unsigned int d=0; d<pDim; ++d)
+    {
+        valueData.append(pValues[d]);
+    }
+    
+    return valueData;
+}
+
 Json::Value
 SerializeTools::addValues(const glm::vec3& pValues)
 {
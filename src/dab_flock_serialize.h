@@ -12,12 +12,18 @@
 #include <iostream>
 #include <map>
 #include <array>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <Eigen/Dense>
 #include "ofVectorMath.h"
 #include "ofxJSON.h"
 #include "dab_singleton.h"
 #include "dab_exception.h"
 #include "dab_array.h"
+#include "dab_flock_binary_snapshot.h"
 
 namespace dab
 {
@@ -44,9 +50,97 @@ public:
     void save( const std::string& pFileName, SerializeMode pMode = AllMode ) throw (Exception);
 	void restore( const std::string& pFileName, SerializeMode pMode = AllMode ) throw (Exception);
     
+    /**
+     \brief save without blocking the simulation
+     \param pFileName file name
+     \param pMode serialize mode
+     \exception Exception failed to take snapshot
+     
+     has to be called from the simulation thread between steps (e.g. by SaveSimulationEvent)\n
+     copies the parameter values of the simulation into a flat snapshot and passes it to a writer thread which builds the json data, encodes and writes the file\n
+     completion is reported by reportSaves(): "/SimulationSaved" with the file name on success, "/FlockError" on failure
+     */
+    void saveAsync( const std::string& pFileName, SerializeMode pMode = AllMode ) throw (Exception);
+    
+    /**
+     \brief return number of snapshots waiting to be written or being written
+     \return number of pending saves
+     */
+    unsigned int pendingSaveCount();
+    
+    /**
+     \brief check whether asynchronous saves have completed since the last report
+     \return true if saves have completed
+     
+     does not create the serialize tools
+     */
+    static bool savesCompleted();
+    
+    /**
+     \brief report completed and failed asynchronous saves via osc
+     
+     called by the simulation once per step if savesCompleted() is true
+     */
+    void reportSaves();
+    
 protected:
+    /**
+     \brief type of value entry of a flat snapshot
+     */
+    enum ValueEntryType
+    {
+        SwarmEntry,
+        SwarmParameterEntry,
+        AgentParameterEntry,
+        EnvEntry,
+        EnvGridParameterEntry,
+        EnvParameterEntry
+    };
+    
+    /**
+     \brief swarm, env or parameter of a flat snapshot, parameter entries follow the entry of their swarm or env
+     */
+    class ValueEntry
+    {
+    public:
+        ValueEntryType mType; /// \brief entry type
+        std::string mName; /// \brief swarm, env or parameter name
+        unsigned int mDim; /// \brief value dimension (swarm entry: agent count, env entry: env dimension)
+        unsigned int mCount; /// \brief number of value vectors (agent parameter: swarm values followed by agent values, env grid parameter: grid vectors)
+        unsigned int mOffset; /// \brief index of first value in snapshot values
+        std::vector<unsigned int> mGridSize; /// \brief grid size (env grid parameter only)
+    };
+    
+    /**
+     \brief snapshot waiting to be written by the writer thread
+     */
+    class SaveJob
+    {
+    public:
+        std::string mFileName; /// \brief file name
+        bool mBinary; /// \brief binary snapshot (mBinaryData) or json (mJsonData and flat values)
+        bool mSaveValues; /// \brief json snapshot contains values (mValueEntries, mValues)
+        Json::Value mJsonData; /// \brief json snapshot (configuration only, values are added by the writer thread)
+        std::vector<ValueEntry> mValueEntries; /// \brief flat snapshot entries
+        std::vector<float> mValues; /// \brief flat snapshot values
+        std::vector<char> mBinaryData; /// \brief encoded binary snapshot
+    };
+    
+
     std::map< std::string, Behavior* > mBehaviorMap;
     std::map< std::string, SwarmBehavior* > mSwarmBehaviorMap;
+    BinarySnapshot mBinarySnapshot; /// \brief binary format for ValuesMode (file names ending with BinarySnapshot::sFileExtension)
+    
+    std::deque<SaveJob> mSaveJobs; /// \brief snapshots waiting to be written
+    unsigned int mActiveSaveCount; /// \brief number of snapshots taken by the writer thread and not yet written
+    std::vector<std::string> mSavedFiles; /// \brief files written since the last report
+    std::vector<Exception> mSaveErrors; /// \brief errors since the last report
+    static std::atomic<bool> sSavesCompleted; /// \brief saves have completed since the last report
+    std::thread mSaveThread; /// \brief writer thread
+    bool mSaveThreadRunning; /// \brief writer thread running
+    bool mSaveThreadTerminated; /// \brief writer thread termination flag
+    std::mutex mSaveMutex; /// \brief guards the save queue and results
+    std::condition_variable mSaveCondition; /// \brief signals the writer thread that a snapshot has been queued
     
     SerializeTools();
     ~SerializeTools();
@@ -54,6 +148,40 @@ protected:
     void createBehaviorMap();
     void registerBehavior(Behavior* pBehavior);
     
+    /**
+     \brief writer thread loop
+     */
+    void saveWork();
+    
+    /**
+     \brief copy parameter values into flat snapshot
+     \param pJob snapshot
+     \exception Exception failed to copy values
+     */
+    void takeValues( SaveJob& pJob ) throw (Exception);
+    
+    /**
+     \brief create json values from flat snapshot, in the same format as saveValues()
+     \param pJob snapshot
+     \param pSerializeData json data
+     */
+    void saveValues( const SaveJob& pJob, Json::Value& pSerializeData );
+    
+    /**
+     \brief create json values from flat snapshot values
+     \param pValues values
+     \param pDim number of values
+     \return json values
+     */
+    Json::Value addValues(const float* pValues, unsigned int pDim);
+    
+    /**
+     \brief encode and write snapshot
+     \param pJob snapshot
+     \exception Exception failed to write file
+     */
+    void writeSaveJob( SaveJob& pJob ) throw (Exception);
+    
     void saveConfig( Json::Value& pSerializeData ) throw (Exception);
 	void restoreConfig( const Json::Value& pSerializeData ) throw (Exception);
 	
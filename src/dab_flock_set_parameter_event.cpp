@@ -3,6 +3,7 @@
 
 #include "dab_flock_set_parameter_event.h"
 #include "dab_flock_env.h"
+#include "dab_flock_simulation.h"
 #include "dab_math.h"
 
 using namespace dab;
@@ -12,6 +13,8 @@ SetParameterEvent::SetParameterEvent( const std::string& pSwarmName, const std::
 : event::Event(0.0, pDuration, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex(-1)
 , mAgentRangeEndIndex(-1)
 , mParameterValues(pParameterValues)
@@ -24,6 +27,8 @@ SetParameterEvent::SetParameterEvent(const std::string& pSwarmName, const std::s
 : event::Event(0.0, pDuration, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex(pAgentIndex)
 , mAgentRangeEndIndex(pAgentIndex)
 , mParameterValues(pParameterValues)
@@ -36,6 +41,8 @@ SetParameterEvent::SetParameterEvent( const std::string& pSwarmName, const std::
 : event::Event(0.0, pDuration, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex( pAgentRange[0] )
 , mAgentRangeEndIndex( pAgentRange[1] )
 , mParameterValues(pParameterValues)
@@ -48,6 +55,8 @@ SetParameterEvent::SetParameterEvent(double pTime, const std::string& pSwarmName
 : event::Event(pTime, pDuration, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex(-1)
 , mAgentRangeEndIndex(-1)
 , mParameterValues(pParameterValues)
@@ -60,6 +69,8 @@ SetParameterEvent::SetParameterEvent(double pTime, const std::string& pSwarmName
 : event::Event(pTime, pDuration, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex(pAgentIndex)
 , mAgentRangeEndIndex(pAgentIndex)
 , mParameterValues(pParameterValues)
@@ -72,6 +83,8 @@ SetParameterEvent::SetParameterEvent(double pTime, const std::string& pSwarmName
 : event::Event(pTime, pDuration, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex( pAgentRange[0] )
 , mAgentRangeEndIndex( pAgentRange[1] )
 , mParameterValues(pParameterValues)
@@ -84,6 +97,8 @@ SetParameterEvent::SetParameterEvent( const std::string& pSwarmName, const std::
 : event::Event(0.0, -1.0, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex(-1)
 , mAgentRangeEndIndex(-1)
 , mParameterValues(pMinParameterValues)
@@ -96,6 +111,8 @@ SetParameterEvent::SetParameterEvent( const std::string& pSwarmName, const std::
 : event::Event(0.0, -1.0, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex(pAgentIndex)
 , mAgentRangeEndIndex(pAgentIndex)
 , mParameterValues(pMinParameterValues)
@@ -108,6 +125,8 @@ SetParameterEvent::SetParameterEvent(const std::string& pSwarmName, const std::s
 : event::Event(0.0, -1.0, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex( pAgentRange[0] )
 , mAgentRangeEndIndex( pAgentRange[1] )
 , mParameterValues(pMinParameterValues)
@@ -120,6 +139,8 @@ SetParameterEvent::SetParameterEvent(double pTime, const std::string& pSwarmName
 : event::Event(pTime, -1.0, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex(-1)
 , mAgentRangeEndIndex(-1)
 , mParameterValues(pMinParameterValues)
@@ -132,6 +153,8 @@ SetParameterEvent::SetParameterEvent(double pTime, const std::string& pSwarmName
 : event::Event(pTime, -1.0, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex(pAgentIndex)
 , mAgentRangeEndIndex(pAgentIndex)
 , mParameterValues(pMinParameterValues)
@@ -144,6 +167,8 @@ SetParameterEvent::SetParameterEvent(double pTime, const std::string& pSwarmName
 : event::Event(pTime, -1.0, event::RelativeTime)
 , mSwarmName(pSwarmName)
 , mParameterName(pParameterName)
+, mSwarmSymbol(pSwarmName)
+, mParameterSymbol(pParameterName)
 , mAgentRangeStartIndex( pAgentRange[0] )
 , mAgentRangeEndIndex( pAgentRange[1] )
 , mParameterValues(pMinParameterValues)
@@ -156,6 +181,8 @@ SetParameterEvent::SetParameterEvent( const SetParameterEvent& pEvent )
 : event::Event( pEvent )
 , mSwarmName( pEvent.mSwarmName )
 , mParameterName( pEvent.mParameterName )
+, mSwarmSymbol( pEvent.mSwarmSymbol )
+, mParameterSymbol( pEvent.mParameterSymbol )
 , mAgentRangeStartIndex( pEvent.mAgentRangeStartIndex )
 , mAgentRangeEndIndex( pEvent.mAgentRangeEndIndex )
 , mParameterValues( pEvent.mParameterValues )
@@ -168,6 +195,8 @@ SetParameterEvent::SetParameterEvent( double pTime, const SetParameterEvent& pEv
 : event::Event( pTime, pEvent )
 , mSwarmName( pEvent.mSwarmName )
 , mParameterName( pEvent.mParameterName )
+, mSwarmSymbol( pEvent.mSwarmSymbol )
+, mParameterSymbol( pEvent.mParameterSymbol )
 , mAgentRangeStartIndex( pEvent.mAgentRangeStartIndex )
 , mAgentRangeEndIndex( pEvent.mAgentRangeEndIndex )
 , mParameterValues( pEvent.mParameterValues )
@@ -191,6 +220,24 @@ SetParameterEvent::copy( double pTime ) const
 	return new SetParameterEvent( pTime, *this );
 }
 
+const Symbol&
+SetParameterEvent::swarmSymbol() const
+{
+	return mSwarmSymbol;
+}
+
+const Symbol&
+SetParameterEvent::parameterSymbol() const
+{
+	return mParameterSymbol;
+}
+
+std::array<int, 2>
+SetParameterEvent::agentRange() const
+{
+	return std::array<int, 2>{ { mAgentRangeStartIndex, mAgentRangeEndIndex } };
+}
+
 void
 SetParameterEvent::execute() throw (Exception)
 {
@@ -229,9 +276,9 @@ SetParameterEvent::execute() throw (Exception)
 		}
 		
 		// simple version of parameter set for env
-		if( Simulation::get().checkEnv(mSwarmName) == true )
+		if( Simulation::get().checkEnv(mSwarmSymbol) == true )
 		{
-			Env* env = Simulation::get().env( mSwarmName );
+			Env* env = Simulation::get().env( mSwarmSymbol );
 			env->set( mParameterName, mParameterValues );
 			mFinished = true;
 			
@@ -240,7 +287,7 @@ SetParameterEvent::execute() throw (Exception)
 		// env done
 		
 		
-		Swarm* swarm = Simulation::get().swarm(mSwarmName);
+		Swarm* swarm = Simulation::get().swarm(mSwarmSymbol);
         std::vector<Agent*>& agents = swarm->agents();
 		
 		///////////////////////////////
@@ -253,7 +300,7 @@ SetParameterEvent::execute() throw (Exception)
 			{
 				unsigned int valueDim = mParameterValues.rows();
 				
-				Parameter* parameter = ( static_cast<Agent*>( swarm ) )->parameter(mParameterName);
+				Parameter* parameter = ( static_cast<Agent*>( swarm ) )->parameter(mParameterSymbol);
 				Eigen::VectorXf& curParValues = parameter->values();
 				
 				//std::cout << "curParValues " << curParValues << "\n";
@@ -267,16 +314,15 @@ SetParameterEvent::execute() throw (Exception)
 			}
 			else if( mRandomize == true )
 			{
-				math::Math<>& math = math::Math<>::get();
-				unsigned int valueDim = mParameterValues.rows();
-				Eigen::VectorXf randomValues( valueDim );
+				RandomStream random = Simulation::get().randomStream( RandomStream::streamId( mParameterName ) );
+				Eigen::VectorXf randomValues( mParameterValues.rows() );
 				
-				for(int d=0; d<valueDim; ++d) randomValues[d] = math.random( mParameterValues[d], mParameterValues2[d] );
-				( static_cast<Agent*>( swarm ) )->parameter(mParameterName)->setValues(randomValues);
+				random.fill( randomValues, mParameterValues, mParameterValues2 );
+				( static_cast<Agent*>( swarm ) )->parameter(mParameterSymbol)->setValues(randomValues);
 			}
 			else
 			{
-				( static_cast<Agent*>( swarm ) )->parameter(mParameterName)->setValues(mParameterValues);
+				( static_cast<Agent*>( swarm ) )->parameter(mParameterSymbol)->setValues(mParameterValues);
 			}
 		}
 		
@@ -286,7 +332,7 @@ SetParameterEvent::execute() throw (Exception)
 		
 		if(agents.size() != 0)
 		{
-			unsigned int parameterIndex = agents[0]->parameterIndex(mParameterName);
+			unsigned int parameterIndex = agents[0]->parameterIndex(mParameterSymbol);
 			int agentRangeStartIndex = mAgentRangeStartIndex;
 			int agentRangeEndIndex = mAgentRangeEndIndex;
 			
@@ -320,13 +366,12 @@ SetParameterEvent::execute() throw (Exception)
 			}
 			else if( mRandomize == true )
 			{
-				math::Math<>& math = math::Math<>::get();
-				unsigned int valueDim = mParameterValues.rows();
-				Eigen::VectorXf randomValues( valueDim );
+				RandomStream random = Simulation::get().randomStream( RandomStream::streamId( mParameterName ) );
+				Eigen::VectorXf randomValues( mParameterValues.rows() );
 				
 				for(int agentNr = agentRangeStartIndex; agentNr <= agentRangeEndIndex; ++agentNr)
 				{
-					for(int d=0; d<valueDim; ++d) randomValues[d] = math.random( mParameterValues[d], mParameterValues2[d] );
+					random.fill( randomValues, mParameterValues, mParameterValues2 );
 					
 					agents[agentNr]->parameter(parameterIndex)->setValues(randomValues);
 					
@@ -43,9 +43,15 @@ public:
     event::Event* copy( double pTime ) const;
     void execute() throw (Exception);
     
+    const Symbol& swarmSymbol() const;
+    const Symbol& parameterSymbol() const;
+    std::array<int, 2> agentRange() const;
+    
 protected:
     std::string mSwarmName;
     std::string mParameterName;
+    Symbol mSwarmSymbol;
+    Symbol mParameterSymbol;
     int mAgentRangeStartIndex;
     int mAgentRangeEndIndex;
     Eigen::VectorXf mParameterValues;
@@ -6,9 +6,13 @@
 #include "dab_flock_agent.h"
 #include "dab_flock_swarm.h"
 #include "dab_flock_env.h"
+#include "dab_flock_serialize.h"
+#include "dab_flock_allocation_counter.h"
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <algorithm>
+#include <unordered_set>
 
 using namespace dab;
 using namespace dab::flock;
@@ -17,15 +21,28 @@ void
 Simulation::setUpdateInterval(float pUpdateInterval)
 {
 	mUpdateInterval = pUpdateInterval;
+	
+	rescheduleThread();
 }
 
 Simulation::Simulation()
 : mUpdateInterval(10000) // 100 times per second
+, mUpdateRate(0.0)
 , mSimulationStep( 0 )
+, mThreadPool( 1 )
+, mThreadCount( 1 )
+, mAgentGroupsChanged( true )
+, mBatchedExecution( true )
+, mStructureVersion( 0 )
+, mRandomSeed( 1 )
+, mRandomSequence( 0 )
 , mTerminated(false)
 , mEventManager()
 , mPaused(false)
 , mFrozen(false)
+, mFreeRun(false)
+, mMaxCatchUpSteps(4)
+, mRescheduled(false)
 {
 	mTime = ofGetElapsedTimeMillis();
 }
@@ -51,6 +68,73 @@ Simulation::updateInterval() const
 	return mUpdateInterval;
 }
 
+bool
+Simulation::freeRun() const
+{
+	return mFreeRun;
+}
+
+void
+Simulation::setFreeRun(bool pFreeRun)
+{
+	mFreeRun = pFreeRun;
+	
+	rescheduleThread();
+}
+
+unsigned int
+Simulation::maxCatchUpSteps() const
+{
+	return mMaxCatchUpSteps;
+}
+
+void
+Simulation::setMaxCatchUpSteps(unsigned int pMaxCatchUpSteps)
+{
+	mMaxCatchUpSteps = pMaxCatchUpSteps;
+}
+
+Simulation::SchedulerStats
+Simulation::schedulerStats()
+{
+	std::lock_guard<std::mutex> lock( mSchedulerLock );
+	
+	return mSchedulerStats;
+}
+
+void
+Simulation::resetSchedulerStats()
+{
+	std::lock_guard<std::mutex> lock( mSchedulerLock );
+	
+	mSchedulerStats = SchedulerStats();
+}
+
+unsigned int
+Simulation::threadCount() const
+{
+	return mThreadCount;
+}
+
+void
+Simulation::setThreadCount(unsigned int pThreadCount)
+{
+	mThreadCount = std::max<unsigned int>(pThreadCount, 1);
+}
+
+bool
+Simulation::batchedExecution() const
+{
+	return mBatchedExecution;
+}
+
+void
+Simulation::setBatchedExecution(bool pBatchedExecution)
+{
+	mBatchedExecution = pBatchedExecution;
+	mAgentGroupsChanged = true;
+}
+
 event::EventManager&
 Simulation::event()
 {
@@ -111,6 +195,8 @@ void
 Simulation::addAgent(Agent* pAgent)
 {
 	mAgents.push_back(pAgent);
+	mAgentGroupsChanged = true;
+	mStructureVersion++;
     
 	// register all parameter of agent as event targets in the event manager
     // ???
@@ -125,23 +211,115 @@ Simulation::addAgent(Agent* pAgent)
 void
 Simulation::removeAgent(Agent* pAgent)
 {
-	int agentCount = mAgents.size();
-	for(int i=agentCount-1; i>=0; --i)
-    {
-        if( mAgents[i] == pAgent ) mAgents.erase(mAgents.begin() + i);
-    }
+	// recently added agents are found close to the end
+	auto agentIter = std::find( mAgents.rbegin(), mAgents.rend(), pAgent );
+	if( agentIter != mAgents.rend() ) mAgents.erase( std::next( agentIter ).base() );
+	
+	mAgentGroupsChanged = true;
+	mStructureVersion++;
 }
 
-bool
-Simulation::checkSwarm( std::string pName )
+void
+Simulation::addAgents(const std::vector<Agent*>& pAgents)
 {
-	unsigned int swarmCount = mSwarms.size();
-	for(unsigned int i=0; i<swarmCount; ++i)
+	if( pAgents.empty() == true ) return;
+	
+	mAgents.insert( mAgents.end(), pAgents.begin(), pAgents.end() );
+	mAgentGroupsChanged = true;
+	mStructureVersion++;
+}
+
+void
+Simulation::removeAgents(const std::vector<Agent*>& pAgents)
+{
+	if( pAgents.empty() == true ) return;
+	if( pAgents.size() == 1 )
 	{
-		if(mSwarms[i]->name() == pName) return true;
+		removeAgent( pAgents[0] );
+		return;
 	}
 	
-	return false;
+	std::unordered_set<Agent*> removedAgents( pAgents.begin(), pAgents.end() );
+	mAgents.erase( std::remove_if( mAgents.begin(), mAgents.end(), [&removedAgents](Agent* pAgent){ return removedAgents.count( pAgent ) > 0; } ), mAgents.end() );
+	
+	mAgentGroupsChanged = true;
+	mStructureVersion++;
+}
+
+void
+Simulation::invalidateAgentGroups()
+{
+	mAgentGroupsChanged = true;
+}
+
+unsigned long
+Simulation::structureVersion() const
+{
+	return mStructureVersion;
+}
+
+void
+Simulation::invalidateStructure()
+{
+	mStructureVersion++;
+	mAgentGroupsChanged = true;
+}
+
+uint64_t
+Simulation::randomSeed() const
+{
+	return mRandomSeed;
+}
+
+void
+Simulation::setRandomSeed(uint64_t pSeed)
+{
+	mRandomSeed = pSeed;
+	mRandomSequence = 0;
+}
+
+RandomStream
+Simulation::randomStream(uint32_t pStreamId, uint32_t pAgentIndex) const
+{
+	return RandomStream( mRandomSeed, pStreamId, pAgentIndex, mSimulationStep );
+}
+
+RandomStream
+Simulation::randomStream(uint32_t pStreamId)
+{
+	// the highest bit of the agent index separates these streams from agent streams
+	return RandomStream( mRandomSeed, pStreamId, mRandomSequence++ | 0x80000000u, mSimulationStep );
+}
+
+void
+Simulation::addSnapshotBuffer(std::shared_ptr<SnapshotBuffer> pBuffer)
+{
+	std::lock_guard<std::mutex> lock( mSnapshotLock );
+	
+	if( std::find( mSnapshotBuffers.begin(), mSnapshotBuffers.end(), pBuffer ) == mSnapshotBuffers.end() ) mSnapshotBuffers.push_back( pBuffer );
+}
+
+void
+Simulation::removeSnapshotBuffer(std::shared_ptr<SnapshotBuffer> pBuffer)
+{
+	std::lock_guard<std::mutex> lock( mSnapshotLock );
+	
+	auto iter = std::find( mSnapshotBuffers.begin(), mSnapshotBuffers.end(), pBuffer );
+	if( iter != mSnapshotBuffers.end() ) mSnapshotBuffers.erase( iter );
+}
+
+bool
+Simulation::checkSwarm( std::string pName )
+{
+	int symbolId = SymbolTable::get().find( pName );
+	
+	return symbolId >= 0 && symbolId < static_cast<int>( mSwarmSymbols.size() ) && mSwarmSymbols[symbolId] != nullptr;
+}
+
+bool
+Simulation::checkSwarm(const Symbol& pSymbol) const
+{
+	return pSymbol.id() < mSwarmSymbols.size() && mSwarmSymbols[pSymbol.id()] != nullptr;
 }
 
 std::vector<Swarm*>&
@@ -161,19 +339,33 @@ Simulation::swarm(unsigned int pIndex) throw (Exception)
 Swarm*
 Simulation::swarm(std::string pName) throw (Exception)
 {
-	unsigned int swarmCount = mSwarms.size();
-	for(unsigned int i=0; i<swarmCount; ++i)
-	{
-		if(mSwarms[i]->name() == pName) return mSwarms[i];
-	}
+	int symbolId = SymbolTable::get().find( pName );
+	
+	if( symbolId >= 0 && symbolId < static_cast<int>( mSwarmSymbols.size() ) && mSwarmSymbols[symbolId] != nullptr ) return mSwarmSymbols[symbolId];
 	
 	throw Exception( "FLOCK ERROR: swarm " + pName + " not found", __FILE__, __FUNCTION__, __LINE__ );
 }
 
+Swarm*
+Simulation::swarm(const Symbol& pSymbol) throw (Exception)
+{
+	if( pSymbol.id() < mSwarmSymbols.size() && mSwarmSymbols[pSymbol.id()] != nullptr ) return mSwarmSymbols[pSymbol.id()];
+	
+	throw Exception( "FLOCK ERROR: swarm " + pSymbol.name() + " not found", __FILE__, __FUNCTION__, __LINE__ );
+}
+
 void
 Simulation::addSwarm(Swarm* pSwarm)
 {
 	mSwarms.push_back(pSwarm);
+	
+	// the first swarm with a given name is found by name, as before
+	unsigned int symbolId = SymbolTable::get().id( pSwarm->name() );
+	if( symbolId >= mSwarmSymbols.size() ) mSwarmSymbols.resize( symbolId + 1, nullptr );
+	if( mSwarmSymbols[symbolId] == nullptr ) mSwarmSymbols[symbolId] = pSwarm;
+	
+	mAgentGroupsChanged = true;
+	mStructureVersion++;
 }
 
 void
@@ -184,18 +376,31 @@ Simulation::removeSwarm(Swarm* pSwarm)
     {
         if( mSwarms[i] == pSwarm ) mSwarms.erase(mSwarms.begin() + i);
     }
+	
+	unsigned int symbolId = SymbolTable::get().id( pSwarm->name() );
+	
+	if( symbolId < mSwarmSymbols.size() && mSwarmSymbols[symbolId] == pSwarm )
+	{
+		auto iter = std::find_if( mSwarms.begin(), mSwarms.end(), [pSwarm](Swarm* pOtherSwarm){ return pOtherSwarm->name() == pSwarm->name(); } );
+		mSwarmSymbols[symbolId] = iter != mSwarms.end() ? *iter : nullptr;
+	}
+	
+	mAgentGroupsChanged = true;
+	mStructureVersion++;
 }
 
 bool
 Simulation::checkEnv( std::string pName )
 {
-	unsigned int envCount = mEnvs.size();
-	for(unsigned int i=0; i<envCount; ++i)
-	{
-		if(mEnvs[i]->name() == pName) return true;
-	}
+	int symbolId = SymbolTable::get().find( pName );
 	
-	return false;
+	return symbolId >= 0 && symbolId < static_cast<int>( mEnvSymbols.size() ) && mEnvSymbols[symbolId] != nullptr;
+}
+
+bool
+Simulation::checkEnv(const Symbol& pSymbol) const
+{
+	return pSymbol.id() < mEnvSymbols.size() && mEnvSymbols[pSymbol.id()] != nullptr;
 }
 
 std::vector<Env*>&
@@ -215,19 +420,32 @@ Simulation::env(unsigned int pIndex) throw (Exception)
 Env*
 Simulation::env(std::string pName) throw (Exception)
 {
-	unsigned int envCount = mEnvs.size();
-	for(unsigned int i=0; i<envCount; ++i)
-	{
-		if(mEnvs[i]->name() == pName) return mEnvs[i];
-	}
+	int symbolId = SymbolTable::get().find( pName );
+	
+	if( symbolId >= 0 && symbolId < static_cast<int>( mEnvSymbols.size() ) && mEnvSymbols[symbolId] != nullptr ) return mEnvSymbols[symbolId];
 	
 	throw Exception( "FLOCK ERROR: environment " + pName + " not found", __FILE__, __FUNCTION__, __LINE__ );
 }
 
+Env*
+Simulation::env(const Symbol& pSymbol) throw (Exception)
+{
+	if( pSymbol.id() < mEnvSymbols.size() && mEnvSymbols[pSymbol.id()] != nullptr ) return mEnvSymbols[pSymbol.id()];
+	
+	throw Exception( "FLOCK ERROR: environment " + pSymbol.name() + " not found", __FILE__, __FUNCTION__, __LINE__ );
+}
+
 void
 Simulation::addEnv(Env* pEnv)
 {
 	mEnvs.push_back(pEnv);
+	
+	unsigned int symbolId = SymbolTable::get().id( pEnv->name() );
+	if( symbolId >= mEnvSymbols.size() ) mEnvSymbols.resize( symbolId + 1, nullptr );
+	if( mEnvSymbols[symbolId] == nullptr ) mEnvSymbols[symbolId] = pEnv;
+	
+	mAgentGroupsChanged = true;
+	mStructureVersion++;
 }
 
 void
@@ -238,6 +456,17 @@ Simulation::removeEnv(Env* pEnv)
     {
         if( mEnvs[i] == pEnv ) mEnvs.erase(mEnvs.begin() + i);
     }
+	
+	unsigned int symbolId = SymbolTable::get().id( pEnv->name() );
+	
+	if( symbolId < mEnvSymbols.size() && mEnvSymbols[symbolId] == pEnv )
+	{
+		auto iter = std::find_if( mEnvs.begin(), mEnvs.end(), [pEnv](Env* pOtherEnv){ return pOtherEnv->name() == pEnv->name(); } );
+		mEnvSymbols[symbolId] = iter != mEnvs.end() ? *iter : nullptr;
+	}
+	
+	mAgentGroupsChanged = true;
+	mStructureVersion++;
 }
 
 void
@@ -261,6 +490,7 @@ Simulation::clear()
         mSwarms[sI]->clear();
     }
     mSwarms.clear();
+	mSwarmSymbols.clear();
 	
 	// remove envs
     int envCount = mEnvs.size();
@@ -269,6 +499,7 @@ Simulation::clear()
         delete mEnvs[eI];
     }
     mEnvs.clear();
+	mEnvSymbols.clear();
 	
 	// remove com
 	FlockCom::get().removeSenders();
@@ -280,44 +511,259 @@ Simulation::clear()
 	Swarm::sInstanceCount = 0;
 	Agent::sInstanceCount = 0;
 	
+	mAgentGroupsChanged = true;
+	mStructureVersion++;
+	
 	mPaused = false;
 	
+	rescheduleThread();
+	
 	//std::cout << "Simulation::clear() end\n";
 }
 
 void
 Simulation::update()
 {
+	FlockProfiler& profiler = FlockProfiler::get();
+	
+	// frozen steps are not profiled, a step during which the simulation gets frozen only counts its com and event phases
+	bool profiling = profiler.enabled() == true && mFrozen == false;
+	
+	if( profiling == true ) profiler.beginStep();
+	
 	FlockCom::get().update();
+	
+	if( profiling == true ) profiler.endPhase( FlockProfiler::ComPhase );
 
 	mEventManager.update();
+	if( SerializeTools::savesCompleted() == true ) SerializeTools::get().reportSaves();
+	
+	if( profiling == true ) profiler.endPhase( FlockProfiler::EventPhase );
     
 	if( mFrozen == false )
 	{
 		notifyListeners();
+		
+		if( profiling == true ) profiler.skipPhase();
 
 		space::SpaceManager::get().update();
 		
-		unsigned int swarmCount = mSwarms.size();
-		unsigned int agentCount = mAgents.size();
-        
-		//for(unsigned int i=0; i<swarmCount; ++i) mSwarms[i]->act();
-		for(unsigned int i=0; i<agentCount; ++i) mAgents[i]->act();
+		if( profiling == true ) profiler.endPhase( FlockProfiler::SpacePhase );
+		
+		unsigned int requestedThreadCount = mThreadCount;
+		
+		if( mThreadPool.threadCount() != requestedThreadCount )
+		{
+			mThreadPool.setThreadCount(requestedThreadCount);
+			mAgentGroupsChanged = true;
+		}
+		
+		if( mAgentGroupsChanged == true ) updateAgentGroups();
         
-		//for(unsigned int i=0; i<swarmCount; ++i) mSwarms[i]->flush();
-		for(unsigned int i=0; i<agentCount; ++i) mAgents[i]->flush();
+		actAgents();
+		
+		if( profiling == true ) profiler.endPhase( FlockProfiler::ActPhase );
+		
+		flushAgents();
+		
+		if( profiling == true ) profiler.endPhase( FlockProfiler::FlushPhase );
         
 		FlockStats::Singleton<FlockStats>::get().update();
+		
+		if( profiling == true )
+		{
+			profiler.endPhase( FlockProfiler::StatsPhase );
+			profiler.endStep();
+		}
         
 		//for(unsigned int i=0; i<agentCount; ++i) std::cout << "i " << i << " name " << mAgents[i]->name().toStdString() << "\n";
 		//std::cout << "mass " << mAgents[0]->parameter("mass").values() << " prefVel " << mAgents[0]->parameter("damping_prefVelocity").values() << "\n";
         
 		mSimulationStep++;
 	}
+	else if( profiling == true ) profiler.endStep();
+	
+	publishSnapshots();
 	
 	//std::cout << "Simulation::update() end\n";
 }
 
+void
+Simulation::updateAgentGroups()
+{
+	mAgentGroups.clear();
+	
+	// shared behaviors need a worker for each thread and parameter indices that match the current agent parameters
+	unsigned int swarmCount = mSwarms.size();
+	for(unsigned int sI=0; sI<swarmCount; ++sI) mSwarms[sI]->updateSharedBehaviors( mThreadPool.threadCount() );
+	
+	unsigned int agentCount = mAgents.size();
+	
+	for(unsigned int i=0; i<agentCount; ++i)
+	{
+		Agent* agent = mAgents[i];
+		bool parallel = dynamic_cast<Swarm*>(agent) == nullptr && dynamic_cast<Env*>(agent) == nullptr;
+		
+		unsigned int behaviorCount = agent->behaviorCount();
+		for(unsigned int bI=0; bI<behaviorCount && parallel == true; ++bI)
+		{
+			if( agent->behavior(bI)->threadSafe() == false ) parallel = false;
+		}
+		
+		bool joinGroup = mAgentGroups.size() > 0 && mAgentGroups.back().mParallel == parallel;
+		if( joinGroup == true && parallel == true && mBatchedExecution == true ) joinGroup = equalBehaviors( mAgents[i - 1], agent );
+		
+		if( joinGroup == true ) mAgentGroups.back().mEndIndex = i + 1;
+		else mAgentGroups.push_back( AgentGroup(i, i + 1, parallel) );
+	}
+	
+	if( mBatchedExecution == true )
+	{
+		unsigned int groupCount = mAgentGroups.size();
+		for(unsigned int gI=0; gI<groupCount; ++gI)
+		{
+			AgentGroup& group = mAgentGroups[gI];
+			unsigned int groupAgentCount = group.mEndIndex - group.mStartIndex;
+			
+			if( group.mParallel == false || groupAgentCount < 2 ) continue;
+			
+			unsigned int behaviorCount = mAgents[group.mStartIndex]->behaviorCount();
+			
+			group.mBehaviorCount = behaviorCount;
+			group.mBehaviors.resize( behaviorCount * groupAgentCount );
+			
+			for(unsigned int bI=0; bI<behaviorCount; ++bI)
+			{
+				Behavior** behaviors = group.mBehaviors.data() + bI * groupAgentCount;
+				for(unsigned int aI=0; aI<groupAgentCount; ++aI) behaviors[aI] = mAgents[group.mStartIndex + aI]->behavior(bI);
+			}
+		}
+	}
+	
+	mAgentGroupsChanged = false;
+}
+
+bool
+Simulation::equalBehaviors(Agent* pAgent1, Agent* pAgent2) const
+{
+	unsigned int behaviorCount = pAgent1->behaviorCount();
+	if( pAgent2->behaviorCount() != behaviorCount ) return false;
+	
+	for(unsigned int bI=0; bI<behaviorCount; ++bI)
+	{
+		Behavior* behavior1 = pAgent1->behavior(bI);
+		Behavior* behavior2 = pAgent2->behavior(bI);
+		
+		if( behavior1->name() != behavior2->name() || behavior1->className() != behavior2->className() ) return false;
+	}
+	
+	return true;
+}
+
+void
+Simulation::actAgents()
+{
+	// groups are processed in order so that each agent sees the same state as in serial execution
+	unsigned int groupCount = mAgentGroups.size();
+	for(unsigned int gI=0; gI<groupCount; ++gI)
+	{
+		AgentGroup& group = mAgentGroups[gI];
+		
+		if( group.mBehaviors.empty() == false )
+		{
+			if( mThreadPool.threadCount() == 1 ) actBatch( group, 0, group.mEndIndex - group.mStartIndex );
+			else mThreadPool.run( group.mEndIndex - group.mStartIndex, [this, &group](unsigned int pStartIndex, unsigned int pEndIndex)
+			{
+				actBatch( group, pStartIndex, pEndIndex );
+			});
+		}
+		else if( group.mParallel == false || mThreadPool.threadCount() == 1 )
+		{
+			for(unsigned int i=group.mStartIndex; i<group.mEndIndex; ++i) mAgents[i]->act();
+		}
+		else
+		{
+			Agent** agents = mAgents.data() + group.mStartIndex;
+			mThreadPool.run( group.mEndIndex - group.mStartIndex, [agents](unsigned int pStartIndex, unsigned int pEndIndex)
+			{
+				for(unsigned int i=pStartIndex; i<pEndIndex; ++i) agents[i]->act();
+			});
+		}
+	}
+}
+
+void
+Simulation::actBatch(AgentGroup& pGroup, unsigned int pStartIndex, unsigned int pEndIndex)
+{
+	Agent** agents = mAgents.data() + pGroup.mStartIndex;
+	
+	// inactive agents skip all their behaviors, a range containing one is executed agent-major instead
+	for(unsigned int aI=pStartIndex; aI<pEndIndex; ++aI)
+	{
+		if( agents[aI]->active() == true ) continue;
+		
+		for(unsigned int i=pStartIndex; i<pEndIndex; ++i) agents[i]->act();
+		return;
+	}
+	
+	// behaviors of a thread safe agent only read values and write backup values of their own agent, performing them behavior-major yields the same results as agent-major
+	unsigned int groupAgentCount = pGroup.mEndIndex - pGroup.mStartIndex;
+	unsigned int behaviorCount = pGroup.mBehaviorCount;
+	bool profiling = FlockProfiler::get().enabled();
+	
+	for(unsigned int bI=0; bI<behaviorCount; ++bI)
+	{
+		Behavior** behaviors = pGroup.mBehaviors.data() + bI * groupAgentCount + pStartIndex;
+		
+		if( profiling == true )
+		{
+			// the time of the whole range is accumulated in its first behavior, the profiler sums it up by behavior name
+			unsigned long startAllocationCount = AllocationCounter::threadCount();
+			FlockProfiler::Clock::time_point startTime = FlockProfiler::now();
+			behaviors[0]->actAll( agents + pStartIndex, behaviors, pEndIndex - pStartIndex );
+			behaviors[0]->addProfileTime( FlockProfiler::elapsed( startTime, FlockProfiler::now() ), AllocationCounter::threadCount() - startAllocationCount );
+		}
+		else
+		{
+			behaviors[0]->actAll( agents + pStartIndex, behaviors, pEndIndex - pStartIndex );
+		}
+	}
+}
+
+void
+Simulation::flushAgents()
+{
+	unsigned int groupCount = mAgentGroups.size();
+	for(unsigned int gI=0; gI<groupCount; ++gI)
+	{
+		const AgentGroup& group = mAgentGroups[gI];
+		
+		if( group.mParallel == false || mThreadPool.threadCount() == 1 )
+		{
+			for(unsigned int i=group.mStartIndex; i<group.mEndIndex; ++i) mAgents[i]->flush();
+		}
+		else
+		{
+			Agent** agents = mAgents.data() + group.mStartIndex;
+			mThreadPool.run( group.mEndIndex - group.mStartIndex, [agents](unsigned int pStartIndex, unsigned int pEndIndex)
+			{
+				for(unsigned int i=pStartIndex; i<pEndIndex; ++i) agents[i]->flush();
+			});
+		}
+	}
+}
+
+void
+Simulation::publishSnapshots()
+{
+	// skip publishing rather than wait while a buffer is being registered
+	std::unique_lock<std::mutex> lock( mSnapshotLock, std::try_to_lock );
+	if( lock.owns_lock() == false ) return;
+	
+	unsigned int bufferCount = mSnapshotBuffers.size();
+	for(unsigned int bI=0; bI<bufferCount; ++bI) mSnapshotBuffers[bI]->publish( mSimulationStep );
+}
+
 void
 Simulation::notifyListeners()
 {
@@ -334,35 +780,103 @@ Simulation::notifyListeners()
 void
 Simulation::threadedFunction()
 {
+	typedef std::chrono::steady_clock Clock;
+	typedef std::chrono::duration<double, std::milli> Milliseconds;
+	
+	Clock::time_point deadline = Clock::now();
+	Clock::time_point lastStepTime = deadline;
+	
 	while (isThreadRunning())
 	{
-		if (mPaused == false)
+		if (mPaused == true)
 		{
-			double currentTime = ofGetElapsedTimeMillis();
-			if (currentTime - mTime < mUpdateInterval) continue;
-			else mTime = currentTime;
-
-			update();
+			std::unique_lock<std::mutex> lock( mSchedulerLock );
+			mSchedulerCondition.wait( lock, [this]{ return mPaused == false || isThreadRunning() == false; } );
+			
+			// time spent paused is not caught up
+			mRescheduled = true;
+			continue;
+		}
+		
+		if (mRescheduled == true)
+		{
+			mRescheduled = false;
+			deadline = Clock::now();
+		}
+		
+		Clock::duration interval = std::chrono::duration_cast<Clock::duration>( Milliseconds(mUpdateInterval) );
+		
+		if (mFreeRun == false && Clock::now() < deadline)
+		{
+			// woken up early by stop, pause or a changed schedule, the loop then checks again
+			std::unique_lock<std::mutex> lock( mSchedulerLock );
+			mSchedulerCondition.wait_until( lock, deadline, [this]{ return mRescheduled == true || mPaused == true; } );
+			continue;
+		}
+		
+		Clock::time_point stepStartTime = Clock::now();
+		
+		update();
+		
+		Clock::time_point stepEndTime = Clock::now();
+		
+		double jitter = mFreeRun == true ? 0.0 : Milliseconds( stepStartTime - deadline ).count();
+		double stepTime = Milliseconds( stepEndTime - stepStartTime ).count();
+		
+		recordStep( jitter, stepTime );
+		
+		double stepPeriod = Milliseconds( stepStartTime - lastStepTime ).count();
+		if (stepPeriod > 0.0) mUpdateRate = 0.9 * mUpdateRate + 0.1 * 1000.0 / stepPeriod;
+		lastStepTime = stepStartTime;
+		mTime = ofGetElapsedTimeMillis();
+		
+		if (mFreeRun == true) continue;
+		
+		// fixed step: the next deadline doesn't depend on when this step ran
+		deadline += interval;
+		
+		// drop steps that lie more than the catch-up limit behind
+		if (interval.count() > 0 && stepEndTime > deadline)
+		{
+			unsigned long behindSteps = ( stepEndTime - deadline ) / interval;
+			
+			if (behindSteps > mMaxCatchUpSteps)
+			{
+				unsigned long droppedSteps = behindSteps - mMaxCatchUpSteps;
+				deadline += interval * droppedSteps;
+				
+				std::lock_guard<std::mutex> lock( mSchedulerLock );
+				mSchedulerStats.mDroppedStepCount += droppedSteps;
+			}
 		}
+	}
+}
 
-		std::this_thread::sleep_for(std::chrono::microseconds(10));
+void
+Simulation::rescheduleThread()
+{
+	{
+		std::lock_guard<std::mutex> lock( mSchedulerLock );
+		mRescheduled = true;
 	}
+	
+	mSchedulerCondition.notify_all();
+}
 
-	//while(mTerminated == false)
-	//{
- //       if(mPaused == false)
- //       {
- //           double currentTime = ofGetElapsedTimeMillis();
- //           if(currentTime - mTime < mUpdateInterval) continue;
- //           else mTime = currentTime;
- //           
- //           update();
- //       }
- //       
-	//	std::this_thread::sleep_for(std::chrono::microseconds(10));
-	//}
-	//
-	//if( mTerminated == true ) mTerminated = false;
+void
+Simulation::recordStep(double pJitter, double pStepTime)
+{
+	std::lock_guard<std::mutex> lock( mSchedulerLock );
+	
+	SchedulerStats& stats = mSchedulerStats;
+	
+	stats.mStepCount++;
+	if (mFreeRun == false && pStepTime > mUpdateInterval) stats.mOverrunCount++;
+	
+	stats.mMeanJitter += ( pJitter - stats.mMeanJitter ) / static_cast<double>(stats.mStepCount);
+	stats.mMeanStepTime += ( pStepTime - stats.mMeanStepTime ) / static_cast<double>(stats.mStepCount);
+	stats.mMaxJitter = std::max( stats.mMaxJitter, pJitter );
+	stats.mMaxStepTime = std::max( stats.mMaxStepTime, pStepTime );
 }
 
 bool
@@ -386,7 +900,11 @@ Simulation::start()
 void
 Simulation::stop()
 {
-	if (isThreadRunning() == true) stopThread();
+	if (isThreadRunning() == true)
+	{
+		stopThread();
+		rescheduleThread();
+	}
 
 	//mTerminated = true;
 }
@@ -394,7 +912,9 @@ Simulation::stop()
 void
 Simulation::switchPaused()
 {
-	mPaused = !mPaused;
+	mPaused = !mPaused.load();
+	
+	rescheduleThread();
 }
 
 void
@@ -415,7 +935,7 @@ Simulation::exceptionReport( const Exception& pException )
 		
 		try
 		{
-            FlockCom::get().OscMessenger::send("OSCErrorSender", errorMessage);
+            FlockCom::get().sendMessage("OSCErrorSender", errorMessage);
 		}
 		catch(Exception& e)
 		{
@@ -10,6 +10,9 @@
 #include "ofUtils.h"
 #include "ofThread.h"
 #include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #include "dab_singleton.h"
 #include "dab_exception.h"
@@ -17,6 +20,11 @@
 #include "dab_event_manager.h"
 #include "dab_flock_com.h"
 #include "dab_flock_stats.h"
+#include "dab_flock_profiler.h"
+#include "dab_flock_thread_pool.h"
+#include "dab_flock_snapshot.h"
+#include "dab_flock_random.h"
+#include "dab_flock_symbol.h"
 //#include <iso_base/iso_base_notifier.h>
 //#include <iso_math/iso_math_rectangle.h>
 //#include <iso_event/iso_event_includes.h>
@@ -29,6 +37,7 @@ namespace flock
 {
 
 class Agent;
+class Behavior;
 class Swarm;
 class Env;
 
@@ -37,6 +46,31 @@ class Simulation : public Singleton<Simulation>, public UpdateNotifier, public o
 friend class Singleton<Simulation>;
     
 public:
+    /**
+     \brief timing statistics of the simulation thread scheduler
+     */
+    class SchedulerStats
+    {
+    public:
+        SchedulerStats()
+        : mStepCount(0)
+        , mOverrunCount(0)
+        , mDroppedStepCount(0)
+        , mMeanJitter(0.0)
+        , mMaxJitter(0.0)
+        , mMeanStepTime(0.0)
+        , mMaxStepTime(0.0)
+        {};
+        
+        unsigned long mStepCount; /// \brief number of scheduled steps
+        unsigned long mOverrunCount; /// \brief number of steps that took longer than the update interval
+        unsigned long mDroppedStepCount; /// \brief number of steps skipped because the catch-up limit was exceeded
+        double mMeanJitter; /// \brief mean delay between deadline and step start (milliseconds)
+        double mMaxJitter; /// \brief maximum delay between deadline and step start (milliseconds)
+        double mMeanStepTime; /// \brief mean step duration (milliseconds)
+        double mMaxStepTime; /// \brief maximum step duration (milliseconds)
+    };
+    
     /**
      \brief return simulation step
      */
@@ -60,6 +94,72 @@ public:
      */
     void setUpdateInterval(float pUpdateInterval);
     
+    /**
+     \brief check whether the simulation thread runs steps as fast as possible
+     \return true if free running, false if running at the update interval
+     */
+    bool freeRun() const;
+    
+    /**
+     \brief run steps as fast as possible (e.g. for offline batch runs) instead of at the update interval
+     \param pFreeRun free running
+     */
+    void setFreeRun(bool pFreeRun);
+    
+    /**
+     \brief return maximum number of steps the simulation thread runs back to back to catch up with its schedule
+     \return maximum number of catch-up steps
+     */
+    unsigned int maxCatchUpSteps() const;
+    
+    /**
+     \brief set maximum number of steps the simulation thread runs back to back to catch up with its schedule
+     \param pMaxCatchUpSteps maximum number of catch-up steps
+     
+     steps beyond this limit are dropped and counted in the scheduler statistics
+     */
+    void setMaxCatchUpSteps(unsigned int pMaxCatchUpSteps);
+    
+    /**
+     \brief return timing statistics of the simulation thread scheduler
+     \return scheduler statistics
+     */
+    SchedulerStats schedulerStats();
+    
+    /**
+     \brief reset timing statistics of the simulation thread scheduler
+     */
+    void resetSchedulerStats();
+    
+    /**
+     \brief return number of threads used for the agent act and flush phases
+     \return thread count
+     */
+    unsigned int threadCount() const;
+    
+    /**
+     \brief set number of threads used for the agent act and flush phases
+     \param pThreadCount thread count (1: serial execution)
+     
+     the new thread count is applied at the beginning of the next simulation step
+     */
+    void setThreadCount(unsigned int pThreadCount);
+    
+    /**
+     \brief check whether behaviors are executed behavior-major
+     \return true if behavior-major execution is enabled
+     */
+    bool batchedExecution() const;
+    
+    /**
+     \brief enable or disable behavior-major execution
+     \param pBatchedExecution batched execution
+     
+     in behavior-major execution, each behavior acts on all agents that share the same behaviors (typically the agents of a swarm) before the next behavior acts.\n
+     this only applies to agents whose behaviors are thread safe and produces the same results as agent-major execution.\n
+     */
+    void setBatchedExecution(bool pBatchedExecution);
+    
     /**
      \brief return event manager
      \return event manager
@@ -122,6 +222,87 @@ public:
      */
     void removeAgent(Agent* pAgent);
     
+    /**
+     \brief add agents to simulation
+     \param pAgents agents
+     */
+    void addAgents(const std::vector<Agent*>& pAgents);
+    
+    /**
+     \brief remove agents from simulation
+     \param pAgents agents
+     
+     the remaining agents are compacted in a single pass and keep their order
+     */
+    void removeAgents(const std::vector<Agent*>& pAgents);
+    
+    /**
+     \brief mark serial and parallel agent groups for recomputation
+     
+     needs to be called whenever an agent's behaviors change
+     */
+    void invalidateAgentGroups();
+    
+    /**
+     \brief return structure version
+     \return structure version
+     
+     the structure version changes whenever agents, swarms, environments or parameters are added or removed. it allows to cache lookups by name.
+     */
+    unsigned long structureVersion() const;
+    
+    /**
+     \brief mark cached lookups by name as outdated
+     
+     needs to be called whenever an agent's parameters change
+     */
+    void invalidateStructure();
+    
+    /**
+     \brief register snapshot buffer into which a snapshot is published at the end of each simulation step
+     \param pBuffer snapshot buffer
+     */
+    void addSnapshotBuffer(std::shared_ptr<SnapshotBuffer> pBuffer);
+    
+    /**
+     \brief deregister snapshot buffer
+     \param pBuffer snapshot buffer
+     */
+    void removeSnapshotBuffer(std::shared_ptr<SnapshotBuffer> pBuffer);
+    
+    /**
+     \brief return random seed
+     \return random seed
+     */
+    uint64_t randomSeed() const;
+    
+    /**
+     \brief set random seed
+     \param pSeed random seed
+     
+     simulations with the same seed, the same setup and the same sequence of events produce identical random numbers
+     */
+    void setRandomSeed(uint64_t pSeed);
+    
+    /**
+     \brief create random stream for an agent in the current simulation step
+     \param pStreamId stream id (e.g. RandomStream::streamId of the behavior name)
+     \param pAgentIndex agent index
+     \return random stream
+     
+     the stream only depends on seed, stream id, agent index and simulation step and can be used from any thread
+     */
+    RandomStream randomStream(uint32_t pStreamId, uint32_t pAgentIndex) const;
+    
+    /**
+     \brief create random stream for randomizations that happen outside of the agents' act phase
+     \param pStreamId stream id (e.g. RandomStream::streamId of the parameter name)
+     \return random stream
+     
+     every call returns a different stream, the streams are reproducible as long as the calls happen in the same order
+     */
+    RandomStream randomStream(uint32_t pStreamId);
+    
     /**
      \brief check swarm
      \param pName swarm name
@@ -129,6 +310,13 @@ public:
      */
     bool checkSwarm( std::string pName );
     
+    /**
+     \brief check swarm
+     \param pSymbol swarm name symbol
+     \return true if swarm exists, false otherwise
+     */
+    bool checkSwarm(const Symbol& pSymbol) const;
+    
     /**
      \brief return swarms
      \return swarms
@@ -151,6 +339,14 @@ public:
      */
     Swarm* swarm(std::string pName) throw (Exception);
     
+    /**
+     \brief return swarm
+     \param pSymbol swarm name symbol
+     \return swarm
+     \exception Exception swarm not found
+     */
+    Swarm* swarm(const Symbol& pSymbol) throw (Exception);
+    
     /**
      \brief add swarm to simulation
      \param pSwarm swarm
@@ -170,6 +366,13 @@ public:
      */
     bool checkEnv( std::string pName );
     
+    /**
+     \brief check environment
+     \param pSymbol environment name symbol
+     \return true if environment exists, false otherwise
+     */
+    bool checkEnv(const Symbol& pSymbol) const;
+    
     /**
      \brief return environments
      \return environments
@@ -192,6 +395,14 @@ public:
      */
     Env* env(std::string pName) throw (Exception);
     
+    /**
+     \brief return environment
+     \param pSymbol environment name symbol
+     \return environment
+     \exception Exception environment not found
+     */
+    Env* env(const Symbol& pSymbol) throw (Exception);
+    
     /**
      \brief add environment to simulation
      \param pEnv environment
@@ -255,13 +466,91 @@ protected:
      */
     ~Simulation();
 
+    /**
+     \brief simulation thread loop
+     
+     steps are scheduled at fixed deadlines spaced by the update interval. the thread sleeps until the next deadline, late steps are caught up to a maximum number of back to back steps.
+     */
 	void threadedFunction();
     
+    /**
+     \brief wake up the simulation thread and restart its schedule
+     */
+    void rescheduleThread();
+    
+    /**
+     \brief add step timing to scheduler statistics
+     \param pJitter delay between deadline and step start (milliseconds)
+     \param pStepTime step duration (milliseconds)
+     */
+    void recordStep(double pJitter, double pStepTime);
+    
+    /**
+     \brief contiguous range of agents within mAgents
+     
+     swarms and environments act on other agents and are therefore processed serially, all other agents within a range are processed in parallel.\n
+     in batched execution, the agents of a parallel range share the same behaviors.\n
+     */
+    class AgentGroup
+    {
+    public:
+        unsigned int mStartIndex;
+        unsigned int mEndIndex;
+        bool mParallel;
+        unsigned int mBehaviorCount; /// \brief number of behaviors per agent (batched groups only)
+        std::vector<Behavior*> mBehaviors; /// \brief behaviors in behavior-major order (empty if the group is not batched)
+        
+        AgentGroup( unsigned int pStartIndex, unsigned int pEndIndex, bool pParallel )
+        : mStartIndex( pStartIndex )
+        , mEndIndex( pEndIndex )
+        , mParallel( pParallel )
+        , mBehaviorCount( 0 )
+        {};
+    };
+    
+    /**
+     \brief split agents into serial and parallel agent groups
+     */
+    void updateAgentGroups();
+    
+    /**
+     \brief check whether two agents possess behaviors of equal names and classes in the same order
+     \param pAgent1 first agent
+     \param pAgent2 second agent
+     \return true if the behaviors are equal
+     */
+    bool equalBehaviors(Agent* pAgent1, Agent* pAgent2) const;
+    
+    /**
+     \brief perform behaviors of all agents
+     */
+    void actAgents();
+    
+    /**
+     \brief perform behaviors of a range of agents of a batched group behavior-major
+     \param pGroup batched agent group
+     \param pStartIndex index of first agent relative to group
+     \param pEndIndex index after last agent relative to group
+     */
+    void actBatch(AgentGroup& pGroup, unsigned int pStartIndex, unsigned int pEndIndex);
+    
+    /**
+     \brief copy backup values of all agents into their values
+     */
+    void flushAgents();
+    
+    /**
+     \brief publish snapshot into all registered snapshot buffers
+     */
+    void publishSnapshots();
+    
     static Simulation* sSimulation; /// \brief singleton instance
     
     std::vector<Agent*> mAgents; /// \brief agents
     std::vector<Swarm*> mSwarms;/// \brief swarms
     std::vector<Env*> mEnvs; ///\brief environments
+    std::vector<Swarm*> mSwarmSymbols; /// \brief swarms indexed by name symbol id (nullptr if no swarm has that name)
+    std::vector<Env*> mEnvSymbols; /// \brief environments indexed by name symbol id (nullptr if no environment has that name)
     double mUpdateInterval; /// \brief simulation update interval (milliseconds)
     float mUpdateRate; ///\brief simulation update rate
     bool mTerminated; /// \brief simulation termination flag
@@ -269,8 +558,28 @@ protected:
     event::EventManager mEventManager; /// \brief event manager
     long mSimulationStep;
     
-    bool mPaused;
+    ThreadPool mThreadPool; /// \brief worker threads for agent act and flush phases
+    std::atomic<unsigned int> mThreadCount; /// \brief requested thread count (set from any thread)
+    std::vector<AgentGroup> mAgentGroups; /// \brief serial and parallel agent groups
+    bool mAgentGroupsChanged; /// \brief agent groups need to be recomputed
+    bool mBatchedExecution; /// \brief execute behaviors behavior-major
+    unsigned long mStructureVersion; /// \brief incremented whenever agents or parameters are added or removed
+    
+    uint64_t mRandomSeed; /// \brief random seed
+    std::atomic<uint32_t> mRandomSequence; /// \brief number of random streams created by randomStream(pStreamId)
+    
+    std::vector< std::shared_ptr<SnapshotBuffer> > mSnapshotBuffers; /// \brief registered snapshot buffers
+    std::mutex mSnapshotLock; /// \brief guards the snapshot buffer registry, the simulation only tries to lock it
+    
+    std::atomic<bool> mPaused; /// \brief simulation thread waits, predicate of the scheduler wait
     bool mFrozen;
+    
+    bool mFreeRun; /// \brief run steps as fast as possible
+    unsigned int mMaxCatchUpSteps; /// \brief maximum number of back to back steps to catch up with the schedule
+    SchedulerStats mSchedulerStats; /// \brief scheduler statistics
+    std::mutex mSchedulerLock; /// \brief guards scheduler statistics and the scheduler wait
+    std::condition_variable mSchedulerCondition; /// \brief wakes up the simulation thread
+    std::atomic<bool> mRescheduled; /// \brief schedule needs to be restarted
 };
 
 };
@@ -0,0 +1,298 @@
+/** \file dab_flock_snapshot.cpp
+ */
+
+#include "dab_flock_snapshot.h"
+#include "dab_flock_simulation.h"
+#include "dab_flock_swarm.h"
+#include "dab_flock_agent.h"
+#include "dab_flock_parameter.h"
+#include <algorithm>
+
+using namespace dab;
+using namespace dab::flock;
+
+#pragma mark Snapshot
+
+Snapshot::Channel::Channel()
+: mValid(false)
+, mAgentCount(0)
+, mDim(0)
+{}
+
+Snapshot::Snapshot()
+: mStep(-1)
+{}
+
+long
+Snapshot::step() const
+{
+	return mStep;
+}
+
+unsigned int
+Snapshot::channelCount() const
+{
+	return mChannels.size();
+}
+
+const Snapshot::Channel&
+Snapshot::channel(unsigned int pIndex) const
+{
+	return mChannels[pIndex];
+}
+
+const Snapshot::Channel*
+Snapshot::channel(const std::string& pSwarmName, const std::string& pParameterName) const
+{
+	unsigned int channelCount = mChannels.size();
+
+	for(unsigned int cI=0; cI<channelCount; ++cI)
+	{
+		if( mChannels[cI].mSwarmName == pSwarmName && mChannels[cI].mParameterName == pParameterName ) return &mChannels[cI];
+	}
+
+	return nullptr;
+}
+
+#pragma mark SnapshotBuffer
+
+const unsigned int SnapshotBuffer::sFreshFlag = 4;
+const unsigned int SnapshotBuffer::sIndexMask = 3;
+
+SnapshotBuffer::Source::Source(const std::string& pSwarmName, const std::string& pParameterName)
+: mSwarmName(pSwarmName)
+, mParameterName(pParameterName)
+, mSwarm(nullptr)
+, mSwarmParameter(nullptr)
+, mParameterIndex(-1)
+{}
+
+SnapshotBuffer::SnapshotBuffer()
+: mBackIndex(0)
+, mFrontIndex(2)
+, mMiddleIndex(1)
+, mSelectionVersion(0)
+, mSourceSelectionVersion(0)
+, mSourceStructureVersion(0)
+{}
+
+void
+SnapshotBuffer::addParameter(const std::string& pSwarmName, const std::string& pParameterName)
+{
+	std::lock_guard<std::mutex> lock( mSelectionLock );
+
+	std::array<std::string, 2> selection = { { pSwarmName, pParameterName } };
+	if( std::find( mSelection.begin(), mSelection.end(), selection ) != mSelection.end() ) return;
+
+	mSelection.push_back( selection );
+	mSelectionVersion++;
+}
+
+void
+SnapshotBuffer::removeParameter(const std::string& pSwarmName, const std::string& pParameterName)
+{
+	std::lock_guard<std::mutex> lock( mSelectionLock );
+
+	std::array<std::string, 2> selection = { { pSwarmName, pParameterName } };
+	auto iter = std::find( mSelection.begin(), mSelection.end(), selection );
+	if( iter == mSelection.end() ) return;
+
+	mSelection.erase( iter );
+	mSelectionVersion++;
+}
+
+void
+SnapshotBuffer::removeParameters(const std::string& pSwarmName)
+{
+	std::lock_guard<std::mutex> lock( mSelectionLock );
+
+	unsigned int selectionCount = mSelection.size();
+	mSelection.erase( std::remove_if( mSelection.begin(), mSelection.end(), [&pSwarmName](const std::array<std::string, 2>& pSelection){ return pSelection[0] == pSwarmName; } ), mSelection.end() );
+
+	if( mSelection.size() != selectionCount ) mSelectionVersion++;
+}
+
+void
+SnapshotBuffer::clearParameters()
+{
+	std::lock_guard<std::mutex> lock( mSelectionLock );
+
+	if( mSelection.empty() == true ) return;
+
+	mSelection.clear();
+	mSelectionVersion++;
+}
+
+bool
+SnapshotBuffer::update()
+{
+	if( ( mMiddleIndex.load( std::memory_order_acquire ) & sFreshFlag ) == 0 ) return false;
+
+	mFrontIndex = mMiddleIndex.exchange( mFrontIndex, std::memory_order_acq_rel ) & sIndexMask;
+
+	return true;
+}
+
+const Snapshot&
+SnapshotBuffer::snapshot() const
+{
+	return mSnapshots[mFrontIndex];
+}
+
+SnapshotBuffer::~SnapshotBuffer()
+{}
+
+void
+SnapshotBuffer::publish(long pStep)
+{
+	updateSources();
+	fill( mSnapshots[mBackIndex], pStep );
+
+	mBackIndex = mMiddleIndex.exchange( mBackIndex | sFreshFlag, std::memory_order_acq_rel ) & sIndexMask;
+}
+
+void
+SnapshotBuffer::publish(const Snapshot& pSnapshot)
+{
+	Snapshot& snapshot = mSnapshots[mBackIndex];
+	snapshot.mStep = pSnapshot.mStep;
+
+	unsigned int channelCount = pSnapshot.mChannels.size();
+	snapshot.mChannels.resize( channelCount );
+
+	for(unsigned int cI=0; cI<channelCount; ++cI)
+	{
+		const Snapshot::Channel& sourceChannel = pSnapshot.mChannels[cI];
+		Snapshot::Channel& channel = snapshot.mChannels[cI];
+
+		if( channel.mSwarmName != sourceChannel.mSwarmName ) channel.mSwarmName = sourceChannel.mSwarmName;
+		if( channel.mParameterName != sourceChannel.mParameterName ) channel.mParameterName = sourceChannel.mParameterName;
+
+		channel.mValid = sourceChannel.mValid;
+		channel.mAgentCount = sourceChannel.mAgentCount;
+		channel.mDim = sourceChannel.mDim;
+		channel.mValues.assign( sourceChannel.mValues.begin(), sourceChannel.mValues.end() );
+	}
+
+	mBackIndex = mMiddleIndex.exchange( mBackIndex | sFreshFlag, std::memory_order_acq_rel ) & sIndexMask;
+}
+
+void
+SnapshotBuffer::fill(Snapshot& pSnapshot, long pStep)
+{
+	pSnapshot.mStep = pStep;
+
+	unsigned int sourceCount = mSources.size();
+	pSnapshot.mChannels.resize( sourceCount );
+
+	for(unsigned int sI=0; sI<sourceCount; ++sI)
+	{
+		const Source& source = mSources[sI];
+		Snapshot::Channel& channel = pSnapshot.mChannels[sI];
+
+		if( channel.mSwarmName != source.mSwarmName ) channel.mSwarmName = source.mSwarmName;
+		if( channel.mParameterName != source.mParameterName ) channel.mParameterName = source.mParameterName;
+
+		channel.mValid = source.mSwarm != nullptr;
+		channel.mAgentCount = 0;
+		channel.mDim = 0;
+
+		if( source.mSwarmParameter != nullptr )
+		{
+			const Eigen::VectorXf& values = source.mSwarmParameter->values();
+
+			channel.mAgentCount = 1;
+			channel.mDim = values.rows();
+			channel.mValues.resize( channel.mDim );
+			std::copy( values.data(), values.data() + channel.mDim, channel.mValues.data() );
+		}
+		else if( source.mParameterIndex >= 0 )
+		{
+			std::vector<Agent*>& agents = source.mSwarm->agents();
+			unsigned int agentCount = agents.size();
+
+			if( agentCount > 0 )
+			{
+				unsigned int dim = agents[0]->parameter( source.mParameterIndex )->values().rows();
+
+				channel.mAgentCount = agentCount;
+				channel.mDim = dim;
+				channel.mValues.resize( agentCount * dim );
+
+				float* channelValues = channel.mValues.data();
+
+				for(unsigned int aI=0; aI<agentCount; ++aI, channelValues += dim)
+				{
+					const Eigen::VectorXf& values = agents[aI]->parameter( source.mParameterIndex )->values();
+					std::copy( values.data(), values.data() + dim, channelValues );
+				}
+			}
+		}
+
+		if( channel.mAgentCount == 0 ) channel.mValues.clear();
+	}
+}
+
+void
+SnapshotBuffer::updateSources()
+{
+	bool selectionChanged = false;
+
+	{
+		// the simulation never waits for a reader that changes the selection
+		std::unique_lock<std::mutex> lock( mSelectionLock, std::try_to_lock );
+
+		if( lock.owns_lock() == true && mSelectionVersion != mSourceSelectionVersion )
+		{
+			mSources.clear();
+
+			unsigned int selectionCount = mSelection.size();
+			for(unsigned int sI=0; sI<selectionCount; ++sI) mSources.push_back( Source( mSelection[sI][0], mSelection[sI][1] ) );
+
+			mSourceSelectionVersion = mSelectionVersion;
+			selectionChanged = true;
+		}
+	}
+
+	Simulation& simulation = Simulation::get();
+	unsigned long structureVersion = simulation.structureVersion();
+
+	if( selectionChanged == false && structureVersion == mSourceStructureVersion ) return;
+
+	mSourceStructureVersion = structureVersion;
+
+	unsigned int sourceCount = mSources.size();
+
+	for(unsigned int sI=0; sI<sourceCount; ++sI)
+	{
+		Source& source = mSources[sI];
+
+		source.mSwarm = nullptr;
+		source.mSwarmParameter = nullptr;
+		source.mParameterIndex = -1;
+
+		if( simulation.checkSwarm( source.mSwarmName ) == false ) continue;
+
+		try
+		{
+			Swarm* swarm = simulation.swarm( source.mSwarmName );
+
+			if( swarm->checkSwarmParameter( source.mParameterName ) == true )
+			{
+				source.mSwarmParameter = swarm->swarmParameter( source.mParameterName );
+				source.mSwarm = swarm;
+			}
+			else if( swarm->checkParameter( source.mParameterName ) == true )
+			{
+				source.mParameterIndex = swarm->parameterIndex( source.mParameterName );
+				source.mSwarm = swarm;
+			}
+		}
+		catch(Exception& e)
+		{
+			source.mSwarm = nullptr;
+			source.mSwarmParameter = nullptr;
+			source.mParameterIndex = -1;
+		}
+	}
+}
@@ -0,0 +1,205 @@
+/** \file dab_flock_snapshot.h
+ *  \class dab::flock::Snapshot copy of selected swarm parameters at the end of a simulation step
+ *  \class dab::flock::SnapshotBuffer lock-free triple buffer of snapshots
+ *  \brief lock-free triple buffer of snapshots
+ *
+ *  The simulation publishes a snapshot into each registered snapshot buffer after every simulation step.\n
+ *  A reader (e.g. FlockVisuals) calls update() to acquire the newest complete snapshot and then reads it without touching the agents of the simulation.\n
+ *  Neither the simulation nor the reader ever wait for each other. Each buffer serves a single reader thread, readers on different threads create their own buffers.\n
+ *  Instead of the simulation, a TrajectoryPlayer can publish recorded snapshots into a buffer. A buffer has a single writer, it must not be registered with the simulation while a player publishes into it.\n
+ */
+
+#ifndef _dab_flock_snapshot_h_
+#define _dab_flock_snapshot_h_
+
+#include <array>
+#include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+
+namespace dab
+{
+
+namespace flock
+{
+
+class Swarm;
+class Parameter;
+
+class Snapshot
+{
+public:
+    /**
+     \brief values of one swarm parameter
+     */
+    class Channel
+    {
+    public:
+        Channel();
+
+        std::string mSwarmName; /// \brief swarm name
+        std::string mParameterName; /// \brief parameter name
+        bool mValid; /// \brief swarm and parameter exist
+        unsigned int mAgentCount; /// \brief number of agents (1 for swarm parameters)
+        unsigned int mDim; /// \brief parameter dimension
+        std::vector<float> mValues; /// \brief parameter values (agent count * dimension)
+    };
+
+    /**
+     \brief default constructor
+     */
+    Snapshot();
+
+    /**
+     \brief return simulation step at which the snapshot has been taken
+     \return simulation step
+     */
+    long step() const;
+
+    /**
+     \brief return number of channels
+     \return number of channels
+     */
+    unsigned int channelCount() const;
+
+    /**
+     \brief return channel
+     \param pIndex channel index
+     \return channel
+     */
+    const Channel& channel(unsigned int pIndex) const;
+
+    /**
+     \brief return channel of swarm parameter
+     \param pSwarmName swarm name
+     \param pParameterName parameter name
+     \return channel or nullptr if the parameter has not been selected
+     */
+    const Channel* channel(const std::string& pSwarmName, const std::string& pParameterName) const;
+
+protected:
+    friend class SnapshotBuffer;
+    friend class TrajectoryRecorder;
+    friend class TrajectoryPlayer;
+
+    long mStep; /// \brief simulation step
+    std::vector<Channel> mChannels; /// \brief channels
+};
+
+class SnapshotBuffer
+{
+public:
+    /**
+     \brief default constructor
+     */
+    SnapshotBuffer();
+
+    /**
+     \brief destructor
+     */
+    virtual ~SnapshotBuffer();
+
+    /**
+     \brief select swarm parameter for publishing
+     \param pSwarmName swarm name
+     \param pParameterName parameter name (agent or swarm parameter)
+
+     the selection takes effect with the next published snapshot
+     */
+    void addParameter(const std::string& pSwarmName, const std::string& pParameterName);
+
+    /**
+     \brief deselect swarm parameter
+     \param pSwarmName swarm name
+     \param pParameterName parameter name
+     */
+    void removeParameter(const std::string& pSwarmName, const std::string& pParameterName);
+
+    /**
+     \brief deselect all parameters of swarm
+     \param pSwarmName swarm name
+     */
+    void removeParameters(const std::string& pSwarmName);
+
+    /**
+     \brief deselect all parameters
+     */
+    void clearParameters();
+
+    /**
+     \brief acquire newest complete snapshot (called by the reader)
+     \return true if a new snapshot has been acquired
+     */
+    bool update();
+
+    /**
+     \brief return snapshot acquired by the last call of update (called by the reader)
+     \return snapshot
+     */
+    const Snapshot& snapshot() const;
+
+    /**
+     \brief copy selected parameters into the back snapshot and make it the newest complete snapshot (called by the simulation)
+     \param pStep simulation step
+     */
+    virtual void publish(long pStep);
+
+    /**
+     \brief copy snapshot produced elsewhere into the back snapshot and make it the newest complete snapshot (called by a TrajectoryPlayer)
+     \param pSnapshot snapshot
+
+     all channels of the snapshot are copied regardless of the selection
+     */
+    void publish(const Snapshot& pSnapshot);
+
+protected:
+    static const unsigned int sFreshFlag; /// \brief flag marking a middle snapshot that the reader has not acquired yet
+    static const unsigned int sIndexMask; /// \brief mask of snapshot index
+
+    /**
+     \brief selected swarm parameter resolved by the simulation thread
+     */
+    class Source
+    {
+    public:
+        Source(const std::string& pSwarmName, const std::string& pParameterName);
+
+        std::string mSwarmName; /// \brief swarm name
+        std::string mParameterName; /// \brief parameter name
+        Swarm* mSwarm; /// \brief swarm (nullptr if not found)
+        Parameter* mSwarmParameter; /// \brief swarm parameter (nullptr for agent parameters)
+        int mParameterIndex; /// \brief agent parameter index (-1 if not found)
+    };
+
+    std::array<Snapshot, 3> mSnapshots; /// \brief back, middle and front snapshot
+    unsigned int mBackIndex; /// \brief index of snapshot written by the simulation
+    unsigned int mFrontIndex; /// \brief index of snapshot read by the reader
+    std::atomic<unsigned int> mMiddleIndex; /// \brief index of snapshot exchanged between simulation and reader, combined with fresh flag
+
+    std::mutex mSelectionLock; /// \brief guards the selection, the simulation only tries to lock it
+    std::vector< std::array<std::string, 2> > mSelection; /// \brief selected swarm and parameter names
+    unsigned long mSelectionVersion; /// \brief incremented when the selection changes
+
+    std::vector<Source> mSources; /// \brief resolved selection (simulation thread)
+    unsigned long mSourceSelectionVersion; /// \brief selection version of the resolved selection
+    unsigned long mSourceStructureVersion; /// \brief simulation structure version of the resolved selection
+
+    /**
+     \brief update resolved selection if selection or simulation structure have changed (called by the simulation)
+     */
+    void updateSources();
+
+    /**
+     \brief copy selected parameters into snapshot (called by the simulation)
+     \param pSnapshot snapshot
+     \param pStep simulation step
+     */
+    void fill(Snapshot& pSnapshot, long pStep);
+};
+
+};
+
+};
+
+#endif
@@ -17,6 +17,7 @@ Swarm::Swarm()
 : Agent()
 , mAgentParameterList(mParameterList)
 , mAgentBehaviorList(mBehaviorList)
+, mShareBehaviors(false)
 , mSelf(this)
 {
 	assert("illegal constructor");
@@ -27,6 +28,7 @@ Swarm::Swarm(const std::string& pName)
 , mAgentParameterList(mParameterList)
 , mAgentBehaviorList(mBehaviorList)
 , mAgentCreationCount(0)
+, mShareBehaviors(false)
 , mSelf(this)
 {
 	mIndex = sInstanceCount++;
@@ -45,6 +47,7 @@ Swarm::Swarm(const std::string& pName, const Swarm& pSwarm)
 , mAgentParameterList(mParameterList)
 , mAgentBehaviorList(mBehaviorList)
 , mAgentCreationCount(0)
+, mShareBehaviors(false)
 , mSelf(this)
 {
 	mIndex = sInstanceCount++;
@@ -70,6 +73,8 @@ Swarm::Swarm(const std::string& pName, const Swarm& pSwarm)
 	Simulation::get().addSwarm(this);
 	Simulation::get().addListener(mSelf);
     
+	setShareBehaviors( pSwarm.mShareBehaviors );
+    
 	// add same number of agents
 	addAgents( pSwarm.mAgents.size() );
 }
@@ -92,6 +97,7 @@ Swarm::~Swarm()
 //    mSelf = std::shared_ptr<Swarm>(nullptr);
 	
 	removeAgents();
+	clearSharedBehaviors();
     
 	Simulation::get().removeAgent(this);
 	Simulation::get().removeSwarm(this);
@@ -167,41 +173,10 @@ Swarm::addAgent() throw (Exception)
     
 	try
 	{
-		Agent* agent = new Agent( std::string( mName + "_" + std::to_string(mAgents.size()) ), *this );
-		
-		// debug
-		//std::cout << "swarm " << mName<< " add agent " << agent->index() << "\n";
-        
-        //		std::cout << "create agent " << agent->name() << "\n";
-		
-		//////////////////////////////////////////////
-		// assign parameters to neighborhood spaces //
-		//////////////////////////////////////////////
-		
-		NeighborAssignInfo* neighborAssignInfo;
+		std::vector< std::pair<unsigned int, NeighborAssignInfo*> > neighborAssigns;
+		resolveNeighborAssigns( neighborAssigns );
 		
-        for(auto iter = mAgentNeighborAssignRegistry.begin(); iter != mAgentNeighborAssignRegistry.end(); ++iter)
-        {
-            const std::string& parameterName = iter->first;
-			Parameter* agentParameter = agent->parameter(parameterName);
-
-            std::vector< NeighborAssignInfo* >& neighborAssigns = mAgentNeighborAssignRegistry[parameterName];
-			unsigned int neighborAssignCount = neighborAssigns.size();
-			
-			//std::cout << "parameterName " << parameterName << " neighborAssignCount " << neighborAssignCount << "\n";
-			
-			for(unsigned int neighborAssignIndex=0; neighborAssignIndex<neighborAssignCount; ++neighborAssignIndex)
-			{
-				neighborAssignInfo = neighborAssigns[neighborAssignIndex];
-				
-				//std::cout << "pName " << neighborAssignInfo->mParameterName << " sName " << neighborAssignInfo->mSpaceName << "\n";
-				
-				space::NeighborGroup* agentParameterNeighborGroup = agentParameter->neighborGroup(neighborAssignInfo->mSpaceName);
-				agentParameterNeighborGroup->setVisible( neighborAssignInfo->mVisible );
-				if(neighborAssignInfo->mNeighborGroupAlg != nullptr) agentParameterNeighborGroup->setNeighborGroupAlg( new space::NeighborGroupAlg( *( neighborAssignInfo->mNeighborGroupAlg ) ) );
-			}
-
-        }
+		Agent* agent = createAgent( mAgents.size(), *this, neighborAssigns );
         
 		/////////////////////////////
 		// add agent to simulation //
@@ -222,14 +197,101 @@ Swarm::addAgent() throw (Exception)
 void
 Swarm::addAgents(unsigned int pAgentCount) throw (Exception)
 {
+	if( pAgentCount == 0 ) return;
+	
+	std::vector<Agent*> newAgents;
+	newAgents.reserve( pAgentCount );
+	
 	try
 	{
-		for(unsigned int i=0; i<pAgentCount; ++i) addAgent();
+		// the neighbor assignments are resolved once for the whole batch
+		std::vector< std::pair<unsigned int, NeighborAssignInfo*> > neighborAssigns;
+		resolveNeighborAssigns( neighborAssigns );
+		
+		// the first agent is created from the swarm, all other agents are cloned from it and reuse the parameter layouts of its behaviors
+		unsigned int agentIndex = mAgents.size();
+		newAgents.push_back( createAgent( agentIndex, *this, neighborAssigns ) );
+		
+		const Agent& prototype = *( newAgents[0] );
+		for(unsigned int i=1; i<pAgentCount; ++i) newAgents.push_back( createAgent( agentIndex + i, prototype, neighborAssigns ) );
 	}
 	catch(Exception& e)
 	{
+		for(unsigned int i=0; i<newAgents.size(); ++i) delete newAgents[i];
+		
+        e += Exception("FLOCK ERROR: failed to add " + std::to_string(pAgentCount) + " agents to swarm", __FILE__, __FUNCTION__, __LINE__);
+		throw e;
+	}
+	
+	// the whole batch is registered at once
+	mAgents.insert( mAgents.end(), newAgents.begin(), newAgents.end() );
+	Simulation::get().addAgents( newAgents );
+}
+
+void
+Swarm::resolveNeighborAssigns(std::vector< std::pair<unsigned int, NeighborAssignInfo*> >& pNeighborAssigns) throw (Exception)
+{
+	pNeighborAssigns.clear();
+	
+	try
+	{
+		for(auto iter = mAgentNeighborAssignRegistry.begin(); iter != mAgentNeighborAssignRegistry.end(); ++iter)
+		{
+			// agents store their parameters in the same order as the swarm
+			unsigned int parameterIndex = mAgentParameterList.parameterIndex( iter->first );
+			
+			std::vector< NeighborAssignInfo* >& neighborAssigns = iter->second;
+			unsigned int neighborAssignCount = neighborAssigns.size();
+			
+			for(unsigned int neighborAssignIndex=0; neighborAssignIndex<neighborAssignCount; ++neighborAssignIndex) pNeighborAssigns.push_back( std::make_pair( parameterIndex, neighborAssigns[neighborAssignIndex] ) );
+		}
+	}
+	catch(Exception& e)
+	{
+        e += Exception("FLOCK ERROR: failed to resolve neighbor assignments of swarm " + mName, __FILE__, __FUNCTION__, __LINE__);
+		throw e;
+	}
+}
+
+Agent*
+Swarm::createAgent(unsigned int pAgentIndex, const Agent& pPrototype, const std::vector< std::pair<unsigned int, NeighborAssignInfo*> >& pNeighborAssigns) throw (Exception)
+{
+	Agent* agent = nullptr;
+	
+	try
+	{
+		agent = new Agent( std::string( mName + "_" + std::to_string(pAgentIndex) ), pPrototype, mSharedBehaviors );
+		agent->setSwarmIndex( pAgentIndex );
+		
+		// debug
+		//std::cout << "swarm " << mName<< " add agent " << agent->index() << "\n";
+		
+		//////////////////////////////////////////////
+		// assign parameters to neighborhood spaces //
+		//////////////////////////////////////////////
+		
+		unsigned int neighborAssignCount = pNeighborAssigns.size();
+		
+		for(unsigned int neighborAssignIndex=0; neighborAssignIndex<neighborAssignCount; ++neighborAssignIndex)
+		{
+			Parameter* agentParameter = agent->parameter( pNeighborAssigns[neighborAssignIndex].first );
+			NeighborAssignInfo* neighborAssignInfo = pNeighborAssigns[neighborAssignIndex].second;
+			
+			//std::cout << "pName " << neighborAssignInfo->mParameterName << " sName " << neighborAssignInfo->mSpaceName << "\n";
+			
+			space::NeighborGroup* agentParameterNeighborGroup = agentParameter->neighborGroup(neighborAssignInfo->mSpaceName);
+			agentParameterNeighborGroup->setVisible( neighborAssignInfo->mVisible );
+			if(neighborAssignInfo->mNeighborGroupAlg != nullptr) agentParameterNeighborGroup->setNeighborGroupAlg( new space::NeighborGroupAlg( *( neighborAssignInfo->mNeighborGroupAlg ) ) );
+		}
+	}
+	catch(Exception& e)
+	{
+		if(agent != nullptr) delete agent;
+		
 		throw;
 	}
+	
+	return agent;
 }
 
 void
@@ -248,13 +310,14 @@ Swarm::removeAgent() throw (Exception)
 void
 Swarm::removeAgent(unsigned int pAgentIndex) throw (Exception)
 {
-	if( pAgentIndex > mAgents.size() ) throw Exception( "FLOCK ERROR: Agent Nr " + std::to_string(pAgentIndex) + " Does Not Exist", __FILE__, __FUNCTION__, __LINE__ );
+	if( pAgentIndex >= mAgents.size() ) throw Exception( "FLOCK ERROR: Agent Nr " + std::to_string(pAgentIndex) + " Does Not Exist", __FILE__, __FUNCTION__, __LINE__ );
 	
     Agent* agent = mAgents[pAgentIndex];
     
 	try
 	{
         mAgents.erase(mAgents.begin() + pAgentIndex);
+		updateSwarmIndices( pAgentIndex );
 		
 		Simulation& simulation = Simulation::get();
 		simulation.removeAgent(agent);
@@ -276,7 +339,7 @@ Swarm::removeAgents(unsigned int pAgentCount) throw (Exception)
 		if( mAgents.size() == 0 ) return;
 		if(pAgentCount > mAgents.size() ) pAgentCount = mAgents.size();
         
-		for(unsigned int i=0; i<pAgentCount; ++i) removeAgent();
+		removeAgents( mAgents.size() - pAgentCount, pAgentCount );
 	}
 	catch(Exception& e)
 	{
@@ -289,34 +352,58 @@ Swarm::removeAgents(unsigned int pAgentIndex, unsigned int pAgentCount) throw (E
 {
 	//std::cout << "swarm " << mName.toStdString() << " removeAgents index " << pAgentIndex << " agentCount " << pAgentCount << "\n";
 	
-	try
+	if( mAgents.size() == 0 ) return;
+	if( pAgentIndex >= mAgents.size() ) throw Exception( "FLOCK ERROR: Agent Nr " + std::to_string(pAgentIndex) + " Does Not Exist", __FILE__, __FUNCTION__, __LINE__ );
+	if( pAgentCount > mAgents.size() - pAgentIndex ) pAgentCount = mAgents.size() - pAgentIndex;
+	
+	// the range is removed with a single erase instead of one erase per agent
+	std::vector<Agent*> removedAgents( mAgents.begin() + pAgentIndex, mAgents.begin() + pAgentIndex + pAgentCount );
+	mAgents.erase( mAgents.begin() + pAgentIndex, mAgents.begin() + pAgentIndex + pAgentCount );
+	updateSwarmIndices( pAgentIndex );
+	
+	deleteAgents( removedAgents );
+}
+
+void
+Swarm::removeAgents(const std::vector<unsigned int>& pAgentIndices) throw (Exception)
+{
+	unsigned int agentCount = mAgents.size();
+	
+	std::vector<bool> removeFlags( agentCount, false );
+	unsigned int indexCount = pAgentIndices.size();
+	
+	for(unsigned int i=0; i<indexCount; ++i)
 	{
-		if( mAgents.size() == 0 ) return;
-		if( pAgentCount > mAgents.size() - pAgentIndex ) pAgentCount = mAgents.size() - pAgentIndex;
-		
-		//std::cout << "remove agent count " << pAgentCount << " agent size " << mAgents.size() << "\n";
-		
-		for(unsigned int i=0; i<pAgentCount; ++i )
-		{
-			//std::cout << "i " << i << " agentIndex " << pAgentIndex << "\n";
-			
-			removeAgent( pAgentIndex );
-		}
+		if( pAgentIndices[i] >= agentCount ) throw Exception( "FLOCK ERROR: Agent Nr " + std::to_string(pAgentIndices[i]) + " Does Not Exist", __FILE__, __FUNCTION__, __LINE__ );
+		removeFlags[ pAgentIndices[i] ] = true;
 	}
-	catch(Exception& e)
+	
+	// compact remaining agents in place, they keep their relative order
+	std::vector<Agent*> removedAgents;
+	removedAgents.reserve( indexCount );
+	
+	unsigned int keepCount = 0;
+	for(unsigned int aI=0; aI<agentCount; ++aI)
 	{
-		throw;
+		if( removeFlags[aI] == true ) removedAgents.push_back( mAgents[aI] );
+		else
+		{
+			mAgents[keepCount] = mAgents[aI];
+			mAgents[keepCount]->setSwarmIndex( keepCount );
+			keepCount++;
+		}
 	}
+	mAgents.resize( keepCount );
+	
+	deleteAgents( removedAgents );
 }
 
 void
 Swarm::removeAgents() throw (Exception)
 {
-	int agentCount = mAgents.size();
-    
 	try
 	{
-		for(unsigned int i=0; i<agentCount; ++i) removeAgent();
+		removeAgents( 0, mAgents.size() );
 	}
 	catch(Exception& e)
 	{
@@ -324,6 +411,23 @@ Swarm::removeAgents() throw (Exception)
 	}
 }
 
+void
+Swarm::updateSwarmIndices(unsigned int pAgentIndex)
+{
+	unsigned int agentCount = mAgents.size();
+	for(unsigned int aI=pAgentIndex; aI<agentCount; ++aI) mAgents[aI]->setSwarmIndex( aI );
+}
+
+void
+Swarm::deleteAgents(const std::vector<Agent*>& pAgents)
+{
+	// the simulation compacts its agents once for the whole batch
+	Simulation::get().removeAgents( pAgents );
+	
+	unsigned int agentCount = pAgents.size();
+	for(unsigned int aI=0; aI<agentCount; ++aI) delete pAgents[aI];
+}
+
 unsigned int
 Swarm::swarmParameterCount() const
 {
@@ -540,6 +644,7 @@ Swarm::addSwarmParameter(Parameter* pParameter) throw (Exception)
 	try
 	{
 		mSwarmParameterList.addParameter(pParameter);
+		Simulation::get().invalidateStructure();
 	}
 	catch(Exception& e)
 	{
@@ -752,6 +857,7 @@ Swarm::removeSwarmParameter( const std::string pName ) throw (Exception)
 	try
 	{
 		mSwarmParameterList.removeParameter(pName);
+		Simulation::get().invalidateStructure();
 	}
 	catch(Exception& e)
 	{
@@ -910,7 +1016,7 @@ Swarm::set(unsigned int pAgentIndex, const std::string& pParameterName, const Ei
 void
 Swarm::randomize(const std::string& pParameterName, float pMinParameterValue, float pMaxParameterValue) throw (Exception)
 {
-	math::Math<>& math = math::Math<>::get();
+	RandomStream random = Simulation::get().randomStream( RandomStream::streamId( pParameterName ) );
     
 	try
 	{
@@ -919,23 +1025,23 @@ Swarm::randomize(const std::string& pParameterName, float pMinParameterValue, fl
 		// swarm parameter
 		if(mSwarmParameterList.contains(pParameterName))
 		{
-			mSwarmParameterList.setValue(pParameterName, math.random( pMinParameterValue, pMaxParameterValue ));
+			mSwarmParameterList.setValue(pParameterName, random.uniform( pMinParameterValue, pMaxParameterValue ));
 			parameterFound = true;
 		}
         
 		// agent parameters
 		if(mAgentParameterList.contains(pParameterName))
 		{
-			//Agent::set( pParameterName, math.random( pMinParameterValue, pMaxParameterValue ) );
+			//Agent::set( pParameterName, random.uniform( pMinParameterValue, pMaxParameterValue ) );
 			
 			unsigned int parIndex = parameterIndex(pParameterName);
-			Agent::parameter(parIndex)->setValue( math.random( pMinParameterValue, pMaxParameterValue ) );
+			Agent::parameter(parIndex)->setValue( random.uniform( pMinParameterValue, pMaxParameterValue ) );
             
 			unsigned int agentCount = mAgents.size();
             
 			for(unsigned int i=0; i<agentCount; ++i)
 			{
-				mAgents[i]->parameter(parIndex)->setValue(  math.random( pMinParameterValue, pMaxParameterValue ) );
+				mAgents[i]->parameter(parIndex)->setValue(  random.uniform( pMinParameterValue, pMaxParameterValue ) );
 			}
 			
 			parameterFound = true;
@@ -954,11 +1060,11 @@ Swarm::randomize(unsigned int pAgentIndex, const std::string& pParameterName, fl
 {
 	if( pAgentIndex >= mAgents.size() ) throw Exception( "FLOCK ERROR: agent index " + std::to_string(pAgentIndex) + " does not exist", __FILE__, __FUNCTION__, __LINE__ );
     
-    math::Math<>& math = math::Math<>::get();
+    RandomStream random = Simulation::get().randomStream( RandomStream::streamId( pParameterName ) );
     
 	try
 	{
-		mAgents[pAgentIndex]->parameter( pParameterName )->setValue( math.random( pMinParameterValue, pMaxParameterValue ) );
+		mAgents[pAgentIndex]->parameter( pParameterName )->setValue( random.uniform( pMinParameterValue, pMaxParameterValue ) );
 	}
 	catch(Exception& e)
 	{
@@ -1006,7 +1112,7 @@ Swarm::randomize(const std::string& pParameterName, const Eigen::VectorXf& pMinP
 {
 	if(pMinParameterValues.rows() != pMaxParameterValues.rows() ) throw Exception( "FLOCK ERROR: minimum parameter dim " + std::to_string(pMinParameterValues.rows()) + " doesn't match maximum parameter dim " + std::to_string(pMinParameterValues.rows()), __FILE__, __FUNCTION__, __LINE__ );
     
-	math::Math<>& math = math::Math<>::get();
+	RandomStream random = Simulation::get().randomStream( RandomStream::streamId( pParameterName ) );
 	unsigned int parameterDim = pMinParameterValues.rows();
 	Eigen::VectorXf randValue( parameterDim );
     
@@ -1017,7 +1123,7 @@ Swarm::randomize(const std::string& pParameterName, const Eigen::VectorXf& pMinP
 		// swarm parameter
 		if(mSwarmParameterList.contains(pParameterName))
 		{
-			for( unsigned int i=0; i<parameterDim; ++i ) randValue[i] = math.random( pMinParameterValues[i], pMaxParameterValues[i] );
+			for( unsigned int i=0; i<parameterDim; ++i ) randValue[i] = random.uniform( pMinParameterValues[i], pMaxParameterValues[i] );
 			mSwarmParameterList.setValues(pParameterName, randValue );
 			parameterFound = true;
 		}
@@ -1027,7 +1133,7 @@ Swarm::randomize(const std::string& pParameterName, const Eigen::VectorXf& pMinP
 		{
 			unsigned int parIndex = parameterIndex(pParameterName);
 			
-			for( unsigned int i=0; i<parameterDim; ++i ) randValue[i] = math.random( pMinParameterValues[i], pMaxParameterValues[i] );
+			for( unsigned int i=0; i<parameterDim; ++i ) randValue[i] = random.uniform( pMinParameterValues[i], pMaxParameterValues[i] );
 			Agent::parameter(parIndex)->setValues( randValue);
             
 			//Agent::set( pParameterName, randValue );
@@ -1036,7 +1142,7 @@ Swarm::randomize(const std::string& pParameterName, const Eigen::VectorXf& pMinP
             
 			for(unsigned int i=0; i<agentCount; ++i)
 			{
-				for( unsigned int j=0; j<parameterDim; ++j ) randValue[j] = math.random( pMinParameterValues[j], pMaxParameterValues[j] );
+				for( unsigned int j=0; j<parameterDim; ++j ) randValue[j] = random.uniform( pMinParameterValues[j], pMaxParameterValues[j] );
 				mAgents[i]->parameter( pParameterName )->setValues( randValue );
 			}
 			
@@ -1094,10 +1200,10 @@ Swarm::randomize(unsigned int pAgentIndex, const std::string& pParameterName, co
 	if( pAgentIndex >= mAgents.size() ) throw Exception( "FLOCK ERROR: agent index " + std::to_string(pAgentIndex) + " does not exist", __FILE__, __FUNCTION__, __LINE__ );
 	if(pMinParameterValues.rows() != pMaxParameterValues.rows() ) throw Exception( "FLOCK ERROR: minimum parameter dim " + std::to_string(pMinParameterValues.rows()) + " doesn't match maximum parameter dim " + std::to_string(pMaxParameterValues.rows()), __FILE__, __FUNCTION__, __LINE__ );
     
-	math::Math<>& math = math::Math<>::get();
+	RandomStream random = Simulation::get().randomStream( RandomStream::streamId( pParameterName ) );
 	unsigned int parameterDim = pMinParameterValues.rows();
 	Eigen::VectorXf randValue( parameterDim );
-	for( unsigned int i=0; i<parameterDim; ++i ) randValue[i] = math.random( pMinParameterValues[i], pMaxParameterValues[i] );
+	for( unsigned int i=0; i<parameterDim; ++i ) randValue[i] = random.uniform( pMinParameterValues[i], pMaxParameterValues[i] );
     
 	try
 	{
@@ -1699,11 +1805,16 @@ Swarm::addAgentBehavior(const std::string& pBehaviorName, const Behavior& pBehav
 	{
 		Agent::addBehavior( pBehaviorName, pBehavior );
 		
+		if( shareAgentBehavior( pBehaviorName ) == true ) return;
+		
+		// the agents clone the swarm's behavior and reuse its resolved parameter layout
+		const Behavior& prototype = *( mAgentBehaviorList.behavior( pBehaviorName ) );
+		
 		unsigned int agentCount = mAgents.size();
 		
 		for(unsigned int i=0; i<agentCount; ++i)
 		{
-			mAgents[i]->addBehavior( pBehaviorName, pBehavior );
+			mAgents[i]->addBehavior( pBehaviorName, prototype );
 		}
 	}
 	catch(Exception& e)
@@ -1719,11 +1830,16 @@ Swarm::addAgentBehavior(const std::string& pBehaviorName, unsigned int pBehavior
 	{
 		Agent::addBehavior( pBehaviorName, pBehaviorPosition, pBehavior );
 		
+		if( shareAgentBehavior( pBehaviorName ) == true ) return;
+		
+		// the agents clone the swarm's behavior and reuse its resolved parameter layout
+		const Behavior& prototype = *( mAgentBehaviorList.behavior( pBehaviorName ) );
+		
 		unsigned int agentCount = mAgents.size();
 		
 		for(unsigned int i=0; i<agentCount; ++i)
 		{
-			mAgents[i]->addBehavior( pBehaviorName, pBehaviorPosition, pBehavior );
+			mAgents[i]->addBehavior( pBehaviorName, pBehaviorPosition, prototype );
 		}
 	}
 	catch(Exception& e)
@@ -1743,13 +1859,18 @@ Swarm::addAgentBehavior(const std::string& pBehaviorName, const std::string& pSu
 		
 		Agent::addBehavior( pBehaviorName, pSuccessorBehaviorName, pBehavior );
 		
+		if( shareAgentBehavior( pBehaviorName ) == true ) return;
+		
+		// the agents clone the swarm's behavior and reuse its resolved parameter layout
+		const Behavior& prototype = *( mAgentBehaviorList.behavior( pBehaviorName ) );
+		
 		unsigned int agentCount = mAgents.size();
 		
 		for(unsigned int i=0; i<agentCount; ++i)
 		{
 			//std::cout << "agent " << i << "\n";
 			
-			mAgents[i]->addBehavior( pBehaviorName, pSuccessorBehaviorName, pBehavior );
+			mAgents[i]->addBehavior( pBehaviorName, pSuccessorBehaviorName, prototype );
 		}
 	}
 	catch(Exception& e)
@@ -1916,6 +2037,14 @@ Swarm::removeAgentBehavior(const std::string& pBehaviorName) throw (Exception)
 		// remove behaviors
 		unsigned int agentCount = mAgents.size();
 		for(unsigned int agentNr=0; agentNr < agentCount; ++agentNr) mAgents[agentNr]->removeBehavior( pBehaviorName );
+		
+		auto sharedIter = mSharedBehaviors.find( pBehaviorName );
+		if( sharedIter != mSharedBehaviors.end() )
+		{
+			delete sharedIter->second;
+			mSharedBehaviors.erase( sharedIter );
+		}
+		
 		Agent::removeBehavior( pBehaviorName );
 	}
 	catch(Exception& e)
@@ -1959,7 +2088,101 @@ Swarm::act()
 	}
     
 	// perform swarm behaviors
-	mSwarmBehaviorList.act();
+	mSwarmBehaviorList.act( this );
+}
+
+bool
+Swarm::shareBehaviors() const
+{
+	return mShareBehaviors;
+}
+
+void
+Swarm::setShareBehaviors(bool pShareBehaviors) throw (Exception)
+{
+	if( pShareBehaviors == mShareBehaviors ) return;
+	if( mAgents.size() > 0 ) throw Exception( "FLOCK ERROR: behavior sharing of swarm " + mName + " can only be changed while the swarm has no agents", __FILE__, __FUNCTION__, __LINE__ );
+	
+	mShareBehaviors = pShareBehaviors;
+	
+	if( mShareBehaviors == false )
+	{
+		clearSharedBehaviors();
+		return;
+	}
+	
+	try
+	{
+		unsigned int behaviorCount = mAgentBehaviorList.behaviorCount();
+		for(unsigned int bI=0; bI<behaviorCount; ++bI) shareAgentBehavior( mAgentBehaviorList.behavior(bI)->name() );
+	}
+	catch(Exception& e)
+	{
+		clearSharedBehaviors();
+		mShareBehaviors = false;
+		
+		e += Exception( "FLOCK ERROR: failed to enable behavior sharing of swarm " + mName, __FILE__, __FUNCTION__, __LINE__ );
+		throw e;
+	}
+}
+
+void
+Swarm::updateSharedBehaviors(unsigned int pThreadCount)
+{
+	// the simulation thread itself acts with worker 0
+	for(auto sharedIter = mSharedBehaviors.begin(); sharedIter != mSharedBehaviors.end(); ++sharedIter)
+	{
+		try
+		{
+			sharedIter->second->updateWorkers( pThreadCount + 1 );
+		}
+		catch(Exception& e)
+		{
+			Simulation::get().exceptionReport( e );
+		}
+	}
+}
+
+bool
+Swarm::shareAgentBehavior(const std::string& pBehaviorName) throw (Exception)
+{
+	Behavior* prototype = mAgentBehaviorList.behavior( pBehaviorName );
+	
+	if( mShareBehaviors == false || prototype->shareable() == false ) return false;
+	
+	try
+	{
+		Behavior* sharedBehavior = prototype->createShared( this );
+		mSharedBehaviors[pBehaviorName] = sharedBehavior;
+		
+		unsigned int behaviorPosition = mAgentBehaviorList.behaviorIndex( pBehaviorName );
+		unsigned int parameterCount = mAgentParameterList.parameterCount();
+		unsigned int agentCount = mAgents.size();
+		
+		for(unsigned int aI=0; aI<agentCount; ++aI)
+		{
+			Agent* agent = mAgents[aI];
+			
+			// the prototype has added its missing parameters to the swarm, agents receive copies of them at the same indices
+			for(unsigned int pI=agent->parameterCount(); pI<parameterCount; ++pI) agent->addParameter( new Parameter( agent, *( mAgentParameterList.parameter(pI) ) ) );
+			
+			agent->addBehavior( sharedBehavior, behaviorPosition );
+		}
+	}
+	catch(Exception& e)
+	{
+		e += Exception( "FLOCK ERROR: failed to share agent behavior " + pBehaviorName, __FILE__, __FUNCTION__, __LINE__ );
+		throw e;
+	}
+	
+	return true;
+}
+
+void
+Swarm::clearSharedBehaviors()
+{
+	for(auto sharedIter = mSharedBehaviors.begin(); sharedIter != mSharedBehaviors.end(); ++sharedIter) delete sharedIter->second;
+	mSharedBehaviors.clear();
 }
 
 void 
@@ -1967,8 +2190,7 @@ Swarm::flush()
 {
 	mSwarmParameterList.flush();
 	
-	unsigned int aC = mAgents.size();
-	for(unsigned int aI=0; aI<aC; ++aI) mAgents[aI]->flush();
+	// the agents of the swarm are flushed by the simulation
 }
 
 void 
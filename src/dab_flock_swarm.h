@@ -137,6 +137,15 @@ public:
      */
     void removeAgents(unsigned int pAgentIndex, unsigned int pAgentCount) throw (Exception);
     
+    /**
+     \brief remove agents with particular indices
+     \param pAgentIndices agent indices (in any order)
+     \exception Exception agent index does not exist
+     
+     the remaining agents are compacted in a single pass and keep their order, their indices shift down by the number of removed agents in front of them
+     */
+    void removeAgents(const std::vector<unsigned int>& pAgentIndices) throw (Exception);
+    
     /**
      \brief remove all agents from swarm
      \exception Exception failed to remove agents
@@ -840,6 +849,29 @@ public:
      */
     void removeSwarmBehavior(const std::string& pBehaviorName) throw (Exception);
     
+    /**
+     \brief check whether agents share a single instance of each shareable agent behavior
+     \return true if behavior sharing is enabled
+     */
+    bool shareBehaviors() const;
+    
+    /**
+     \brief enable or disable sharing of agent behaviors
+     \param pShareBehaviors behavior sharing flag
+     \exception Exception swarm has agents
+     
+     when enabled, all agents refer to a single instance of each shareable agent behavior instead of owning a copy of it.\n
+     the simulation acts with per thread workers of the shared instance that are rebound to each agent.\n
+     behaviors that are not shareable are still copied for each agent.\n
+     */
+    void setShareBehaviors(bool pShareBehaviors) throw (Exception);
+    
+    /**
+     \brief create workers of shared behaviors and update their parameter indices (called by the simulation)
+     \param pThreadCount number of simulation threads
+     */
+    void updateSharedBehaviors(unsigned int pThreadCount);
+    
     /**
      \brief perform behaviors
      */
@@ -884,6 +916,48 @@ protected:
      */
     Swarm();
     
+    /**
+     \brief resolve the agent neighbor assignment registry into a flat list
+     \param pNeighborAssigns agent parameter index and neighbor assignment for each registry entry
+     \exception Exception registered parameter not found
+     */
+    void resolveNeighborAssigns(std::vector< std::pair<unsigned int, NeighborAssignInfo*> >& pNeighborAssigns) throw (Exception);
+    
+    /**
+     \brief create agent from a prototype and assign its parameters to neighborhood spaces
+     \param pAgentIndex index the agent will have in the swarm
+     \param pPrototype swarm or agent of the swarm whose parameters and behaviors are copied
+     \param pNeighborAssigns resolved neighbor assignments
+     \return agent (not yet added to the swarm or the simulation)
+     \exception Exception failed to create agent
+     */
+    Agent* createAgent(unsigned int pAgentIndex, const Agent& pPrototype, const std::vector< std::pair<unsigned int, NeighborAssignInfo*> >& pNeighborAssigns) throw (Exception);
+    
+    /**
+     \brief update the swarm index of agents after agents have been removed
+     \param pAgentIndex index of first agent whose position in the swarm may have changed
+     */
+    void updateSwarmIndices(unsigned int pAgentIndex);
+    
+    /**
+     \brief remove agents from simulation and delete them
+     \param pAgents agents that have already been removed from the swarm
+     */
+    void deleteAgents(const std::vector<Agent*>& pAgents);
+    
+    /**
+     \brief create shared instance of agent behavior and add it to all agents
+     \param pBehaviorName agent behavior name
+     \return true if the behavior is shared, false if it needs to be copied for each agent
+     \exception Exception failed to create shared behavior
+     */
+    bool shareAgentBehavior(const std::string& pBehaviorName) throw (Exception);
+    
+    /**
+     \brief delete all shared behaviors
+     */
+    void clearSharedBehaviors();
+    
     std::shared_ptr<Swarm> mSelf;
     
     ParameterList& mAgentParameterList; /// \brief list of agent parameters
@@ -892,6 +966,9 @@ protected:
     BehaviorList mSwarmBehaviorList;	/// \brief swarm exclusive list of behaviors
     std::vector<Agent*> mAgents; /// \brief swarm agents
     
+    bool mShareBehaviors; /// \brief agents share a single instance of each shareable agent behavior
+    std::map<std::string, Behavior*> mSharedBehaviors; /// \brief shared agent behaviors
+    
     unsigned int mAgentCreationCount; /// \brief numbers of agents ever created for this swarm
     
     std::map< std::string, std::vector<NeighborAssignInfo*> > mAgentNeighborAssignRegistry; /// \brief registry for all agent parameters that are assigned to some neighbor space
@@ -0,0 +1,105 @@
+/** \file dab_flock_symbol.cpp
+ */
+
+#include "dab_flock_symbol.h"
+
+using namespace dab;
+using namespace dab::flock;
+
+#pragma mark Symbol
+
+Symbol::Symbol()
+: mId(0)
+{}
+
+Symbol::Symbol(const std::string& pName)
+: mId( SymbolTable::get().id( pName ) )
+{}
+
+Symbol::Symbol(unsigned int pId) throw (Exception)
+: mId(pId)
+{
+	if( pId >= SymbolTable::get().symbolCount() ) throw Exception( "FLOCK ERROR: symbol id " + std::to_string(pId) + " does not exist", __FILE__, __FUNCTION__, __LINE__ );
+}
+
+unsigned int
+Symbol::id() const
+{
+	return mId;
+}
+
+const std::string&
+Symbol::name() const
+{
+	return SymbolTable::get().name( mId );
+}
+
+bool
+Symbol::empty() const
+{
+	return mId == 0;
+}
+
+bool
+Symbol::operator==(const Symbol& pSymbol) const
+{
+	return mId == pSymbol.mId;
+}
+
+bool
+Symbol::operator!=(const Symbol& pSymbol) const
+{
+	return mId != pSymbol.mId;
+}
+
+#pragma mark SymbolTable
+
+SymbolTable::SymbolTable()
+{
+	mIds[""] = 0;
+	mNames.push_back("");
+}
+
+unsigned int
+SymbolTable::id(const std::string& pName)
+{
+	std::lock_guard<std::mutex> lock( mLock );
+	
+	auto idIter = mIds.find( pName );
+	if( idIter != mIds.end() ) return idIter->second;
+	
+	unsigned int id = mNames.size();
+	mIds[pName] = id;
+	mNames.push_back( pName );
+	
+	return id;
+}
+
+int
+SymbolTable::find(const std::string& pName) const
+{
+	std::lock_guard<std::mutex> lock( mLock );
+	
+	auto idIter = mIds.find( pName );
+	if( idIter == mIds.end() ) return -1;
+	
+	return idIter->second;
+}
+
+const std::string&
+SymbolTable::name(unsigned int pId) const throw (Exception)
+{
+	std::lock_guard<std::mutex> lock( mLock );
+	
+	if( pId >= mNames.size() ) throw Exception( "FLOCK ERROR: symbol id " + std::to_string(pId) + " does not exist", __FILE__, __FUNCTION__, __LINE__ );
+	
+	return mNames[pId];
+}
+
+unsigned int
+SymbolTable::symbolCount() const
+{
+	std::lock_guard<std::mutex> lock( mLock );
+	
+	return mNames.size();
+}
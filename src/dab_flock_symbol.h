@@ -0,0 +1,121 @@
+/** \file dab_flock_symbol.h
+ *  \class dab::flock::Symbol interned name
+ *  \class dab::flock::SymbolTable table of interned names
+ *  \brief interned name
+ *
+ *  A symbol stands for a parameter, swarm, env or space name and is represented by a small integer id.\n
+ *  Two symbols are equal if and only if their names are equal. Lookups by symbol resolve in constant time instead of comparing strings.\n
+ *  Symbols are never removed from the table, ids remain valid for the lifetime of the application.\n
+ */
+
+#ifndef _dab_flock_symbol_h_
+#define _dab_flock_symbol_h_
+
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+#include "dab_singleton.h"
+#include "dab_exception.h"
+
+namespace dab
+{
+
+namespace flock
+{
+
+class Symbol
+{
+public:
+    /**
+     \brief create empty symbol
+     */
+    Symbol();
+    
+    /**
+     \brief create symbol
+     \param pName name (interned if not yet known)
+     */
+    explicit Symbol(const std::string& pName);
+    
+    /**
+     \brief create symbol from the id of an interned name
+     \param pId symbol id (e.g. returned by SymbolTable::find())
+     \exception Exception symbol id does not exist
+     */
+    explicit Symbol(unsigned int pId) throw (Exception);
+    
+    /**
+     \brief return symbol id
+     \return symbol id
+     */
+    unsigned int id() const;
+    
+    /**
+     \brief return name
+     \return name
+     */
+    const std::string& name() const;
+    
+    /**
+     \brief check whether symbol stands for the empty name
+     \return true if symbol is empty
+     */
+    bool empty() const;
+    
+    bool operator==(const Symbol& pSymbol) const;
+    bool operator!=(const Symbol& pSymbol) const;
+    
+protected:
+    unsigned int mId; /// \brief symbol id
+};
+
+class SymbolTable : public Singleton<SymbolTable>
+{
+    friend class Singleton<SymbolTable>;
+    
+public:
+    /**
+     \brief return id of name, the name is interned if not yet known
+     \param pName name
+     \return symbol id
+     */
+    unsigned int id(const std::string& pName);
+    
+    /**
+     \brief return id of name without interning it
+     \param pName name
+     \return symbol id or -1 if the name is not known
+     */
+    int find(const std::string& pName) const;
+    
+    /**
+     \brief return name of symbol
+     \param pId symbol id
+     \return name
+     \exception Exception symbol id does not exist
+     */
+    const std::string& name(unsigned int pId) const throw (Exception);
+    
+    /**
+     \brief return number of interned names
+     \return number of interned names
+     */
+    unsigned int symbolCount() const;
+    
+protected:
+    /**
+     \brief default constructor, interns the empty name as id 0
+     */
+    SymbolTable();
+    
+    std::unordered_map<std::string, unsigned int> mIds; /// \brief symbol id by name
+    std::deque<std::string> mNames; /// \brief names by symbol id (a deque keeps returned references valid while names are added)
+    mutable std::mutex mLock; /// \brief guards the table, names can be interned from any thread
+};
+
+};
+
+};
+
+#endif
@@ -0,0 +1,201 @@
+/** \file dab_flock_thread_pool.cpp
+ */
+
+#include "dab_flock_thread_pool.h"
+#include <algorithm>
+
+using namespace dab;
+using namespace dab::flock;
+
+unsigned int ThreadPool::sChunksPerThread = 4;
+thread_local unsigned int ThreadPool::sThreadIndex = 0;
+
+ThreadPool::ThreadPool( unsigned int pThreadCount )
+: mTask( nullptr )
+, mItemCount( 0 )
+, mChunkSize( 0 )
+, mMinChunkSize( 64 )
+, mNextChunk( 0 )
+, mBusyWorkerCount( 0 )
+, mJobIndex( 0 )
+, mTerminated( false )
+{
+	if( pThreadCount > 1 ) startWorkers( pThreadCount - 1 );
+}
+
+ThreadPool::~ThreadPool()
+{
+	stopWorkers();
+}
+
+unsigned int
+ThreadPool::threadCount() const
+{
+	return mWorkers.size() + 1;
+}
+
+void
+ThreadPool::setThreadCount( unsigned int pThreadCount )
+{
+	if( pThreadCount < 1 ) pThreadCount = 1;
+	if( pThreadCount == threadCount() ) return;
+
+	stopWorkers();
+	startWorkers( pThreadCount - 1 );
+}
+
+unsigned int
+ThreadPool::threadIndex()
+{
+	return sThreadIndex;
+}
+
+unsigned int
+ThreadPool::minChunkSize() const
+{
+	return mMinChunkSize;
+}
+
+void
+ThreadPool::setMinChunkSize( unsigned int pMinChunkSize )
+{
+	mMinChunkSize = std::max<unsigned int>( pMinChunkSize, 1 );
+}
+
+void
+ThreadPool::run( unsigned int pItemCount, const std::function<void(unsigned int, unsigned int)>& pTask ) throw (Exception)
+{
+	if( pItemCount == 0 ) return;
+
+	unsigned int workerCount = mWorkers.size();
+
+	// not worth distributing
+	if( workerCount == 0 || pItemCount <= mMinChunkSize )
+	{
+		pTask( 0, pItemCount );
+		return;
+	}
+
+	unsigned int chunkCount = ( workerCount + 1 ) * sChunksPerThread;
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+
+		mTask = &pTask;
+		mItemCount = pItemCount;
+		mChunkSize = std::max<unsigned int>( ( pItemCount + chunkCount - 1 ) / chunkCount, mMinChunkSize );
+		mNextChunk = 0;
+		mBusyWorkerCount = workerCount;
+		mException.reset();
+		mJobIndex++;
+	}
+
+	mJobCondition.notify_all();
+
+	processChunks();
+
+	// barrier
+	{
+		std::unique_lock<std::mutex> lock( mMutex );
+		mDoneCondition.wait( lock, [this]{ return mBusyWorkerCount == 0; } );
+		mTask = nullptr;
+	}
+
+	if( mException != nullptr )
+	{
+		Exception e = *mException;
+		mException.reset();
+
+		e += Exception( "FLOCK ERROR: worker task failed", __FILE__, __FUNCTION__, __LINE__ );
+		throw e;
+	}
+}
+
+void
+ThreadPool::startWorkers( unsigned int pWorkerCount )
+{
+	unsigned long jobIndex;
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mTerminated = false;
+		jobIndex = mJobIndex;
+	}
+
+	// workers receive the current job index, a worker that starts after the next run() has begun still sees that job as new
+	for(unsigned int wI=0; wI<pWorkerCount; ++wI)
+	{
+		mWorkers.push_back( std::thread( &ThreadPool::work, this, wI + 1, jobIndex ) );
+	}
+}
+
+void
+ThreadPool::stopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mTerminated = true;
+	}
+
+	mJobCondition.notify_all();
+
+	unsigned int workerCount = mWorkers.size();
+	for(unsigned int wI=0; wI<workerCount; ++wI) mWorkers[wI].join();
+
+	mWorkers.clear();
+}
+
+void
+ThreadPool::work( unsigned int pThreadIndex, unsigned long pJobIndex )
+{
+	sThreadIndex = pThreadIndex;
+
+	unsigned long jobIndex = pJobIndex;
+
+	while( true )
+	{
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			mJobCondition.wait( lock, [this, jobIndex]{ return mTerminated == true || mJobIndex != jobIndex; } );
+
+			if( mTerminated == true ) return;
+
+			jobIndex = mJobIndex;
+		}
+
+		processChunks();
+
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			mBusyWorkerCount--;
+			if( mBusyWorkerCount == 0 ) mDoneCondition.notify_one();
+		}
+	}
+}
+
+void
+ThreadPool::processChunks()
+{
+	while( true )
+	{
+		unsigned int startIndex = mNextChunk++ * mChunkSize;
+		if( startIndex >= mItemCount ) break;
+
+		unsigned int endIndex = std::min( startIndex + mChunkSize, mItemCount );
+
+		try
+		{
+			(*mTask)( startIndex, endIndex );
+		}
+		catch(Exception& e)
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			if( mException == nullptr ) mException = std::make_shared<Exception>( e );
+		}
+		catch(...)
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			if( mException == nullptr ) mException = std::make_shared<Exception>( "FLOCK ERROR: unknown exception in worker thread", __FILE__, __FUNCTION__, __LINE__ );
+		}
+	}
+}
@@ -0,0 +1,129 @@
+/** \file dab_flock_thread_pool.h
+ */
+
+#ifndef _dab_flock_thread_pool_h_
+#define _dab_flock_thread_pool_h_
+
+#include "dab_exception.h"
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace dab
+{
+
+namespace flock
+{
+
+/**
+ \brief pool of worker threads that process an index range in chunks
+
+ the calling thread participates in the processing and run() only returns once all chunks have been processed (barrier).
+ a thread count of 1 executes everything serially on the calling thread.
+ */
+class ThreadPool
+{
+public:
+    /**
+     \brief create thread pool
+     \param pThreadCount number of threads (including the calling thread)
+     */
+    ThreadPool( unsigned int pThreadCount = 1 );
+
+    /**
+     \brief destructor
+     */
+    ~ThreadPool();
+
+    /**
+     \brief return number of threads (including the calling thread)
+     \return number of threads
+     */
+    unsigned int threadCount() const;
+
+    /**
+     \brief set number of threads (including the calling thread)
+     \param pThreadCount number of threads
+
+     must not be called while run() is executing
+     */
+    void setThreadCount( unsigned int pThreadCount );
+
+    /**
+     \brief return index of the calling thread
+     \return 0 for the thread that calls run() (and any thread outside of a pool), 1 to thread count - 1 for worker threads
+     */
+    static unsigned int threadIndex();
+
+    /**
+     \brief return minimum number of items per chunk
+     \return minimum number of items per chunk
+     */
+    unsigned int minChunkSize() const;
+
+    /**
+     \brief set minimum number of items per chunk
+     \param pMinChunkSize minimum number of items per chunk
+     */
+    void setMinChunkSize( unsigned int pMinChunkSize );
+
+    /**
+     \brief process index range [0, pItemCount) in chunks and wait until all chunks are done
+     \param pItemCount number of items
+     \param pTask task that processes the items within [start index, end index)
+     \exception Exception a task has thrown an exception
+     */
+    void run( unsigned int pItemCount, const std::function<void(unsigned int, unsigned int)>& pTask ) throw (Exception);
+
+protected:
+    static unsigned int sChunksPerThread; /// \brief number of chunks per thread for load balancing
+    static thread_local unsigned int sThreadIndex; /// \brief index of the current thread within its pool
+
+    std::vector<std::thread> mWorkers; /// \brief worker threads
+    std::mutex mMutex; /// \brief mutex guarding job state
+    std::condition_variable mJobCondition; /// \brief signals workers that a new job is available
+    std::condition_variable mDoneCondition; /// \brief signals the calling thread that all workers are done
+
+    const std::function<void(unsigned int, unsigned int)>* mTask; /// \brief current task
+    unsigned int mItemCount; /// \brief number of items of current task
+    unsigned int mChunkSize; /// \brief number of items per chunk of current task
+    unsigned int mMinChunkSize; /// \brief minimum number of items per chunk
+    std::atomic<unsigned int> mNextChunk; /// \brief index of next chunk to be processed
+    unsigned int mBusyWorkerCount; /// \brief number of workers still processing the current task
+    unsigned long mJobIndex; /// \brief incremented for every new job
+    bool mTerminated; /// \brief worker termination flag
+    std::shared_ptr<Exception> mException; /// \brief first exception thrown by a task
+
+    /**
+     \brief start worker threads
+     \param pWorkerCount number of worker threads
+     */
+    void startWorkers( unsigned int pWorkerCount );
+
+    /**
+     \brief stop and join all worker threads
+     */
+    void stopWorkers();
+
+    /**
+     \brief worker thread loop
+     \param pThreadIndex thread index (starting with 1)
+     \param pJobIndex job index at the time the worker has been started
+     */
+    void work( unsigned int pThreadIndex, unsigned long pJobIndex );
+
+    /**
+     \brief process chunks until none are left
+     */
+    void processChunks();
+};
+
+};
+
+};
+
+#endif
@@ -0,0 +1,620 @@
+/** \file dab_flock_trajectory_player.cpp
+ */
+
+#include "dab_flock_trajectory_player.h"
+#include "dab_flock_trajectory_recorder.h"
+#include "dab_flock_simulation.h"
+#include "dab_flock_swarm.h"
+#include "dab_flock_agent.h"
+#include "dab_flock_parameter.h"
+#include "ofUtils.h"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace dab;
+using namespace dab::flock;
+
+template<typename ValueType>
+const char*
+TrajectoryPlayer::read(ValueType& pValue, const char* pBuffer, const char* pBufferEnd) throw (Exception)
+{
+	if( pBuffer + sizeof(ValueType) > pBufferEnd ) throw Exception( "FLOCK ERROR: unexpected end of trajectory file", __FILE__, __FUNCTION__, __LINE__ );
+
+	std::memcpy( &pValue, pBuffer, sizeof(ValueType) );
+
+	return pBuffer + sizeof(ValueType);
+}
+
+const char*
+TrajectoryPlayer::readVarint(uint32_t& pValue, const char* pBuffer, const char* pBufferEnd) throw (Exception)
+{
+	pValue = 0;
+
+	for(unsigned int shift=0; shift<35; shift+=7)
+	{
+		if( pBuffer >= pBufferEnd ) throw Exception( "FLOCK ERROR: unexpected end of trajectory file", __FILE__, __FUNCTION__, __LINE__ );
+
+		uint8_t byte = static_cast<uint8_t>( *pBuffer++ );
+		pValue |= static_cast<uint32_t>( byte & 0x7F ) << shift;
+
+		if( ( byte & 0x80 ) == 0 ) return pBuffer;
+	}
+
+	throw Exception( "FLOCK ERROR: corrupt trajectory file", __FILE__, __FUNCTION__, __LINE__ );
+}
+
+TrajectoryPlayer::TrajectoryPlayer()
+: mFileSize(0)
+, mChunkIndex(-1)
+, mFrameValueCount(0)
+, mFrameIndex(-1)
+, mFrameChanged(false)
+, mPosition(0.0)
+, mSpeed(1.0)
+, mPlaying(false)
+, mLoop(false)
+{}
+
+TrajectoryPlayer::~TrajectoryPlayer()
+{
+	close();
+}
+
+void
+TrajectoryPlayer::open(const std::string& pFileName) throw (Exception)
+{
+	close();
+
+	std::lock_guard<std::mutex> lock( mLock );
+
+	try
+	{
+		mFilePath = ofToDataPath( pFileName );
+		mFile.open( mFilePath, std::ios::binary | std::ios::ate );
+		if( mFile.is_open() == false ) throw Exception( "FILE ERROR: failed to open file " + mFilePath + " for reading", __FILE__, __FUNCTION__, __LINE__ );
+
+		std::streamsize fileSize = mFile.tellg();
+		if( fileSize < 0 ) throw Exception( "FILE ERROR: failed to read file " + mFilePath, __FILE__, __FUNCTION__, __LINE__ );
+		mFileSize = fileSize;
+
+		// header
+		std::vector<char> header;
+		readBytes( 0, TrajectoryRecorder::sHeaderSize, header );
+
+		const char* data = header.data();
+		const char* dataEnd = data + header.size();
+
+		if( std::memcmp( data, TrajectoryRecorder::sMagic, 8 ) != 0 ) throw Exception( "FLOCK ERROR: file " + mFilePath + " is not a trajectory file", __FILE__, __FUNCTION__, __LINE__ );
+		data += 8;
+
+		uint32_t version;
+		uint32_t byteOrderMark;
+		data = read<uint32_t>( version, data, dataEnd );
+		data = read<uint32_t>( byteOrderMark, data, dataEnd );
+
+		if( version != TrajectoryRecorder::sVersion ) throw Exception( "FLOCK ERROR: unsupported trajectory file version " + std::to_string( version ), __FILE__, __FUNCTION__, __LINE__ );
+		if( byteOrderMark != TrajectoryRecorder::sByteOrderMark ) throw Exception( "FLOCK ERROR: trajectory file has been written with a different byte order", __FILE__, __FUNCTION__, __LINE__ );
+
+		readIndex();
+
+		if( mChunks.empty() == true ) throw Exception( "FLOCK ERROR: trajectory file " + mFilePath + " contains no frames", __FILE__, __FUNCTION__, __LINE__ );
+
+		mPosition = static_cast<double>( mChunks.front().mFirstStep );
+		selectFrame( mChunks.front().mFirstStep );
+	}
+	catch(Exception& e)
+	{
+		mFile.close();
+		mChunks.clear();
+
+		e += Exception( "FLOCK ERROR: failed to open trajectory file " + pFileName, __FILE__, __FUNCTION__, __LINE__ );
+		throw e;
+	}
+}
+
+void
+TrajectoryPlayer::close()
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	if( mFile.is_open() == true ) mFile.close();
+
+	mFileSize = 0;
+	mChunks.clear();
+	mChunkIndex = -1;
+	mFrameIndex = -1;
+	mFrameChanged = false;
+	mPlaying = false;
+	mSnapshot = Snapshot();
+}
+
+bool
+TrajectoryPlayer::isOpen()
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	return mChunks.empty() == false;
+}
+
+long
+TrajectoryPlayer::firstStep()
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	if( mChunks.empty() == true ) return -1;
+
+	return mChunks.front().mFirstStep;
+}
+
+long
+TrajectoryPlayer::lastStep()
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	if( mChunks.empty() == true ) return -1;
+
+	return mChunks.back().mLastStep;
+}
+
+long
+TrajectoryPlayer::step()
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	return mSnapshot.mStep;
+}
+
+double
+TrajectoryPlayer::speed()
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	return mSpeed;
+}
+
+void
+TrajectoryPlayer::setSpeed(double pSpeed)
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	mSpeed = pSpeed;
+}
+
+bool
+TrajectoryPlayer::loop()
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	return mLoop;
+}
+
+void
+TrajectoryPlayer::setLoop(bool pLoop)
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	mLoop = pLoop;
+}
+
+bool
+TrajectoryPlayer::playing()
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	return mPlaying;
+}
+
+void
+TrajectoryPlayer::play()
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	if( mChunks.empty() == false ) mPlaying = true;
+}
+
+void
+TrajectoryPlayer::pause()
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	mPlaying = false;
+}
+
+void
+TrajectoryPlayer::seek(long pStep)
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	if( mChunks.empty() == true ) return;
+
+	mPosition = std::max( std::min( static_cast<double>( pStep ), static_cast<double>( mChunks.back().mLastStep ) ), static_cast<double>( mChunks.front().mFirstStep ) );
+
+	try
+	{
+		selectFrame( static_cast<int64_t>( mPosition ) );
+	}
+	catch(Exception& e)
+	{
+		Simulation::get().exceptionReport( e );
+	}
+}
+
+void
+TrajectoryPlayer::addSnapshotBuffer(std::shared_ptr<SnapshotBuffer> pBuffer)
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	if( std::find( mSnapshotBuffers.begin(), mSnapshotBuffers.end(), pBuffer ) != mSnapshotBuffers.end() ) return;
+
+	mSnapshotBuffers.push_back( pBuffer );
+
+	// the new buffer receives the current frame with the next update
+	mFrameChanged = true;
+}
+
+void
+TrajectoryPlayer::removeSnapshotBuffer(std::shared_ptr<SnapshotBuffer> pBuffer)
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	auto iter = std::find( mSnapshotBuffers.begin(), mSnapshotBuffers.end(), pBuffer );
+	if( iter != mSnapshotBuffers.end() ) mSnapshotBuffers.erase( iter );
+}
+
+void
+TrajectoryPlayer::addSwarm(const std::string& pRecordedSwarmName, const std::string& pSwarmName)
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	for(unsigned int sI=0; sI<mSwarms.size(); ++sI)
+	{
+		if( mSwarms[sI][1] == pSwarmName )
+		{
+			mSwarms[sI][0] = pRecordedSwarmName;
+			return;
+		}
+	}
+
+	std::array<std::string, 2> swarm = { { pRecordedSwarmName, pSwarmName } };
+	mSwarms.push_back( swarm );
+}
+
+void
+TrajectoryPlayer::removeSwarm(const std::string& pSwarmName)
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	mSwarms.erase( std::remove_if( mSwarms.begin(), mSwarms.end(), [&pSwarmName](const std::array<std::string, 2>& pSwarm){ return pSwarm[1] == pSwarmName; } ), mSwarms.end() );
+}
+
+const Snapshot&
+TrajectoryPlayer::snapshot() const
+{
+	return mSnapshot;
+}
+
+void
+TrajectoryPlayer::update()
+{
+	std::lock_guard<std::mutex> lock( mLock );
+
+	if( mChunks.empty() == true ) return;
+
+	try
+	{
+		if( mPlaying == true )
+		{
+			double firstStep = static_cast<double>( mChunks.front().mFirstStep );
+			double lastStep = static_cast<double>( mChunks.back().mLastStep );
+			double stepRange = lastStep - firstStep + 1.0;
+
+			mPosition += mSpeed;
+
+			if( mPosition < firstStep || mPosition >= lastStep + 1.0 )
+			{
+				if( mLoop == true )
+				{
+					mPosition = firstStep + std::fmod( mPosition - firstStep, stepRange );
+					if( mPosition < firstStep ) mPosition += stepRange;
+				}
+				else
+				{
+					mPosition = mPosition < firstStep ? firstStep : lastStep;
+					mPlaying = false;
+				}
+			}
+
+			selectFrame( static_cast<int64_t>( std::floor( mPosition ) ) );
+		}
+
+		if( mFrameChanged == true )
+		{
+			unsigned int bufferCount = mSnapshotBuffers.size();
+			for(unsigned int bI=0; bI<bufferCount; ++bI) mSnapshotBuffers[bI]->publish( mSnapshot );
+
+			mFrameChanged = false;
+		}
+
+		// swarms are overwritten on every update, otherwise their behaviors would move them away from the recording while paused
+		if( mSwarms.empty() == false ) writeSwarms();
+	}
+	catch(Exception& e)
+	{
+		mPlaying = false;
+		Simulation::get().exceptionReport( e );
+	}
+}
+
+void
+TrajectoryPlayer::notifyUpdate()
+{
+	update();
+}
+
+void
+TrajectoryPlayer::readIndex() throw (Exception)
+{
+	mChunks.clear();
+
+	std::vector<char> buffer;
+
+	// index written when recording stopped
+	if( mFileSize >= TrajectoryRecorder::sHeaderSize + TrajectoryRecorder::sTrailerSize )
+	{
+		readBytes( mFileSize - TrajectoryRecorder::sTrailerSize, TrajectoryRecorder::sTrailerSize, buffer );
+
+		if( std::memcmp( buffer.data() + 8, TrajectoryRecorder::sTrailerMagic, 8 ) == 0 )
+		{
+			uint64_t indexOffset;
+			read<uint64_t>( indexOffset, buffer.data(), buffer.data() + buffer.size() );
+
+			if( indexOffset + 8 > mFileSize - TrajectoryRecorder::sTrailerSize ) throw Exception( "FLOCK ERROR: corrupt trajectory file index", __FILE__, __FUNCTION__, __LINE__ );
+
+			readBytes( indexOffset, mFileSize - TrajectoryRecorder::sTrailerSize - indexOffset, buffer );
+
+			const char* data = buffer.data();
+			const char* dataEnd = data + buffer.size();
+
+			if( std::memcmp( data, TrajectoryRecorder::sIndexMagic, 4 ) != 0 ) throw Exception( "FLOCK ERROR: corrupt trajectory file index", __FILE__, __FUNCTION__, __LINE__ );
+			data += 4;
+
+			uint32_t chunkCount;
+			uint32_t reserved;
+			data = read<uint32_t>( chunkCount, data, dataEnd );
+
+			mChunks.resize( chunkCount );
+
+			for(unsigned int cI=0; cI<chunkCount; ++cI)
+			{
+				Chunk& chunk = mChunks[cI];
+
+				data = read<uint64_t>( chunk.mOffset, data, dataEnd );
+				data = read<int64_t>( chunk.mFirstStep, data, dataEnd );
+				data = read<int64_t>( chunk.mLastStep, data, dataEnd );
+				data = read<uint32_t>( chunk.mFrameCount, data, dataEnd );
+				data = read<uint32_t>( reserved, data, dataEnd );
+			}
+
+			return;
+		}
+	}
+
+	// no index, scan chunks
+	uint64_t offset = TrajectoryRecorder::sHeaderSize;
+
+	while( offset + TrajectoryRecorder::sChunkHeaderSize <= mFileSize )
+	{
+		readBytes( offset, TrajectoryRecorder::sChunkHeaderSize, buffer );
+
+		const char* data = buffer.data();
+		const char* dataEnd = data + buffer.size();
+
+		if( std::memcmp( data, TrajectoryRecorder::sChunkMagic, 4 ) != 0 ) break;
+		data += 4;
+
+		Chunk chunk;
+		uint32_t layoutSize;
+		uint32_t dataSize;
+
+		chunk.mOffset = offset;
+		data = read<uint32_t>( chunk.mFrameCount, data, dataEnd );
+		data = read<int64_t>( chunk.mFirstStep, data, dataEnd );
+		data = read<int64_t>( chunk.mLastStep, data, dataEnd );
+		data = read<uint32_t>( layoutSize, data, dataEnd );
+		data = read<uint32_t>( dataSize, data, dataEnd );
+
+		offset += TrajectoryRecorder::sChunkHeaderSize + layoutSize + dataSize;
+
+		// chunk cut off at the end of the file
+		if( offset > mFileSize ) break;
+
+		mChunks.push_back( chunk );
+	}
+}
+
+void
+TrajectoryPlayer::readBytes(uint64_t pOffset, uint64_t pSize, std::vector<char>& pBuffer) throw (Exception)
+{
+	pBuffer.resize( pSize );
+
+	mFile.clear();
+	mFile.seekg( pOffset, std::ios::beg );
+	mFile.read( pBuffer.data(), pSize );
+
+	if( mFile.gcount() != static_cast<std::streamsize>( pSize ) ) throw Exception( "FILE ERROR: failed to read file " + mFilePath, __FILE__, __FUNCTION__, __LINE__ );
+}
+
+void
+TrajectoryPlayer::loadChunk(unsigned int pChunkIndex) throw (Exception)
+{
+	const Chunk& chunk = mChunks[pChunkIndex];
+
+	readBytes( chunk.mOffset, TrajectoryRecorder::sChunkHeaderSize, mChunkBuffer );
+
+	const char* data = mChunkBuffer.data() + 4;
+	const char* dataEnd = mChunkBuffer.data() + mChunkBuffer.size();
+
+	if( std::memcmp( mChunkBuffer.data(), TrajectoryRecorder::sChunkMagic, 4 ) != 0 ) throw Exception( "FLOCK ERROR: corrupt trajectory file chunk", __FILE__, __FUNCTION__, __LINE__ );
+
+	uint32_t frameCount;
+	int64_t firstStep;
+	int64_t lastStep;
+	uint32_t layoutSize;
+	uint32_t dataSize;
+
+	data = read<uint32_t>( frameCount, data, dataEnd );
+	data = read<int64_t>( firstStep, data, dataEnd );
+	data = read<int64_t>( lastStep, data, dataEnd );
+	data = read<uint32_t>( layoutSize, data, dataEnd );
+	data = read<uint32_t>( dataSize, data, dataEnd );
+
+	if( frameCount == 0 ) throw Exception( "FLOCK ERROR: corrupt trajectory file chunk", __FILE__, __FUNCTION__, __LINE__ );
+
+	readBytes( chunk.mOffset + TrajectoryRecorder::sChunkHeaderSize, static_cast<uint64_t>( layoutSize ) + dataSize, mChunkBuffer );
+
+	data = mChunkBuffer.data();
+	dataEnd = data + mChunkBuffer.size();
+
+	// layout
+	uint32_t channelCount;
+	data = read<uint32_t>( channelCount, data, dataEnd );
+
+	mSnapshot.mChannels.resize( channelCount );
+	mFrameValueCount = 0;
+
+	for(unsigned int cI=0; cI<channelCount; ++cI)
+	{
+		Snapshot::Channel& channel = mSnapshot.mChannels[cI];
+		uint32_t nameSize;
+		uint32_t valid;
+
+		data = read<uint32_t>( nameSize, data, dataEnd );
+		if( data + nameSize > dataEnd ) throw Exception( "FLOCK ERROR: unexpected end of trajectory file", __FILE__, __FUNCTION__, __LINE__ );
+		channel.mSwarmName.assign( data, nameSize );
+		data += nameSize;
+
+		data = read<uint32_t>( nameSize, data, dataEnd );
+		if( data + nameSize > dataEnd ) throw Exception( "FLOCK ERROR: unexpected end of trajectory file", __FILE__, __FUNCTION__, __LINE__ );
+		channel.mParameterName.assign( data, nameSize );
+		data += nameSize;
+
+		data = read<uint32_t>( valid, data, dataEnd );
+		data = read<uint32_t>( channel.mAgentCount, data, dataEnd );
+		data = read<uint32_t>( channel.mDim, data, dataEnd );
+		channel.mValid = valid != 0;
+
+		unsigned int valueCount = channel.mValid == true ? channel.mAgentCount * channel.mDim : 0;
+		channel.mValues.resize( valueCount );
+		mFrameValueCount += valueCount;
+	}
+
+	// frames, the first one raw, the following ones as xor with their predecessor
+	mFrameSteps.resize( frameCount );
+	mFrameValues.resize( static_cast<size_t>( frameCount ) * mFrameValueCount );
+
+	uint32_t* values = mFrameValues.data();
+
+	mFrameSteps[0] = firstStep;
+	for(unsigned int vI=0; vI<mFrameValueCount; ++vI) data = read<uint32_t>( values[vI], data, dataEnd );
+
+	for(unsigned int fI=1; fI<frameCount; ++fI)
+	{
+		uint32_t stepDelta;
+		data = readVarint( stepDelta, data, dataEnd );
+		mFrameSteps[fI] = mFrameSteps[fI - 1] + stepDelta;
+
+		const uint32_t* previousValues = values;
+		values += mFrameValueCount;
+
+		for(unsigned int vI=0; vI<mFrameValueCount; ++vI)
+		{
+			uint32_t delta;
+			data = readVarint( delta, data, dataEnd );
+			values[vI] = previousValues[vI] ^ delta;
+		}
+	}
+
+	mChunkIndex = pChunkIndex;
+	mFrameIndex = -1;
+}
+
+void
+TrajectoryPlayer::selectFrame(int64_t pStep) throw (Exception)
+{
+	// last chunk starting at or before step
+	auto chunkIter = std::upper_bound( mChunks.begin(), mChunks.end(), pStep, [](int64_t pStep, const Chunk& pChunk){ return pStep < pChunk.mFirstStep; } );
+	unsigned int chunkIndex = chunkIter == mChunks.begin() ? 0 : ( chunkIter - mChunks.begin() ) - 1;
+
+	if( static_cast<int>( chunkIndex ) != mChunkIndex ) loadChunk( chunkIndex );
+
+	// last frame at or before step
+	auto frameIter = std::upper_bound( mFrameSteps.begin(), mFrameSteps.end(), pStep );
+	int frameIndex = frameIter == mFrameSteps.begin() ? 0 : ( frameIter - mFrameSteps.begin() ) - 1;
+
+	if( frameIndex == mFrameIndex ) return;
+
+	mFrameIndex = frameIndex;
+	mSnapshot.mStep = mFrameSteps[frameIndex];
+
+	const uint32_t* values = mFrameValues.data() + static_cast<size_t>( frameIndex ) * mFrameValueCount;
+	unsigned int channelCount = mSnapshot.mChannels.size();
+
+	for(unsigned int cI=0; cI<channelCount; ++cI)
+	{
+		std::vector<float>& channelValues = mSnapshot.mChannels[cI].mValues;
+		unsigned int valueCount = channelValues.size();
+
+		std::memcpy( channelValues.data(), values, valueCount * sizeof(float) );
+		values += valueCount;
+	}
+
+	mFrameChanged = true;
+}
+
+void
+TrajectoryPlayer::writeSwarms()
+{
+	Simulation& simulation = Simulation::get();
+
+	unsigned int swarmCount = mSwarms.size();
+	unsigned int channelCount = mSnapshot.mChannels.size();
+
+	for(unsigned int sI=0; sI<swarmCount; ++sI)
+	{
+		if( simulation.checkSwarm( mSwarms[sI][1] ) == false ) continue;
+
+		Swarm* swarm = simulation.swarm( mSwarms[sI][1] );
+		std::vector<Agent*>& agents = swarm->agents();
+
+		for(unsigned int cI=0; cI<channelCount; ++cI)
+		{
+			const Snapshot::Channel& channel = mSnapshot.mChannels[cI];
+
+			if( channel.mValid == false || channel.mSwarmName != mSwarms[sI][0] ) continue;
+
+			if( swarm->checkSwarmParameter( channel.mParameterName ) == true )
+			{
+				writeParameter( swarm->swarmParameter( channel.mParameterName ), channel.mValues.data(), channel.mDim );
+			}
+			else if( swarm->checkParameter( channel.mParameterName ) == true )
+			{
+				unsigned int parameterIndex = swarm->parameterIndex( channel.mParameterName );
+				unsigned int agentCount = std::min<unsigned int>( agents.size(), channel.mAgentCount );
+				const float* values = channel.mValues.data();
+
+				for(unsigned int aI=0; aI<agentCount; ++aI, values += channel.mDim) writeParameter( agents[aI]->parameter( parameterIndex ), values, channel.mDim );
+			}
+		}
+	}
+}
+
+void
+TrajectoryPlayer::writeParameter(Parameter* pParameter, const float* pValues, unsigned int pDim)
+{
+	unsigned int dim = std::min( pParameter->dim(), pDim );
+
+	// written at a step boundary, the values are visible immediately and survive the next parameter flush
+	std::copy( pValues, pValues + dim, pParameter->values().data() );
+	std::copy( pValues, pValues + dim, pParameter->backupValues().data() );
+}
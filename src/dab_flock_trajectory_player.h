@@ -0,0 +1,275 @@
+/** \file dab_flock_trajectory_player.h
+ *  \class dab::flock::TrajectoryPlayer plays back trajectory files written by a TrajectoryRecorder
+ *  \brief plays back trajectory files written by a TrajectoryRecorder
+ *
+ *  The player decodes one chunk at a time and advances its position by speed recorded steps on each call of update(). Any speed is possible, negative speeds play backwards.\n
+ *  The current frame is published into registered snapshot buffers, e.g. the one of FlockVisuals (see FlockVisuals::setPlayer()), and can be written into swarms of the simulation.\n
+ *  To write into swarms, the player has to be registered as listener of the simulation (Simulation::addListener()), update() is then called at the beginning of each simulation step. Without a running simulation, the application calls update() itself.\n
+ *  Files without index (e.g. because the application terminated while recording) are indexed by scanning their chunks.\n
+ */
+
+#ifndef _dab_flock_trajectory_player_h_
+#define _dab_flock_trajectory_player_h_
+
+#include <vector>
+#include <array>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+#include "dab_exception.h"
+#include "dab_listener.h"
+#include "dab_flock_snapshot.h"
+
+namespace dab
+{
+
+namespace flock
+{
+
+class Parameter;
+
+class TrajectoryPlayer : public UpdateListener
+{
+public:
+    /**
+     \brief default constructor
+     */
+    TrajectoryPlayer();
+
+    /**
+     \brief destructor
+     */
+    ~TrajectoryPlayer();
+
+    /**
+     \brief open trajectory file and show its first frame
+     \param pFileName file name (relative to the data path)
+     \exception Exception failed to read file or file contains no frames
+     */
+    void open(const std::string& pFileName) throw (Exception);
+
+    /**
+     \brief close trajectory file
+     */
+    void close();
+
+    /**
+     \brief return whether a trajectory file is open
+     \return true if a file is open
+     */
+    bool isOpen();
+
+    /**
+     \brief return step of first recorded frame
+     \return step
+     */
+    long firstStep();
+
+    /**
+     \brief return step of last recorded frame
+     \return step
+     */
+    long lastStep();
+
+    /**
+     \brief return step of current frame
+     \return step (-1 if no file is open)
+     */
+    long step();
+
+    /**
+     \brief return playback speed
+     \return recorded steps per update
+     */
+    double speed();
+
+    /**
+     \brief set playback speed
+     \param pSpeed recorded steps per update (negative values play backwards)
+     */
+    void setSpeed(double pSpeed);
+
+    /**
+     \brief return whether playback restarts at the end of the recording
+     \return true if looping
+     */
+    bool loop();
+
+    /**
+     \brief set whether playback restarts at the end of the recording
+     \param pLoop looping
+     */
+    void setLoop(bool pLoop);
+
+    /**
+     \brief return whether playing
+     \return true if playing
+     */
+    bool playing();
+
+    /**
+     \brief start playback
+     */
+    void play();
+
+    /**
+     \brief pause playback, the current frame is still published and written into swarms
+     */
+    void pause();
+
+    /**
+     \brief move to recorded step
+     \param pStep step (the last frame at or before the step is shown)
+     */
+    void seek(long pStep);
+
+    /**
+     \brief register snapshot buffer into which the current frame is published
+     \param pBuffer snapshot buffer (must not be registered with the simulation at the same time)
+     */
+    void addSnapshotBuffer(std::shared_ptr<SnapshotBuffer> pBuffer);
+
+    /**
+     \brief deregister snapshot buffer
+     \param pBuffer snapshot buffer
+     */
+    void removeSnapshotBuffer(std::shared_ptr<SnapshotBuffer> pBuffer);
+
+    /**
+     \brief write recorded parameters of swarm into swarm of simulation
+     \param pRecordedSwarmName name of recorded swarm
+     \param pSwarmName name of swarm of simulation
+
+     agent parameters are written into as many agents as have been recorded and exist, surplus dimensions are ignored
+     */
+    void addSwarm(const std::string& pRecordedSwarmName, const std::string& pSwarmName);
+
+    /**
+     \brief stop writing into swarm of simulation
+     \param pSwarmName name of swarm of simulation
+     */
+    void removeSwarm(const std::string& pSwarmName);
+
+    /**
+     \brief return current frame
+     \return snapshot
+     */
+    const Snapshot& snapshot() const;
+
+    /**
+     \brief advance playback, publish the current frame and write it into swarms
+     */
+    void update();
+
+    /**
+     \brief called by the simulation at the beginning of each step
+     */
+    virtual void notifyUpdate();
+
+protected:
+    /**
+     \brief chunk position in file
+     */
+    class Chunk
+    {
+    public:
+        uint64_t mOffset; /// \brief file offset of chunk
+        int64_t mFirstStep; /// \brief step of first frame
+        int64_t mLastStep; /// \brief step of last frame
+        uint32_t mFrameCount; /// \brief number of frames
+    };
+
+    std::string mFilePath; /// \brief path of open file
+    std::ifstream mFile; /// \brief open file
+    uint64_t mFileSize; /// \brief size of open file (bytes)
+    std::vector<Chunk> mChunks; /// \brief chunks of open file
+
+    int mChunkIndex; /// \brief index of decoded chunk (-1: none)
+    std::vector<char> mChunkBuffer; /// \brief layout and data of decoded chunk
+    std::vector<int64_t> mFrameSteps; /// \brief steps of all frames of decoded chunk
+    std::vector<uint32_t> mFrameValues; /// \brief values of all frames of decoded chunk as bits (frame after frame)
+    unsigned int mFrameValueCount; /// \brief number of values per frame
+    int mFrameIndex; /// \brief index of current frame in decoded chunk (-1: none)
+    bool mFrameChanged; /// \brief current frame has not been published yet
+
+    Snapshot mSnapshot; /// \brief current frame
+
+    double mPosition; /// \brief playback position (recorded step)
+    double mSpeed; /// \brief recorded steps per update
+    bool mPlaying; /// \brief playing
+    bool mLoop; /// \brief restart at end of recording
+
+    std::vector< std::shared_ptr<SnapshotBuffer> > mSnapshotBuffers; /// \brief buffers into which the current frame is published
+    std::vector< std::array<std::string, 2> > mSwarms; /// \brief recorded swarm names and names of swarms of simulation into which they are written
+    std::mutex mLock; /// \brief guards the player, update() may be called by the simulation thread
+
+    /**
+     \brief read index from end of file or rebuild it by scanning chunks
+     \exception Exception failed to read file
+     */
+    void readIndex() throw (Exception);
+
+    /**
+     \brief read bytes from file
+     \param pOffset file offset
+     \param pSize number of bytes
+     \param pBuffer destination
+     \exception Exception failed to read file
+     */
+    void readBytes(uint64_t pOffset, uint64_t pSize, std::vector<char>& pBuffer) throw (Exception);
+
+    /**
+     \brief decode chunk
+     \param pChunkIndex chunk index
+     \exception Exception failed to read file or corrupt chunk
+     */
+    void loadChunk(unsigned int pChunkIndex) throw (Exception);
+
+    /**
+     \brief make last frame at or before step the current frame
+     \param pStep step
+     \exception Exception failed to read file or corrupt chunk
+     */
+    void selectFrame(int64_t pStep) throw (Exception);
+
+    /**
+     \brief write current frame into swarms of simulation
+     */
+    void writeSwarms();
+
+    /**
+     \brief copy values into parameter
+     \param pParameter parameter
+     \param pValues values
+     \param pDim number of values
+     */
+    void writeParameter(Parameter* pParameter, const float* pValues, unsigned int pDim);
+
+    /**
+     \brief read value
+     \param pValue value
+     \param pBuffer source
+     \param pBufferEnd end of source
+     \return position after value
+     \exception Exception read beyond end of source
+     */
+    template<typename ValueType> static const char* read(ValueType& pValue, const char* pBuffer, const char* pBufferEnd) throw (Exception);
+
+    /**
+     \brief read variable-length integer
+     \param pValue value
+     \param pBuffer source
+     \param pBufferEnd end of source
+     \return position after value
+     \exception Exception read beyond end of source
+     */
+    static const char* readVarint(uint32_t& pValue, const char* pBuffer, const char* pBufferEnd) throw (Exception);
+};
+
+};
+
+};
+
+#endif
@@ -0,0 +1,425 @@
+/** \file dab_flock_trajectory_recorder.cpp
+ */
+
+#include "dab_flock_trajectory_recorder.h"
+#include "ofUtils.h"
+#include <cstring>
+#include <iostream>
+
+using namespace dab;
+using namespace dab::flock;
+
+const std::string TrajectoryRecorder::sFileExtension = ".ftraj";
+const char TrajectoryRecorder::sMagic[8] = { 'D', 'A', 'B', 'F', 'T', 'R', 'A', 'J' };
+const char TrajectoryRecorder::sTrailerMagic[8] = { 'D', 'A', 'B', 'F', 'T', 'E', 'N', 'D' };
+const char TrajectoryRecorder::sChunkMagic[4] = { 'C', 'H', 'N', 'K' };
+const char TrajectoryRecorder::sIndexMagic[4] = { 'I', 'N', 'D', 'X' };
+const uint32_t TrajectoryRecorder::sVersion = 1;
+const uint32_t TrajectoryRecorder::sByteOrderMark = 0x01020304;
+const unsigned int TrajectoryRecorder::sHeaderSize = 24;
+const unsigned int TrajectoryRecorder::sChunkHeaderSize = 32;
+const unsigned int TrajectoryRecorder::sIndexEntrySize = 32;
+const unsigned int TrajectoryRecorder::sTrailerSize = 16;
+
+TrajectoryRecorder::TrajectoryRecorder(unsigned int pQueueSize, unsigned int pChunkFrameCount)
+: SnapshotBuffer()
+, mQueueSize( pQueueSize > 0 ? pQueueSize : 1 )
+, mChunkFrameCount( pChunkFrameCount > 0 ? pChunkFrameCount : 1 )
+, mQueueStart(0)
+, mQueueCount(0)
+, mWriteFailed(false)
+, mChunkFrames(0)
+, mChunkFirstStep(0)
+, mChunkLastStep(0)
+, mRecordedFrameCount(0)
+, mDroppedFrameCount(0)
+, mRecordedByteCount(0)
+, mRecording(false)
+, mTerminated(false)
+{}
+
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+	try
+	{
+		stop();
+	}
+	catch(Exception& e)
+	{
+		std::cout << e << "\n";
+	}
+}
+
+bool
+TrajectoryRecorder::recording() const
+{
+	return mRecording;
+}
+
+void
+TrajectoryRecorder::start(const std::string& pFileName) throw (Exception)
+{
+	if( mRecording == true ) throw Exception( "FLOCK ERROR: trajectory recorder is already recording to " + mFilePath, __FILE__, __FUNCTION__, __LINE__ );
+
+	// the writer thread is not running, the recorder state can be reset without locking
+	if( mThread.joinable() == true ) mThread.join();
+
+	mFilePath = ofToDataPath( pFileName );
+	mFile.open( mFilePath, std::ios::binary | std::ios::trunc );
+	if( mFile.is_open() == false ) throw Exception( "FILE ERROR: failed to open file " + mFilePath + " for writing", __FILE__, __FUNCTION__, __LINE__ );
+
+	mWriteFailed = false;
+	mWriteError.clear();
+	mChunkFrames = 0;
+	mIndex.clear();
+	mRecordedFrameCount = 0;
+	mDroppedFrameCount = 0;
+	mRecordedByteCount = 0;
+
+	mSlots.resize( mQueueSize + 1 );
+	mFreeSlots.clear();
+	for(unsigned int sI=0; sI<mSlots.size(); ++sI) mFreeSlots.push_back( sI );
+	mQueuedSlots.assign( mSlots.size(), 0 );
+	mQueueStart = 0;
+	mQueueCount = 0;
+
+	// header
+	mChunkHeader.clear();
+	mChunkHeader.insert( mChunkHeader.end(), sMagic, sMagic + 8 );
+	append<uint32_t>( sVersion, mChunkHeader );
+	append<uint32_t>( sByteOrderMark, mChunkHeader );
+	append<uint32_t>( mChunkFrameCount, mChunkHeader );
+	append<uint32_t>( 0, mChunkHeader );
+
+	try
+	{
+		writeBytes( mChunkHeader );
+	}
+	catch(Exception& e)
+	{
+		mFile.close();
+		throw e;
+	}
+
+	mTerminated = false;
+	mRecording = true;
+	mThread = std::thread( &TrajectoryRecorder::work, this );
+}
+
+void
+TrajectoryRecorder::stop() throw (Exception)
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+
+		if( mRecording == false ) return;
+
+		// no further snapshots are queued, the writer thread drains the queue before terminating
+		mRecording = false;
+		mTerminated = true;
+	}
+
+	mCondition.notify_one();
+	mThread.join();
+
+	if( mWriteFailed == true ) throw Exception( "FLOCK ERROR: failed to record trajectory: " + mWriteError, __FILE__, __FUNCTION__, __LINE__ );
+}
+
+unsigned long
+TrajectoryRecorder::recordedFrameCount()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+
+	return mRecordedFrameCount;
+}
+
+unsigned long
+TrajectoryRecorder::droppedFrameCount()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+
+	return mDroppedFrameCount;
+}
+
+unsigned long
+TrajectoryRecorder::recordedByteCount()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+
+	return mRecordedByteCount;
+}
+
+void
+TrajectoryRecorder::publish(long pStep)
+{
+	updateSources();
+
+	unsigned int slot;
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+
+		if( mRecording == false ) return;
+
+		// the simulation never waits for the writer thread
+		if( mFreeSlots.empty() == true || mWriteFailed == true )
+		{
+			mDroppedFrameCount++;
+			return;
+		}
+
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+	}
+
+	fill( mSlots[slot], pStep );
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+
+		mQueuedSlots[ ( mQueueStart + mQueueCount ) % mQueuedSlots.size() ] = slot;
+		mQueueCount++;
+	}
+
+	mCondition.notify_one();
+}
+
+void
+TrajectoryRecorder::appendVarint(uint32_t pValue, std::vector<char>& pBuffer)
+{
+	while( pValue >= 0x80 )
+	{
+		pBuffer.push_back( static_cast<char>( ( pValue & 0x7F ) | 0x80 ) );
+		pValue >>= 7;
+	}
+
+	pBuffer.push_back( static_cast<char>( pValue ) );
+}
+
+void
+TrajectoryRecorder::work()
+{
+	while( true )
+	{
+		unsigned int slot;
+
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			mCondition.wait( lock, [this]{ return mQueueCount > 0 || mTerminated == true; } );
+
+			if( mQueueCount == 0 ) break;
+
+			slot = mQueuedSlots[mQueueStart];
+			mQueueStart = ( mQueueStart + 1 ) % mQueuedSlots.size();
+			mQueueCount--;
+		}
+
+		bool written = false;
+
+		if( mWriteFailed == false )
+		{
+			try
+			{
+				writeFrame( mSlots[slot] );
+				written = true;
+			}
+			catch(Exception& e)
+			{
+				std::lock_guard<std::mutex> lock( mMutex );
+
+				mWriteFailed = true;
+				mWriteError = e;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock( mMutex );
+
+		if( written == true ) mRecordedFrameCount++;
+		else mDroppedFrameCount++;
+
+		mFreeSlots.push_back( slot );
+	}
+
+	if( mWriteFailed == false )
+	{
+		try
+		{
+			if( mChunkFrames > 0 ) writeChunk();
+			writeIndex();
+		}
+		catch(Exception& e)
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+
+			mWriteFailed = true;
+			mWriteError = e;
+		}
+	}
+
+	mFile.close();
+}
+
+void
+TrajectoryRecorder::writeFrame(const Snapshot& pSnapshot) throw (Exception)
+{
+	if( mChunkFrames > 0 && ( mChunkFrames >= mChunkFrameCount || pSnapshot.mStep <= mChunkLastStep || checkLayout( pSnapshot ) == false ) ) writeChunk();
+
+	unsigned int channelCount = pSnapshot.mChannels.size();
+
+	if( mChunkFrames == 0 )
+	{
+		unsigned int valueCount = 0;
+
+		mChunkLayout.resize( channelCount );
+
+		for(unsigned int cI=0; cI<channelCount; ++cI)
+		{
+			const Snapshot::Channel& channel = pSnapshot.mChannels[cI];
+			Snapshot::Channel& layoutChannel = mChunkLayout[cI];
+
+			layoutChannel.mSwarmName = channel.mSwarmName;
+			layoutChannel.mParameterName = channel.mParameterName;
+			layoutChannel.mValid = channel.mValid;
+			layoutChannel.mAgentCount = channel.mAgentCount;
+			layoutChannel.mDim = channel.mDim;
+
+			valueCount += channel.mValues.size();
+		}
+
+		mPreviousValues.assign( valueCount, 0 );
+		mChunkData.clear();
+		mChunkFirstStep = pSnapshot.mStep;
+	}
+	else
+	{
+		appendVarint( static_cast<uint32_t>( pSnapshot.mStep - mChunkLastStep ), mChunkData );
+	}
+
+	// first frame raw, following frames as xor with previous frame
+	uint32_t* previousValues = mPreviousValues.data();
+
+	for(unsigned int cI=0; cI<channelCount; ++cI)
+	{
+		const std::vector<float>& values = pSnapshot.mChannels[cI].mValues;
+		unsigned int valueCount = values.size();
+
+		for(unsigned int vI=0; vI<valueCount; ++vI, ++previousValues)
+		{
+			uint32_t bits;
+			std::memcpy( &bits, &values[vI], sizeof(uint32_t) );
+
+			if( mChunkFrames == 0 ) append<uint32_t>( bits, mChunkData );
+			else appendVarint( bits ^ *previousValues, mChunkData );
+
+			*previousValues = bits;
+		}
+	}
+
+	mChunkLastStep = pSnapshot.mStep;
+	mChunkFrames++;
+}
+
+bool
+TrajectoryRecorder::checkLayout(const Snapshot& pSnapshot) const
+{
+	unsigned int channelCount = mChunkLayout.size();
+	if( pSnapshot.mChannels.size() != channelCount ) return false;
+
+	for(unsigned int cI=0; cI<channelCount; ++cI)
+	{
+		const Snapshot::Channel& channel = pSnapshot.mChannels[cI];
+		const Snapshot::Channel& layoutChannel = mChunkLayout[cI];
+
+		if( channel.mValid != layoutChannel.mValid ) return false;
+		if( channel.mAgentCount != layoutChannel.mAgentCount ) return false;
+		if( channel.mDim != layoutChannel.mDim ) return false;
+		if( channel.mSwarmName != layoutChannel.mSwarmName ) return false;
+		if( channel.mParameterName != layoutChannel.mParameterName ) return false;
+	}
+
+	return true;
+}
+
+void
+TrajectoryRecorder::writeChunk() throw (Exception)
+{
+	mChunkHeader.clear();
+	mChunkHeader.insert( mChunkHeader.end(), sChunkMagic, sChunkMagic + 4 );
+	append<uint32_t>( mChunkFrames, mChunkHeader );
+	append<int64_t>( mChunkFirstStep, mChunkHeader );
+	append<int64_t>( mChunkLastStep, mChunkHeader );
+	append<uint32_t>( 0, mChunkHeader ); // layout size, filled in below
+	append<uint32_t>( mChunkData.size(), mChunkHeader );
+
+	// layout
+	unsigned int channelCount = mChunkLayout.size();
+	append<uint32_t>( channelCount, mChunkHeader );
+
+	for(unsigned int cI=0; cI<channelCount; ++cI)
+	{
+		const Snapshot::Channel& channel = mChunkLayout[cI];
+
+		append<uint32_t>( channel.mSwarmName.size(), mChunkHeader );
+		mChunkHeader.insert( mChunkHeader.end(), channel.mSwarmName.begin(), channel.mSwarmName.end() );
+		append<uint32_t>( channel.mParameterName.size(), mChunkHeader );
+		mChunkHeader.insert( mChunkHeader.end(), channel.mParameterName.begin(), channel.mParameterName.end() );
+		append<uint32_t>( channel.mValid == true ? 1 : 0, mChunkHeader );
+		append<uint32_t>( channel.mAgentCount, mChunkHeader );
+		append<uint32_t>( channel.mDim, mChunkHeader );
+	}
+
+	uint32_t layoutSize = mChunkHeader.size() - sChunkHeaderSize;
+	std::memcpy( mChunkHeader.data() + sChunkHeaderSize - 8, &layoutSize, sizeof(uint32_t) );
+
+	IndexEntry entry;
+	entry.mOffset = mRecordedByteCount;
+	entry.mFirstStep = mChunkFirstStep;
+	entry.mLastStep = mChunkLastStep;
+	entry.mFrameCount = mChunkFrames;
+
+	writeBytes( mChunkHeader );
+	writeBytes( mChunkData );
+
+	// a player can rebuild the index of an incomplete file from the chunks written so far
+	mFile.flush();
+
+	mIndex.push_back( entry );
+	mChunkFrames = 0;
+}
+
+void
+TrajectoryRecorder::writeIndex() throw (Exception)
+{
+	uint64_t indexOffset = mRecordedByteCount;
+	unsigned int chunkCount = mIndex.size();
+
+	mChunkHeader.clear();
+	mChunkHeader.insert( mChunkHeader.end(), sIndexMagic, sIndexMagic + 4 );
+	append<uint32_t>( chunkCount, mChunkHeader );
+
+	for(unsigned int cI=0; cI<chunkCount; ++cI)
+	{
+		const IndexEntry& entry = mIndex[cI];
+
+		append<uint64_t>( entry.mOffset, mChunkHeader );
+		append<int64_t>( entry.mFirstStep, mChunkHeader );
+		append<int64_t>( entry.mLastStep, mChunkHeader );
+		append<uint32_t>( entry.mFrameCount, mChunkHeader );
+		append<uint32_t>( 0, mChunkHeader );
+	}
+
+	append<uint64_t>( indexOffset, mChunkHeader );
+	mChunkHeader.insert( mChunkHeader.end(), sTrailerMagic, sTrailerMagic + 8 );
+
+	writeBytes( mChunkHeader );
+}
+
+void
+TrajectoryRecorder::writeBytes(const std::vector<char>& pBuffer) throw (Exception)
+{
+	mFile.write( pBuffer.data(), pBuffer.size() );
+	if( mFile.good() == false ) throw Exception( "FILE ERROR: failed to write file " + mFilePath, __FILE__, __FUNCTION__, __LINE__ );
+
+	std::lock_guard<std::mutex> lock( mMutex );
+	mRecordedByteCount += pBuffer.size();
+}
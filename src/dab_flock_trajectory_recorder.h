@@ -0,0 +1,217 @@
+/** \file dab_flock_trajectory_recorder.h
+ *  \class dab::flock::TrajectoryRecorder records selected swarm parameters of every simulation step into a compressed file
+ *  \brief records selected swarm parameters of every simulation step into a compressed file
+ *
+ *  The recorder is a snapshot buffer. Parameters are selected with addParameter() and the recorder is registered with Simulation::addSnapshotBuffer().\n
+ *  While recording, the simulation thread copies the selected parameters into a preallocated snapshot and passes it through a bounded queue to a writer thread. If the queue is full, the snapshot of the step is dropped and counted.\n
+ *  The writer thread groups consecutive steps into chunks. The first frame of a chunk stores the raw values, each following frame stores the bitwise xor of every value with its value in the previous frame as variable-length integer. Values that change little between steps therefore shrink to one or two bytes.\n
+ *  A new chunk is started after the chunk frame count has been reached or whenever the layout of the channels changes (e.g. agents have been added). An index of all chunks is written when recording stops, a TrajectoryPlayer uses it to seek.\n
+ *
+ *  File layout:\n
+ *  header: magic "DABFTRAJ", version, byte order mark, chunk frame count, reserved (24 bytes)\n
+ *  chunk: "CHNK", frame count, first step, last step, layout size, data size, layout (channel names and sizes), data\n
+ *  index: "INDX", chunk count, (offset, first step, last step, frame count, reserved) per chunk\n
+ *  trailer: index offset, "DABFTEND"\n
+ */
+
+#ifndef _dab_flock_trajectory_recorder_h_
+#define _dab_flock_trajectory_recorder_h_
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "dab_exception.h"
+#include "dab_flock_snapshot.h"
+
+namespace dab
+{
+
+namespace flock
+{
+
+class TrajectoryRecorder : public SnapshotBuffer
+{
+public:
+    static const std::string sFileExtension; /// \brief file name extension of trajectory files
+    static const char sMagic[8]; /// \brief magic number at the beginning of the file
+    static const char sTrailerMagic[8]; /// \brief magic number at the end of the file
+    static const char sChunkMagic[4]; /// \brief magic number at the beginning of a chunk
+    static const char sIndexMagic[4]; /// \brief magic number at the beginning of the index
+    static const uint32_t sVersion; /// \brief format version
+    static const uint32_t sByteOrderMark; /// \brief detects files written with a different byte order
+    static const unsigned int sHeaderSize; /// \brief file header size (bytes)
+    static const unsigned int sChunkHeaderSize; /// \brief chunk header size (bytes)
+    static const unsigned int sIndexEntrySize; /// \brief index entry size (bytes)
+    static const unsigned int sTrailerSize; /// \brief trailer size (bytes)
+
+    /**
+     \brief create recorder
+     \param pQueueSize maximum number of snapshots waiting to be written
+     \param pChunkFrameCount maximum number of frames per chunk
+     */
+    TrajectoryRecorder(unsigned int pQueueSize = 16, unsigned int pChunkFrameCount = 64);
+
+    /**
+     \brief destructor, stops recording
+     */
+    ~TrajectoryRecorder();
+
+    /**
+     \brief return whether recording
+     \return true if recording
+     */
+    bool recording() const;
+
+    /**
+     \brief start recording
+     \param pFileName file name (relative to the data path)
+     \exception Exception already recording or failed to open file
+     */
+    void start(const std::string& pFileName) throw (Exception);
+
+    /**
+     \brief stop recording, writes all queued snapshots and the index
+     \exception Exception failed to write file
+     */
+    void stop() throw (Exception);
+
+    /**
+     \brief return number of recorded frames
+     \return number of frames written since recording started
+     */
+    unsigned long recordedFrameCount();
+
+    /**
+     \brief return number of dropped frames
+     \return number of frames dropped because the queue was full or writing failed
+     */
+    unsigned long droppedFrameCount();
+
+    /**
+     \brief return number of bytes written
+     \return file size so far
+     */
+    unsigned long recordedByteCount();
+
+    /**
+     \brief copy selected parameters and queue them for writing (called by the simulation)
+     \param pStep simulation step
+     */
+    void publish(long pStep);
+
+    /**
+     \brief append variable-length integer
+     \param pValue value
+     \param pBuffer destination
+     */
+    static void appendVarint(uint32_t pValue, std::vector<char>& pBuffer);
+
+    /**
+     \brief append value
+     \param pValue value
+     \param pBuffer destination
+     */
+    template<typename ValueType> static void append(ValueType pValue, std::vector<char>& pBuffer);
+
+protected:
+    /**
+     \brief chunk position in file
+     */
+    class IndexEntry
+    {
+    public:
+        uint64_t mOffset; /// \brief file offset of chunk
+        int64_t mFirstStep; /// \brief step of first frame
+        int64_t mLastStep; /// \brief step of last frame
+        uint32_t mFrameCount; /// \brief number of frames
+    };
+
+    unsigned int mQueueSize; /// \brief maximum number of queued snapshots
+    unsigned int mChunkFrameCount; /// \brief maximum number of frames per chunk
+
+    std::vector<Snapshot> mSlots; /// \brief preallocated snapshots (queue size + the one being written)
+    std::vector<unsigned int> mFreeSlots; /// \brief indices of unused snapshots
+    std::vector<unsigned int> mQueuedSlots; /// \brief ring of indices of snapshots waiting to be written
+    unsigned int mQueueStart; /// \brief ring index of oldest queued snapshot
+    unsigned int mQueueCount; /// \brief number of queued snapshots
+
+    std::string mFilePath; /// \brief path of file being recorded
+    std::ofstream mFile; /// \brief file being recorded (writer thread)
+    bool mWriteFailed; /// \brief writing failed, remaining frames are dropped
+    std::string mWriteError; /// \brief error message of failed write
+
+    std::vector<char> mChunkHeader; /// \brief header and layout of current chunk (also used for file header and index)
+    std::vector<char> mChunkData; /// \brief encoded frames of current chunk
+    std::vector<Snapshot::Channel> mChunkLayout; /// \brief channel layout of current chunk (without values)
+    std::vector<uint32_t> mPreviousValues; /// \brief values of previous frame as bits
+    unsigned int mChunkFrames; /// \brief number of frames in current chunk
+    int64_t mChunkFirstStep; /// \brief step of first frame in current chunk
+    int64_t mChunkLastStep; /// \brief step of last frame in current chunk
+    std::vector<IndexEntry> mIndex; /// \brief written chunks
+
+    unsigned long mRecordedFrameCount; /// \brief number of recorded frames
+    unsigned long mDroppedFrameCount; /// \brief number of dropped frames
+    unsigned long mRecordedByteCount; /// \brief number of bytes written
+
+    std::thread mThread; /// \brief writer thread
+    bool mRecording; /// \brief recording
+    bool mTerminated; /// \brief writer thread termination flag
+    std::mutex mMutex; /// \brief guards the queue and counters
+    std::condition_variable mCondition; /// \brief signals the writer thread that a snapshot has been queued
+
+    /**
+     \brief writer thread loop
+     */
+    void work();
+
+    /**
+     \brief encode snapshot into current chunk, starts a new chunk if necessary (writer thread)
+     \param pSnapshot snapshot
+     \exception Exception failed to write file
+     */
+    void writeFrame(const Snapshot& pSnapshot) throw (Exception);
+
+    /**
+     \brief check whether channel layout of snapshot equals layout of current chunk
+     \param pSnapshot snapshot
+     \return true if layouts are equal
+     */
+    bool checkLayout(const Snapshot& pSnapshot) const;
+
+    /**
+     \brief write current chunk to file (writer thread)
+     \exception Exception failed to write file
+     */
+    void writeChunk() throw (Exception);
+
+    /**
+     \brief write index and trailer to file (writer thread)
+     \exception Exception failed to write file
+     */
+    void writeIndex() throw (Exception);
+
+    /**
+     \brief write bytes to file (writer thread)
+     \param pBuffer bytes
+     \exception Exception failed to write file
+     */
+    void writeBytes(const std::vector<char>& pBuffer) throw (Exception);
+};
+
+template<typename ValueType>
+void
+TrajectoryRecorder::append(ValueType pValue, std::vector<char>& pBuffer)
+{
+    const char* bytes = reinterpret_cast<const char*>( &pValue );
+    pBuffer.insert( pBuffer.end(), bytes, bytes + sizeof(ValueType) );
+}
+
+};
+
+};
+
+#endif
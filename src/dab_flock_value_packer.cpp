@@ -0,0 +1,154 @@
+/** \file dab_flock_value_packer.cpp
+ */
+
+#include "dab_flock_value_packer.h"
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace dab;
+using namespace dab::flock;
+
+const unsigned int ValuePacker::sHeaderSize = 20;
+
+ValuePacker::ValuePacker()
+: mBlobCount(0)
+{}
+
+unsigned int
+ValuePacker::valueSize(Format pFormat)
+{
+	return pFormat == Float32Format ? 4 : 2;
+}
+
+void
+ValuePacker::pack(Format pFormat, unsigned int pSequence, unsigned int pAgentOffset, unsigned int pAgentCount, unsigned int pDim, const float* pValues, unsigned int pMaxBlobSize) throw (Exception)
+{
+	if( pDim > 0xffff ) throw Exception( "FLOCK ERROR: parameter dimension " + std::to_string(pDim) + " exceeds maximum dimension for packing", __FILE__, __FUNCTION__, __LINE__ );
+
+	unsigned int agentSize = pDim * valueSize(pFormat);
+	unsigned int blobAgentCount = pMaxBlobSize > sHeaderSize && agentSize > 0 ? ( pMaxBlobSize - sHeaderSize ) / agentSize : pAgentCount;
+	blobAgentCount = std::max<unsigned int>( std::min( blobAgentCount, pAgentCount ), 1 );
+
+	mBlobCount = 0;
+
+	for(unsigned int aI=0; aI < pAgentCount; aI += blobAgentCount )
+	{
+		unsigned int agentCount = std::min( blobAgentCount, pAgentCount - aI );
+		unsigned int valueCount = agentCount * pDim;
+
+		if( mBlobs.size() <= mBlobCount ) mBlobs.resize( mBlobCount + 1 );
+		std::vector<char>& blob = mBlobs[mBlobCount++];
+		blob.resize( sHeaderSize + agentCount * agentSize );
+
+		char* data = blob.data();
+		data = write32( pSequence, data );
+		data = write32( pAgentCount, data );
+		data = write32( pAgentOffset + aI, data );
+		data = write32( agentCount, data );
+		data = write16( pDim, data );
+		data = write16( pFormat, data );
+
+		const float* values = pValues + aI * pDim;
+
+		if( pFormat == Float32Format )
+		{
+			uint32_t bits;
+
+			for(unsigned int vI=0; vI<valueCount; ++vI)
+			{
+				std::memcpy( &bits, values + vI, 4 );
+				data = write32( bits, data );
+			}
+		}
+		else if( pFormat == Float16Format )
+		{
+			for(unsigned int vI=0; vI<valueCount; ++vI) data = write16( halfFloat( values[vI] ), data );
+		}
+		else
+		{
+			float value;
+
+			for(unsigned int vI=0; vI<valueCount; ++vI)
+			{
+				value = std::max( std::min( values[vI], 1.0f ), 0.0f );
+				data = write16( static_cast<uint16_t>( static_cast<int16_t>( std::lround( value * 65535.0f ) - 32768 ) ), data );
+			}
+		}
+	}
+}
+
+unsigned int
+ValuePacker::blobCount() const
+{
+	return mBlobCount;
+}
+
+const std::vector<char>&
+ValuePacker::blob(unsigned int pIndex) const
+{
+	return mBlobs[pIndex];
+}
+
+char*
+ValuePacker::write16(uint16_t pValue, char* pBuffer)
+{
+	pBuffer[0] = static_cast<char>( pValue & 0xff );
+	pBuffer[1] = static_cast<char>( ( pValue >> 8 ) & 0xff );
+
+	return pBuffer + 2;
+}
+
+char*
+ValuePacker::write32(uint32_t pValue, char* pBuffer)
+{
+	pBuffer[0] = static_cast<char>( pValue & 0xff );
+	pBuffer[1] = static_cast<char>( ( pValue >> 8 ) & 0xff );
+	pBuffer[2] = static_cast<char>( ( pValue >> 16 ) & 0xff );
+	pBuffer[3] = static_cast<char>( ( pValue >> 24 ) & 0xff );
+
+	return pBuffer + 4;
+}
+
+uint16_t
+ValuePacker::halfFloat(float pValue)
+{
+	uint32_t bits;
+	std::memcpy( &bits, &pValue, 4 );
+
+	uint16_t sign = static_cast<uint16_t>( ( bits >> 16 ) & 0x8000 );
+	int exponent = static_cast<int>( ( bits >> 23 ) & 0xff );
+	uint32_t mantissa = bits & 0x7fffff;
+
+	// nan and infinity
+	if( exponent == 0xff ) return sign | 0x7c00 | ( mantissa != 0 ? 0x200 : 0 );
+
+	exponent = exponent - 127 + 15;
+
+	// overflow to infinity
+	if( exponent >= 0x1f ) return sign | 0x7c00;
+
+	// subnormal or zero
+	if( exponent <= 0 )
+	{
+		if( exponent < -10 ) return sign;
+
+		mantissa |= 0x800000;
+		unsigned int shift = 14 - exponent;
+		uint32_t half = mantissa >> shift;
+		uint32_t remainder = mantissa & ( ( 1u << shift ) - 1 );
+		uint32_t halfway = 1u << ( shift - 1 );
+
+		if( remainder > halfway || ( remainder == halfway && ( half & 1 ) ) ) half++;
+
+		return sign | static_cast<uint16_t>( half );
+	}
+
+	uint32_t half = ( static_cast<uint32_t>( exponent ) << 10 ) | ( mantissa >> 13 );
+	uint32_t remainder = mantissa & 0x1fff;
+
+	// rounding may carry into the exponent, which correctly yields infinity on overflow
+	if( remainder > 0x1000 || ( remainder == 0x1000 && ( half & 1 ) ) ) half++;
+
+	return sign | static_cast<uint16_t>( half );
+}
@@ -0,0 +1,107 @@
+/** \file dab_flock_value_packer.h
+ *  \class dab::flock::ValuePacker packs parameter values into binary blobs
+ *  \brief packs parameter values into binary blobs
+ *
+ *  Packs the values of a parameter for a range of agents into one or several blobs that are sent as a single osc blob argument each.\n
+ *  Blobs are only split when they would exceed the maximum blob size (which is derived from the network MTU), and always at agent boundaries.\n
+ *  All numbers are little-endian. Each blob starts with a header:\n
+ *  uint32 sequence number, uint32 total agent count, uint32 index of first agent in blob, uint32 agent count in blob, uint16 values per agent, uint16 format\n
+ *  followed by the values of the agents in the blob: float32, float16 or int16 (quantized from the normalised range 0.0 - 1.0 to -32768 - 32767).\n
+ */
+
+#ifndef _dab_flock_value_packer_h_
+#define _dab_flock_value_packer_h_
+
+#include <vector>
+#include <cstdint>
+#include "dab_exception.h"
+
+namespace dab
+{
+
+namespace flock
+{
+
+class ValuePacker
+{
+public:
+    enum Format
+    {
+        Float32Format,
+        Float16Format,
+        Int16Format
+    };
+
+    static const unsigned int sHeaderSize; /// \brief size of blob header in bytes
+
+    /**
+     \brief default constructor
+     */
+    ValuePacker();
+
+    /**
+     \brief return size of a single packed value
+     \param pFormat value format
+     \return size of value in bytes
+     */
+    static unsigned int valueSize(Format pFormat);
+
+    /**
+     \brief pack values into blobs
+     \param pFormat value format
+     \param pSequence sequence number
+     \param pAgentOffset index of first agent
+     \param pAgentCount number of agents
+     \param pDim number of values per agent
+     \param pValues values (pAgentCount * pDim), for the int16 format the values are expected to be normalised
+     \param pMaxBlobSize maximum size of a blob in bytes (a blob contains at least one agent even if it exceeds this size)
+     \exception Exception dimension exceeds range of header field
+     */
+    void pack(Format pFormat, unsigned int pSequence, unsigned int pAgentOffset, unsigned int pAgentCount, unsigned int pDim, const float* pValues, unsigned int pMaxBlobSize) throw (Exception);
+
+    /**
+     \brief return number of blobs created by the last call of pack
+     \return number of blobs
+     */
+    unsigned int blobCount() const;
+
+    /**
+     \brief return blob created by the last call of pack
+     \param pIndex blob index
+     \return blob
+     */
+    const std::vector<char>& blob(unsigned int pIndex) const;
+
+protected:
+    std::vector< std::vector<char> > mBlobs; /// \brief blob buffers (kept allocated between calls)
+    unsigned int mBlobCount; /// \brief number of blobs created by the last call of pack
+
+    /**
+     \brief write 16 bit little-endian integer
+     \param pValue value
+     \param pBuffer destination
+     \return position after written value
+     */
+    static char* write16(uint16_t pValue, char* pBuffer);
+
+    /**
+     \brief write 32 bit little-endian integer
+     \param pValue value
+     \param pBuffer destination
+     \return position after written value
+     */
+    static char* write32(uint32_t pValue, char* pBuffer);
+
+    /**
+     \brief convert float to half precision float (round to nearest even)
+     \param pValue value
+     \return half precision bits
+     */
+    static uint16_t halfFloat(float pValue);
+};
+
+};
+
+};
+
+#endif
@@ -11,6 +11,8 @@
 #include "dab_flock_visual_agent_trail.h"
 #include "dab_flock_visual_neighbor_space.h"
 #include "dab_flock_visual_grid_space.h"
+#include "dab_flock_snapshot.h"
+#include "dab_flock_trajectory_player.h"
 
 using namespace dab;
 using namespace dab::flock;
@@ -41,6 +43,7 @@ FlockVisuals::FlockVisuals()
 , mInitialised(false)
 , mSimUpdated(false)
 , mLock(false)
+, mSnapshotBuffer(new SnapshotBuffer())
 {
     // create default agent geometry
     if(sAgentPyramidGeom == nullptr)
@@ -98,6 +101,8 @@ void
 FlockVisuals::clear()
 {
     Simulation::get().removeListener(mSelf);
+    Simulation::get().removeSnapshotBuffer(mSnapshotBuffer);
+    if(mPlayer != nullptr) mPlayer->removeSnapshotBuffer(mSnapshotBuffer);
     mSelf.reset();
 }
 
@@ -236,6 +241,9 @@ FlockVisuals::showSwarm( const std::string& pSwarmName, const std::string& pPosP
         _visSwarm->createAgentTrail(pMaxTrailLength);
         
         mVisualSwarms.push_back(_visSwarm);
+        
+        mSnapshotBuffer->addParameter(pSwarmName, pPosParName);
+        if(pVelParName.empty() == false) mSnapshotBuffer->addParameter(pSwarmName, pVelParName);
     }
     
     mLock = false;
@@ -260,6 +268,7 @@ FlockVisuals::hideSwarm( const std::string& pSwarmName )
 		{
             mVisualSwarms.erase( mVisualSwarms.begin() + sI );
             delete visSwarm;
+            mSnapshotBuffer->removeParameters(pSwarmName);
             mLock = false;
             return;
 		}
@@ -286,6 +295,8 @@ FlockVisuals::hideSwarms()
         delete visSwarm;
 	}
     
+    mSnapshotBuffer->clearParameters();
+    
 	mLock = false;
 }
 
@@ -456,6 +467,21 @@ FlockVisuals::setSpaceValueScale( const std::string& pSpaceName, float pValueSca
     }
 }
 
+void
+FlockVisuals::setPlayer( std::shared_ptr<TrajectoryPlayer> pPlayer )
+{
+    if(mPlayer == pPlayer) return;
+
+    // a snapshot buffer has a single writer, either the simulation or the player
+    if(mPlayer != nullptr) mPlayer->removeSnapshotBuffer(mSnapshotBuffer);
+    else Simulation::get().removeSnapshotBuffer(mSnapshotBuffer);
+
+    mPlayer = pPlayer;
+
+    if(mPlayer != nullptr) mPlayer->addSnapshotBuffer(mSnapshotBuffer);
+    else Simulation::get().addSnapshotBuffer(mSnapshotBuffer);
+}
+
 void
 FlockVisuals::notifyUpdate()
 {
@@ -533,6 +559,7 @@ FlockVisuals::init()
     glEnable(GL_DEPTH_TEST);
     
     Simulation::get().addListener(mSelf);
+    if(mPlayer == nullptr) Simulation::get().addSnapshotBuffer(mSnapshotBuffer);
 }
 
 void
@@ -556,7 +583,6 @@ FlockVisuals::update()
         mEventManager.update();
         
         removeVisSwarms();
-        updateVisSwarms();
         
         removeVisSpaces();
         updateVisSpaces();
@@ -565,6 +591,9 @@ FlockVisuals::update()
         
         mSimUpdated = false;
     }
+    
+    // agent positions are read from the newest snapshot published by the simulation
+    if(mSnapshotBuffer->update() == true) updateVisSwarms();
 	   
     if(simulation.paused() == false)
     {
@@ -601,6 +630,7 @@ FlockVisuals::removeVisSwarms()
         
 		if( simulation.checkSwarm( visSwarm->swarmName() ) == false )
 		{
+            mSnapshotBuffer->removeParameters( visSwarm->swarmName() );
             mVisualSwarms.erase( mVisualSwarms.begin() + sI );
             delete visSwarm;
 		}
@@ -611,10 +641,11 @@ void
 FlockVisuals::updateVisSwarms()
 {
 	int visSwarmCount = mVisualSwarms.size();
+	const Snapshot& snapshot = mSnapshotBuffer->snapshot();
 	
 	for(int sI = visSwarmCount - 1; sI >= 0; --sI)
 	{
-		mVisualSwarms[sI]->update();
+		mVisualSwarms[sI]->update(snapshot);
 	}
 }
 
@@ -26,6 +26,8 @@ class VisAgentShape;
 class VisAgentTrail;
 class VisNeighborSpace;
 class VisGridSpace;
+class SnapshotBuffer;
+class TrajectoryPlayer;
         
 class FlockVisuals : public Singleton<FlockVisuals>, public UpdateListener
 {
@@ -79,6 +81,14 @@ public:
 	void setSpaceLineWidth( const std::string& pSpaceName, float pLineWidth );
 	void setSpaceValueScale( const std::string& pSpaceName, float pValueScale );
     
+    /**
+     \brief show frames of a trajectory player instead of the simulation
+     \param pPlayer trajectory player (nullptr: show the simulation again)
+     
+     the player has to be updated by the application or by the simulation (see TrajectoryPlayer)
+     */
+    void setPlayer( std::shared_ptr<TrajectoryPlayer> pPlayer );
+    
     virtual void init();
     virtual void resize(int pWidth, int pHeight);
     virtual void update();
@@ -135,6 +145,8 @@ protected:
     std::string mImageFileName;
 
     std::shared_ptr<FlockVisuals> mSelf;
+    std::shared_ptr<SnapshotBuffer> mSnapshotBuffer; /// \brief agent positions and velocities published by the simulation or the player
+    std::shared_ptr<TrajectoryPlayer> mPlayer; /// \brief trajectory player that publishes into the snapshot buffer instead of the simulation (nullptr: none)
     
     void removeVisSwarms();
     void updateVisSwarms();
@@ -6,6 +6,8 @@
 #include "dab_flock_visual_agent_trail.h"
 #include "dab_flock_swarm.h"
 #include "dab_flock_simulation.h"
+#include "dab_flock_snapshot.h"
+#include <algorithm>
 
 using namespace dab;
 using namespace dab::flock;
@@ -249,62 +251,51 @@ VisSwarm::setAgentCount(unsigned int pAgentCount)
 }
 
 void
-VisSwarm::update()
+VisSwarm::update(const Snapshot& pSnapshot)
 {
-	Swarm* swarm;
 	int agentCount;
-	unsigned int posParIndex;
-	unsigned int velParIndex;
 	unsigned int posParDim;
+	unsigned int velParDim;
     
-    swarm = Simulation::get().swarm( mSwarmName );
-    std::vector<Agent*>& agents = swarm->agents();
-    agentCount = agents.size();
+    const Snapshot::Channel* posChannel = pSnapshot.channel( mSwarmName, mPosParName );
+    if(posChannel == nullptr || posChannel->mValid == false) return;
+    
+    const Snapshot::Channel* velChannel = nullptr;
+    if( mVelParName.empty() == false ) velChannel = pSnapshot.channel( mSwarmName, mVelParName );
+    if( velChannel != nullptr && ( velChannel->mValid == false || velChannel->mAgentCount != posChannel->mAgentCount ) ) velChannel = nullptr;
+    
+    agentCount = posChannel->mAgentCount;
     
     if(agentCount != mAgentTrails.size()) setAgentCount(agentCount);
     if(agentCount == 0) return;
     
-    posParIndex = agents[0]->parameterIndex( mPosParName );
-    posParDim = agents[0]->parameter( posParIndex )->dim();
+    posParDim = posChannel->mDim;
     if(posParDim > 3) posParDim = 3;
     
-    if( mVelParName.empty() == false )
+    const float* agentPositions = posChannel->mValues.data();
+    
+    if( velChannel != nullptr )
     {
-        //std::cout << "posParName " << mPosParName << " posParIndex " << posParIndex << " velParName " << mVelParName << " velParIndex " << swarm->parameterIndex( mVelParName ) << "\n";
-        
-        velParIndex = swarm->parameterIndex( mVelParName );
+        velParDim = std::min( velChannel->mDim, posParDim );
+        const float* agentVelocities = velChannel->mValues.data();
         
-        for(unsigned int aI=0; aI<agentCount; ++aI)
+        for(unsigned int aI=0; aI<agentCount; ++aI, agentPositions += posChannel->mDim, agentVelocities += velChannel->mDim)
         {
-            const Eigen::VectorXf& agentPosition = agents[aI]->parameter( posParIndex )->values();
-            const Eigen::VectorXf& agentVelocity = agents[aI]->parameter( velParIndex )->values();
-            
-            for(unsigned int d=0; d<posParDim; ++d)
-            {
-                mAgentPositions[aI][d] = agentPosition[d];
-                mAgentVelocities[aI][d] = agentVelocity[d];
-            }
+            for(unsigned int d=0; d<posParDim; ++d) mAgentPositions[aI][d] = agentPositions[d];
+            for(unsigned int d=0; d<velParDim; ++d) mAgentVelocities[aI][d] = agentVelocities[d];
             
             mAgentTrails[aI]->update( mAgentPositions[aI] );
         }
     }
     else
     {
-        for(unsigned int aI=0; aI<agentCount; ++aI)
+        for(unsigned int aI=0; aI<agentCount; ++aI, agentPositions += posChannel->mDim)
         {
-            const Eigen::VectorXf& agentPosition = agents[aI]->parameter( posParIndex )->values();
-            
-            for(unsigned int d=0; d<posParDim; ++d)
-            {
-                mAgentPositions[aI][d] = agentPosition[d];
-            }
+            for(unsigned int d=0; d<posParDim; ++d) mAgentPositions[aI][d] = agentPositions[d];
             
             mAgentTrails[aI]->update( mAgentPositions[aI] );
         }
     }
-    
-    //	std::cout << "GLPanel::updateVisSwarms() end\n";
-    
 }
 
 void
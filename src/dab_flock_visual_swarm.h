@@ -18,6 +18,7 @@ namespace flock
 
 class VisAgentShape;
 class VisAgentTrail;
+class Snapshot;
 
 class VisSwarm
 {
@@ -52,7 +53,7 @@ public:
     
     void setAgentCount(unsigned int pAgentCount);
     
-    void update();
+    void update(const Snapshot& pSnapshot);
     void displayAgents(const ofShader &pShader);
     void displayTrails(const ofShader &pShader);
     